@@ -0,0 +1,291 @@
+#include "Arena.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace SnakeGame {
+
+    namespace {
+        constexpr int SPAWN_ATTEMPTS = 64;  // Số lần thử tìm chỗ xuất hiện cho một con rắn
+        constexpr int SPAWN_CLEARANCE = 3;  // Số ô trống cần có phía trước đầu rắn khi xuất hiện
+        constexpr std::size_t PARALLEL_GRAIN = 8;
+
+        constexpr Direction ALL_DIRECTIONS[] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+        Point offsetFor(Direction dir) {
+            switch (dir) {
+                case Direction::UP:    return {0, -1};
+                case Direction::DOWN:  return {0, 1};
+                case Direction::LEFT:  return {-1, 0};
+                case Direction::RIGHT: return {1, 0};
+            }
+            return {0, 0};
+        }
+
+        bool isOpposite(Direction a, Direction b) {
+            const Point da = offsetFor(a);
+            const Point db = offsetFor(b);
+            return da.x == -db.x && da.y == -db.y;
+        }
+
+        void hashValue(std::uint64_t& hash, std::uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                hash ^= (value >> (i * 8)) & 0xFFu;
+                hash *= 1099511628211ull;
+            }
+        }
+    }
+
+    Arena::Arena(const ArenaConfig& initialConfig, std::uint32_t seed, JobSystem* jobSystem)
+            : config(initialConfig),
+              jobs(jobSystem),
+              rng(seed)
+    {
+        config.boardWidth = std::max(2, config.boardWidth);
+        config.boardHeight = std::max(2, config.boardHeight);
+        config.snakeCount = std::max(1, config.snakeCount);
+        config.foodCount = std::max(0, config.foodCount);
+        config.initialLength = std::max(1, config.initialLength);
+
+        grid.resize(config.boardWidth, config.boardHeight);
+        const std::size_t count = static_cast<std::size_t>(config.snakeCount);
+        snakes.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            snakes.emplace_back(0, 0, config.initialLength, config.boardWidth, config.boardHeight);
+        }
+        controllers.assign(count, ArenaController::Bot);
+        alive.assign(count, 0);
+        scores.assign(count, 0);
+        respawnTimers.assign(count, 0);
+        events.assign(count, ArenaEvent{});
+        intents.assign(count, -1);
+        verdicts.assign(count, CollisionCause::None);
+        claims.assign(static_cast<std::size_t>(grid.getCellCount()), 0);
+        vacating.assign(static_cast<std::size_t>(grid.getCellCount()), 0);
+        reset(seed);
+    }
+
+    void Arena::reset(std::uint32_t seed) {
+        rng.seed(seed);
+        tick = 0;
+        for (auto& snake : snakes) snake.release(grid);
+        grid.clear();
+        foods.clear();
+        std::fill(alive.begin(), alive.end(), 0);
+        std::fill(scores.begin(), scores.end(), 0);
+        std::fill(respawnTimers.begin(), respawnTimers.end(), 0);
+        std::fill(events.begin(), events.end(), ArenaEvent{});
+
+        for (int i = 0; i < getSnakeCount(); ++i) {
+            alive[i] = spawnSnake(i) ? 1 : 0;
+        }
+        refillFood();
+    }
+
+    void Arena::setController(int index, ArenaController controller) {
+        controllers[index] = controller;
+    }
+
+    void Arena::queueDirection(int index, Direction direction, std::uint64_t inputStamp) {
+        if (alive[index]) snakes[index].queueDirectionChange(direction, inputStamp);
+    }
+
+    int Arena::getAliveCount() const {
+        return static_cast<int>(std::count(alive.begin(), alive.end(), 1));
+    }
+
+    void Arena::step() {
+        ++tick;
+        const int count = getSnakeCount();
+        std::fill(events.begin(), events.end(), ArenaEvent{});
+
+        auto forEachSnake = [&](auto&& fn) {
+            if (jobs) jobs->parallelFor(static_cast<std::size_t>(count), [&](std::size_t i) { fn(static_cast<int>(i)); }, PARALLEL_GRAIN);
+            else for (int i = 0; i < count; ++i) fn(i);
+        };
+
+        // Pha 1 (song song): chọn hướng và tính ô đích
+        forEachSnake([&](int i) { if (alive[i]) planMove(i); });
+
+        // Pha 2 (tuần tự): đếm số đầu nhắm vào mỗi ô, đánh dấu các ô đuôi sẽ được giải phóng
+        for (int i = 0; i < count; ++i) {
+            if (!alive[i]) continue;
+            if (intents[i] >= 0 && claims[intents[i]] < 255) ++claims[intents[i]];
+            if (!snakes[i].isGrowing()) vacating[snakes[i].getBody().backCell()] = 1;
+        }
+        // Pha 2 (song song): phán quyết dựa trên trạng thái đầu bước
+        forEachSnake([&](int i) { verdicts[i] = alive[i] ? judgeMove(i) : CollisionCause::None; });
+        for (int i = 0; i < count; ++i) {
+            if (!alive[i]) continue;
+            if (intents[i] >= 0) claims[intents[i]] = 0;
+            vacating[snakes[i].getBody().backCell()] = 0;
+        }
+
+        // Pha 3 (tuần tự, theo chỉ số): áp dụng
+        for (int i = 0; i < count; ++i) {
+            if (alive[i] && verdicts[i] != CollisionCause::None) killSnake(i, verdicts[i]);
+        }
+        for (int i = 0; i < count; ++i) {
+            if (alive[i]) snakes[i].retractTail(grid);
+        }
+        const int width = grid.getWidth();
+        for (int i = 0; i < count; ++i) {
+            if (alive[i]) snakes[i].advanceHead({intents[i] % width, intents[i] / width}, grid);
+        }
+        for (int i = 0; i < count; ++i) {
+            if (!alive[i] || !grid.test(intents[i], CellTag::Food)) continue;
+            const Point head = snakes[i].getHeadPosition();
+            grid.reset(intents[i], CellTag::Food);
+            auto it = std::find(foods.begin(), foods.end(), head);
+            if (it != foods.end()) {
+                *it = foods.back();
+                foods.pop_back();
+            }
+            snakes[i].grow();
+            ++scores[i];
+            events[i].ateFood = true;
+        }
+        refillFood();
+
+        for (int i = 0; i < count; ++i) {
+            if (alive[i] || controllers[i] != ArenaController::Bot || config.respawnDelayTicks < 0) continue;
+            if (--respawnTimers[i] > 0) continue;
+            if (spawnSnake(i)) {
+                alive[i] = 1;
+                scores[i] = 0;
+                events[i].respawned = true;
+            }
+        }
+    }
+
+    void Arena::planMove(int index) {
+        Snake& snake = snakes[index];
+        if (controllers[index] == ArenaController::Bot) {
+            snake.queueDirectionChange(chooseBotDirection(index));
+        }
+        const Point head = snake.getHeadPosition();
+        snake.processAndApplyInputBuffer();
+        Point next;
+        intents[index] = neighbour(head, snake.getCurrentDirection(), next) ? grid.indexOf(next) : -1;
+    }
+
+    CollisionCause Arena::judgeMove(int index) const {
+        const int target = intents[index];
+        if (target < 0) return CollisionCause::Wall;
+        if (claims[target] > 1) return CollisionCause::HeadOn;
+        if (grid.test(target, CellTag::Snake) && !vacating[target]) {
+            return ownsCell(index, target) ? CollisionCause::Self : CollisionCause::OtherSnake;
+        }
+        return CollisionCause::None;
+    }
+
+    Direction Arena::chooseBotDirection(int index) const {
+        const Snake& snake = snakes[index];
+        const Point head = snake.getHeadPosition();
+        const Direction current = snake.getCurrentDirection();
+
+        Point target = head;
+        int targetDistance = INT_MAX;
+        for (const Point& food : foods) {
+            const int distance = std::abs(food.x - head.x) + std::abs(food.y - head.y);
+            if (distance < targetDistance) {
+                targetDistance = distance;
+                target = food;
+            }
+        }
+
+        const int ownTail = static_cast<int>(snake.getBody().backCell());
+        Direction best = current;
+        int bestDistance = INT_MAX;
+        for (Direction dir : ALL_DIRECTIONS) {
+            if (isOpposite(dir, current)) continue;
+            Point next;
+            if (!neighbour(head, dir, next)) continue;
+            const int cell = grid.indexOf(next);
+            if (grid.test(cell, CellTag::Snake) && (cell != ownTail || snake.isGrowing())) continue;
+            const int distance = std::abs(next.x - target.x) + std::abs(next.y - target.y);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best = dir;
+            }
+        }
+        return best;
+    }
+
+    bool Arena::neighbour(Point from, Direction dir, Point& out) const {
+        const Point delta = offsetFor(dir);
+        out = {from.x + delta.x, from.y + delta.y};
+        if (config.mode == GameMode::PortalWalls) {
+            if (out.x < 0) out.x = config.boardWidth - 1;
+            else if (out.x >= config.boardWidth) out.x = 0;
+            if (out.y < 0) out.y = config.boardHeight - 1;
+            else if (out.y >= config.boardHeight) out.y = 0;
+            return true;
+        }
+        return grid.contains(out.x, out.y);
+    }
+
+    bool Arena::ownsCell(int index, int cell) const {
+        const SnakeBody& body = snakes[index].getBody();
+        for (std::size_t i = 0; i < body.size(); ++i) {
+            if (static_cast<int>(body.cellAt(i)) == cell) return true;
+        }
+        return false;
+    }
+
+    bool Arena::spawnSnake(int index) {
+        const int length = config.initialLength;
+        const int width = grid.getWidth();
+        for (int attempt = 0; attempt < SPAWN_ATTEMPTS; ++attempt) {
+            const int cell = grid.getFreeCells().sample(rng);
+            if (cell < 0) return false;
+            const int x = cell % width;
+            const int y = cell / width;
+            if (x - length + 1 < 0 || x + SPAWN_CLEARANCE >= width) continue;
+            bool clear = true;
+            for (int cx = x - length + 1; cx <= x + SPAWN_CLEARANCE && clear; ++cx) {
+                clear = !grid.isOccupied(grid.indexOf(cx, y));
+            }
+            if (!clear) continue;
+            snakes[index].reset(x, y, length);
+            snakes[index].occupy(grid);
+            return true;
+        }
+        return false;
+    }
+
+    void Arena::killSnake(int index, CollisionCause cause) {
+        snakes[index].release(grid);
+        alive[index] = 0;
+        respawnTimers[index] = config.respawnDelayTicks;
+        events[index].died = true;
+        events[index].cause = cause;
+    }
+
+    void Arena::refillFood() {
+        const int width = grid.getWidth();
+        while (static_cast<int>(foods.size()) < config.foodCount) {
+            const int cell = grid.getFreeCells().sample(rng);
+            if (cell < 0) return;
+            grid.set(cell, CellTag::Food);
+            foods.push_back({cell % width, cell / width});
+        }
+    }
+
+    std::uint64_t Arena::stateHash() const {
+        std::uint64_t hash = 1469598103934665603ull;
+        hashValue(hash, tick);
+        for (int i = 0; i < getSnakeCount(); ++i) {
+            hashValue(hash, alive[i]);
+            hashValue(hash, static_cast<std::uint64_t>(scores[i]));
+            const SnakeBody& body = snakes[i].getBody();
+            hashValue(hash, body.size());
+            for (std::size_t s = 0; s < body.size(); ++s) hashValue(hash, body.cellAt(s));
+        }
+        for (const Point& food : foods) {
+            hashValue(hash, static_cast<std::uint64_t>(food.y) * static_cast<std::uint64_t>(config.boardWidth) + static_cast<std::uint64_t>(food.x));
+        }
+        return hash;
+    }
+
+}
@@ -0,0 +1,145 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include "Simulation.hpp"
+#include "Snake.hpp"
+#include "OccupancyGrid.hpp"
+#include "JobSystem.hpp"
+#include "CoreConfig.hpp"
+#include "Random.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    ArenaController
+     *    Ai điều khiển một con rắn trong Arena.
+     */
+    enum class ArenaController {
+        Human, // Hướng đi do Arena::queueDirection cung cấp; không hồi sinh khi chết
+        Bot    // Arena tự chọn hướng (tham lam, an toàn một bước); hồi sinh sau respawnDelayTicks
+    };
+
+    /**
+     *    ArenaConfig
+     *    Tham số của một ván Arena.
+     */
+    struct ArenaConfig {
+        int boardWidth = 200;                                // Số ô theo chiều ngang
+        int boardHeight = 200;                               // Số ô theo chiều dọc
+        int snakeCount = 64;                                 // Tổng số rắn
+        int foodCount = 64;                                  // Số mồi luôn có trên bàn chơi
+        int initialLength = Config::DEFAULT_SNAKE_LENGTH;    // Chiều dài khi xuất hiện
+        int respawnDelayTicks = 20;                          // Bot hồi sinh sau số bước này (< 0: không hồi sinh)
+        GameMode mode = GameMode::Classic;                   // Classic: tường giết rắn, PortalWalls: wrap
+    };
+
+    /**
+     *    ArenaEvent
+     *    Sự kiện của một con rắn trong bước vừa chạy.
+     */
+    struct ArenaEvent {
+        bool ateFood = false;
+        bool died = false;
+        bool respawned = false;
+        CollisionCause cause = CollisionCause::None;
+    };
+
+    /**
+     *    Arena
+     *    Nhiều con rắn (người hoặc bot) trên cùng một bàn chơi, chạy theo bước chia pha:
+     *          1. Song song: mỗi rắn chọn hướng (bot) và tính ô đầu tiếp theo - chỉ đọc trạng thái chung, chỉ ghi dữ liệu riêng.
+     *          2. Giải quyết va chạm: đếm số đầu nhắm vào mỗi ô (tuần tự), rồi song song quyết định rắn nào chết
+     *             (tường, đối đầu, đâm thân) dựa trên trạng thái đầu bước. Đuôi của rắn không phát triển được coi là đã rời ô.
+     *          3. Áp dụng tuần tự theo chỉ số: xóa rắn chết, rút đuôi mọi rắn sống, rồi mới đẩy đầu; ăn mồi, sinh mồi và hồi sinh.
+     *        Mọi lựa chọn ngẫu nhiên chỉ diễn ra ở pha 3 theo thứ tự cố định, nên kết quả không phụ thuộc số luồng.
+     */
+    class Arena {
+    public:
+        /**
+         *    Khởi tạo Arena và bắt đầu ván mới.
+         *    config Tham số ván chơi.
+         *    seed Hạt giống ngẫu nhiên (vị trí xuất hiện, mồi).
+         *    jobs Hệ thống công việc cho các pha song song (nullptr = chạy trên luồng gọi).
+         */
+        Arena(const ArenaConfig& config, std::uint32_t seed, JobSystem* jobs = nullptr);
+
+        /**    Bắt đầu ván mới với seed cho trước (giữ cấu hình và người điều khiển). */
+        void reset(std::uint32_t seed);
+
+        /**    Thực hiện một bước cho mọi con rắn. */
+        void step();
+
+        /**    Đặt người điều khiển cho rắn thứ index. */
+        void setController(int index, ArenaController controller);
+
+        /**    Đưa một lệnh đổi hướng vào bộ đệm input của rắn thứ index (dùng cho rắn do người chơi điều khiển, kèm nhãn thời gian đo độ trễ). */
+        void queueDirection(int index, Direction direction, std::uint64_t inputStamp = 0);
+
+        /**    Thay hệ thống công việc dùng cho các pha song song. */
+        void setJobSystem(JobSystem* newJobs) { jobs = newJobs; }
+
+        /**    Bật/tắt nhật ký thay đổi của lưới (minimap). */
+        void setGridChangeTracking(bool enabled) { grid.setChangeTracking(enabled); }
+        /**    Xóa nhật ký thay đổi của lưới. */
+        void clearGridChanges() { grid.clearChanges(); }
+
+        /**    Băm trạng thái (thân rắn, điểm, mồi) để so sánh kết quả giữa các lần chạy / số luồng khác nhau. */
+        [[nodiscard]] std::uint64_t stateHash() const;
+
+        [[nodiscard]] int getSnakeCount() const { return static_cast<int>(snakes.size()); }
+        [[nodiscard]] const Snake& getSnake(int index) const { return snakes[index]; }
+        [[nodiscard]] bool isAlive(int index) const { return alive[index] != 0; }
+        [[nodiscard]] int getScore(int index) const { return scores[index]; }
+        [[nodiscard]] const ArenaEvent& getEvent(int index) const { return events[index]; }
+        [[nodiscard]] int getAliveCount() const;
+        [[nodiscard]] const std::vector<Point>& getFoods() const { return foods; }
+        [[nodiscard]] const OccupancyGrid& getGrid() const { return grid; }
+        [[nodiscard]] std::uint64_t getTick() const { return tick; }
+        [[nodiscard]] int getBoardWidth() const { return config.boardWidth; }
+        [[nodiscard]] int getBoardHeight() const { return config.boardHeight; }
+        [[nodiscard]] GameMode getMode() const { return config.mode; }
+
+    private:
+        ArenaConfig config;
+        JobSystem* jobs;
+        OccupancyGrid grid;                      // Lưới chung: bit Snake cho mọi rắn, bit Food cho mồi
+        std::vector<Snake> snakes;
+        std::vector<ArenaController> controllers;
+        std::vector<std::uint8_t> alive;         // 1 nếu rắn đang trên bàn chơi
+        std::vector<int> scores;
+        std::vector<int> respawnTimers;          // Số bước còn lại trước khi hồi sinh (rắn đã chết)
+        std::vector<ArenaEvent> events;          // Sự kiện của bước vừa chạy
+        std::vector<Point> foods;                // Vị trí các mồi
+
+        // Bộ nhớ tạm của step(), cấp phát một lần
+        std::vector<int> intents;                // Ô đích của mỗi rắn (-1: đâm tường)
+        std::vector<CollisionCause> verdicts;    // Kết quả pha 2 cho mỗi rắn
+        std::vector<std::uint8_t> claims;        // Số đầu rắn nhắm vào mỗi ô (bão hòa ở 255)
+        std::vector<std::uint8_t> vacating;      // 1 nếu ô là đuôi sẽ được giải phóng trong bước này
+
+        std::uint64_t tick = 0;
+        Rng rng;
+
+        /**    Pha 1 cho một con rắn: chọn hướng (bot) và ghi ô đích vào intents. */
+        void planMove(int index);
+        /**    Pha 2 cho một con rắn: quyết định nguyên nhân chết (None nếu sống sót). */
+        [[nodiscard]] CollisionCause judgeMove(int index) const;
+        /**    Hướng đi của bot: trong các hướng an toàn một bước, chọn hướng gần mồi nhất. */
+        [[nodiscard]] Direction chooseBotDirection(int index) const;
+        /**    Ô kế tiếp theo hướng dir (đã wrap ở PortalWalls); false nếu đâm tường ở Classic. */
+        [[nodiscard]] bool neighbour(Point from, Direction dir, Point& out) const;
+        /**    true nếu ô thuộc thân của rắn thứ index. */
+        [[nodiscard]] bool ownsCell(int index, int cell) const;
+        /**    Đặt rắn vào một vị trí ngẫu nhiên còn trống; false nếu không tìm được chỗ. */
+        bool spawnSnake(int index);
+        /**    Loại rắn khỏi bàn chơi. */
+        void killSnake(int index, CollisionCause cause);
+        /**    Bổ sung mồi cho đủ config.foodCount. */
+        void refillFood();
+    };
+
+}
+
+#endif
@@ -0,0 +1,318 @@
+#include "Autopilot.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace SnakeGame {
+
+    namespace {
+        constexpr int DX[4] = {0, 0, -1, 1};  // Theo thứ tự Direction: UP, DOWN, LEFT, RIGHT
+        constexpr int DY[4] = {-1, 1, 0, 0};
+
+        int opposite(int dir) { return dir ^ 1; }
+
+        // Heap nhỏ nhất theo f; khi bằng nhau ưu tiên g lớn (đi sâu về phía đích trước)
+        struct OpenOrder {
+            template <typename Node>
+            bool operator()(const Node& a, const Node& b) const {
+                return a.f != b.f ? a.f > b.f : a.g < b.g;
+            }
+        };
+    }
+
+    void Autopilot::reset() {
+        synced = false;
+        path.clear();
+        goal = -1;
+        lastFood = -1;
+        retryTick = 0;
+    }
+
+    Direction Autopilot::drive(Simulation& sim) {
+        const Direction dir = chooseDirection(sim);
+        sim.queueDirection(dir);
+        return dir;
+    }
+
+    void Autopilot::nextStamp() {
+        if (++stamp == 0) {
+            std::fill(visitStamp.begin(), visitStamp.end(), 0);
+            stamp = 1;
+        }
+    }
+
+    void Autopilot::sync(const Simulation& sim) {
+        grid = &sim.getGrid();
+        wrap = sim.getMode() == GameMode::PortalWalls;
+        if (sim.getBoardWidth() != width || sim.getBoardHeight() != height) {
+            width = sim.getBoardWidth();
+            height = sim.getBoardHeight();
+            const std::size_t cellCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+            enterTick.assign(cellCount, 0);
+            visitStamp.assign(cellCount, 0);
+            cost.assign(cellCount, 0);
+            parentDir.assign(cellCount, 0);
+            stamp = 0;
+            reset();
+        }
+
+        const Snake& snake = sim.getSnake();
+        const SnakeBody& body = snake.getBody();
+        const auto tick = static_cast<std::uint32_t>(sim.getTick());
+        length = static_cast<std::uint32_t>(body.size());
+        growDelay = snake.isGrowing() ? 1 : 0;
+        now = tick;
+        if (body.empty()) {
+            synced = false;
+            return;
+        }
+
+        const int newHead = static_cast<int>(body.frontCell());
+        if (synced && tick == lastTick) return; // Gọi lại trong cùng tick
+
+        bool stepped = false;
+        if (synced && tick == lastTick + 1) {
+            for (int dir = 0; dir < 4 && !stepped; ++dir) stepped = neighbour(head, dir) == newHead;
+        }
+        if (stepped) {
+            enterTick[newHead] = tick;
+            if (!path.empty()) {
+                if (path.back() == newHead) path.pop_back(); // Đã đi đúng đường
+                else path.clear();
+            }
+        } else {
+            // Bỏ lỡ bước (ván mới, tua replay, tải nhanh...): ghi lại tick đi vào của mọi đốt
+            for (std::size_t i = 0; i < body.size(); ++i) enterTick[body.cellAt(i)] = tick - static_cast<std::uint32_t>(i);
+            path.clear();
+        }
+        head = newHead;
+        lastTick = tick;
+        synced = true;
+    }
+
+    int Autopilot::neighbour(int cell, int dir) const {
+        int x = cell % width + DX[dir];
+        int y = cell / width + DY[dir];
+        if (wrap) {
+            x = x < 0 ? width - 1 : (x >= width ? 0 : x);
+            y = y < 0 ? height - 1 : (y >= height ? 0 : y);
+        } else if (x < 0 || y < 0 || x >= width || y >= height) {
+            return -1;
+        }
+        return y * width + x;
+    }
+
+    std::uint32_t Autopilot::heuristic(int from, int to) const {
+        int dx = std::abs(from % width - to % width);
+        int dy = std::abs(from / width - to / width);
+        if (wrap) {
+            dx = std::min(dx, width - dx);
+            dy = std::min(dy, height - dy);
+        }
+        return static_cast<std::uint32_t>(dx + dy);
+    }
+
+    bool Autopilot::blockedAt(int cell, std::uint32_t step) const {
+        if (grid->test(cell, CellTag::Obstacle)) return true;
+        if (!grid->test(cell, CellTag::Snake)) return false;
+        // Đốt thứ index (0 = đầu) rời khỏi ô ở bước length - index; đuôi rút trước khi đầu tiến nên có thể đi vào đúng bước đó
+        const std::uint32_t index = now - enterTick[cell];
+        if (index >= length) return true;
+        return step < length - index + growDelay;
+    }
+
+    bool Autopilot::blockedAfterMeal(int cell, std::uint32_t step) const {
+        if (grid->test(cell, CellTag::Obstacle)) return true;
+        if (auto it = pathVacate.find(cell); it != pathVacate.end()) return step < it->second;
+        if (!grid->test(cell, CellTag::Snake)) return false;
+        const std::uint32_t index = now - enterTick[cell];
+        if (index >= length) return true;
+        return step < length - index + growDelay + 1; // Ăn mồi làm đuôi đứng yên thêm một bước
+    }
+
+    bool Autopilot::search(int start, std::uint32_t startStep, int target, std::size_t budget, std::vector<int>& out) {
+        out.clear();
+        nextStamp();
+        open.clear();
+        visitStamp[start] = stamp;
+        cost[start] = startStep;
+        open.push_back({startStep + heuristic(start, target), startStep, start});
+
+        std::size_t expanded = 0;
+        while (!open.empty() && expanded < budget) {
+            std::pop_heap(open.begin(), open.end(), OpenOrder{});
+            const OpenNode node = open.back();
+            open.pop_back();
+            if (node.g != cost[node.cell]) continue; // Bản cũ trong heap
+            if (node.cell == target) {
+                for (int cell = target; cell != start; cell = neighbour(cell, opposite(parentDir[cell]))) out.push_back(cell);
+                stats.nodesExpanded += expanded;
+                return true;
+            }
+            ++expanded;
+            const std::uint32_t g = node.g + 1;
+            for (int dir = 0; dir < 4; ++dir) {
+                const int next = neighbour(node.cell, dir);
+                if (next < 0 || blockedAt(next, g)) continue;
+                if (!pathVacate.empty()) {
+                    if (auto it = pathVacate.find(next); it != pathVacate.end() && g < it->second) continue;
+                }
+                if (visitStamp[next] == stamp && cost[next] <= g) continue;
+                visitStamp[next] = stamp;
+                cost[next] = g;
+                parentDir[next] = static_cast<std::uint8_t>(dir);
+                open.push_back({g + heuristic(next, target), g, next});
+                std::push_heap(open.begin(), open.end(), OpenOrder{});
+            }
+        }
+        stats.nodesExpanded += expanded;
+        return false;
+    }
+
+    bool Autopilot::validatePath() {
+        // path[n - k] là ô đầu rắn đi vào ở bước k
+        const std::size_t n = path.size();
+        std::size_t bad = 0;
+        for (std::size_t k = 1; k <= n; ++k) {
+            if (blockedAt(path[n - k], static_cast<std::uint32_t>(k))) {
+                bad = k;
+                break;
+            }
+        }
+        if (bad == 0) {
+            ++stats.reusedTicks;
+            return true;
+        }
+
+        // Điểm nối lại: ô đầu tiên sau đoạn bị chặn còn đi được (ô mồi luôn đi được)
+        std::size_t rejoin = bad + 1;
+        while (rejoin <= n && blockedAt(path[n - rejoin], static_cast<std::uint32_t>(rejoin))) ++rejoin;
+        if (rejoin > n) return false;
+        const int from = bad == 1 ? head : path[n - (bad - 1)];
+        const auto fromStep = static_cast<std::uint32_t>(bad - 1);
+        const auto budget = static_cast<std::size_t>(Config::AUTOPILOT_REPAIR_NODE_BUDGET);
+        // Đoạn vòng không được cắt qua phần đường đã giữ lại (khi đó là thân rắn)
+        pathVacate.clear();
+        for (std::size_t j = 1; j < bad; ++j) pathVacate[path[n - j]] = static_cast<std::uint32_t>(j) + length;
+        const bool found = search(from, fromStep, path[n - rejoin], budget, scratch);
+        pathVacate.clear();
+        if (!found) return false;
+
+        // Ghép: [mồi .. sau điểm nối] + đoạn vòng [điểm nối .. bước bad] + [bước bad-1 .. bước 1]
+        std::vector<int> repaired(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(n - rejoin));
+        repaired.insert(repaired.end(), scratch.begin(), scratch.end());
+        repaired.insert(repaired.end(), path.begin() + static_cast<std::ptrdiff_t>(n - bad + 1), path.end());
+        path.swap(repaired);
+        if (!hasEscapeRoute()) return false;
+        ++stats.repairs;
+        return true;
+    }
+
+    bool Autopilot::hasEscapeRoute() {
+        // Sau n bước rắn dài length + 1; ô của bước j còn bị thân chiếm tới bước j + length + 1
+        const auto n = static_cast<std::uint32_t>(path.size());
+        pathVacate.clear();
+        for (std::uint32_t j = 1; j <= n; ++j) pathVacate[path[n - j]] = j + length + 1;
+
+        const std::uint32_t limit = length + 1;
+        nextStamp();
+        frontier.clear();
+        const int start = path.front();
+        visitStamp[start] = stamp;
+        cost[start] = n;
+        frontier.push_back(start);
+        std::uint32_t reached = 0;
+        for (std::size_t i = 0; i < frontier.size(); ++i) {
+            const int cell = frontier[i];
+            const std::uint32_t step = cost[cell] + 1;
+            for (int dir = 0; dir < 4; ++dir) {
+                const int next = neighbour(cell, dir);
+                if (next < 0 || visitStamp[next] == stamp || blockedAfterMeal(next, step)) continue;
+                visitStamp[next] = stamp;
+                cost[next] = step;
+                frontier.push_back(next);
+                if (++reached >= limit) return true;
+            }
+        }
+        return false;
+    }
+
+    std::uint32_t Autopilot::floodCount(int start, std::uint32_t startStep, std::uint32_t limit) {
+        nextStamp();
+        frontier.clear();
+        visitStamp[start] = stamp;
+        cost[start] = startStep;
+        frontier.push_back(start);
+        std::uint32_t reached = 1;
+        for (std::size_t i = 0; i < frontier.size() && reached < limit; ++i) {
+            const int cell = frontier[i];
+            const std::uint32_t step = cost[cell] + 1;
+            for (int dir = 0; dir < 4; ++dir) {
+                const int next = neighbour(cell, dir);
+                if (next < 0 || visitStamp[next] == stamp || blockedAt(next, step)) continue;
+                visitStamp[next] = stamp;
+                cost[next] = step;
+                frontier.push_back(next);
+                ++reached;
+            }
+        }
+        return reached;
+    }
+
+    int Autopilot::chooseFallback(int food) {
+        int best = -1;
+        std::uint32_t bestSpace = 0;
+        std::uint32_t bestDistance = 0;
+        for (int dir = 0; dir < 4; ++dir) {
+            const int next = neighbour(head, dir);
+            if (next < 0 || blockedAt(next, 1)) continue;
+            const std::uint32_t space = floodCount(next, 1, length + 1);
+            const std::uint32_t distance = food >= 0 ? heuristic(next, food) : 0;
+            if (best < 0 || space > bestSpace || (space == bestSpace && distance < bestDistance)) {
+                best = next;
+                bestSpace = space;
+                bestDistance = distance;
+            }
+        }
+        return best;
+    }
+
+    Direction Autopilot::chooseDirection(const Simulation& sim) {
+        ++stats.decisions;
+        sync(sim);
+        const Direction current = sim.getSnake().getCurrentDirection();
+        if (!synced || sim.isGameOver()) return current;
+
+        const Point foodPos = sim.getFoodPosition();
+        const int food = grid->contains(foodPos.x, foodPos.y) ? grid->indexOf(foodPos) : -1;
+        if (food != lastFood) {
+            lastFood = food;
+            retryTick = now;
+        }
+        if (food != goal) path.clear();
+        if (!path.empty() && !validatePath()) path.clear();
+
+        if (path.empty() && food >= 0 && static_cast<std::int32_t>(now - retryTick) >= 0) {
+            ++stats.fullSearches;
+            pathVacate.clear();
+            if (search(head, 0, food, visitStamp.size(), path) && hasEscapeRoute()) {
+                goal = food;
+            } else {
+                path.clear();
+                goal = -1;
+                retryTick = now + static_cast<std::uint32_t>(Config::AUTOPILOT_RETRY_TICKS);
+            }
+        }
+
+        int next = path.empty() ? -1 : path.back();
+        if (next < 0) {
+            ++stats.fallbacks;
+            next = chooseFallback(food);
+            if (next < 0) return current;
+        }
+        for (int dir = 0; dir < 4; ++dir) {
+            if (neighbour(head, dir) == next) return static_cast<Direction>(dir);
+        }
+        return current;
+    }
+
+}
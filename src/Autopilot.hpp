@@ -0,0 +1,126 @@
+#ifndef AUTOPILOT_HPP
+#define AUTOPILOT_HPP
+
+#include "Simulation.hpp"
+#include "OccupancyGrid.hpp"
+#include "CoreConfig.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    AutopilotStats
+     *    Bộ đếm cộng dồn của Autopilot, dùng để đánh giá chi phí tìm đường trong soak test.
+     */
+    struct AutopilotStats {
+        std::uint64_t decisions = 0;     // Số lần chọn hướng
+        std::uint64_t fullSearches = 0;  // Số lần tìm đường A* từ đầu rắn tới mồi
+        std::uint64_t repairs = 0;       // Số lần sửa cục bộ một đoạn đường bị chặn
+        std::uint64_t reusedTicks = 0;   // Số bước dùng lại đường cũ mà không tìm kiếm
+        std::uint64_t fallbacks = 0;     // Số bước không có đường an toàn tới mồi (chọn hướng nhiều chỗ trống nhất)
+        std::uint64_t nodesExpanded = 0; // Tổng số ô đã mở rộng bởi A*
+    };
+
+    /**
+     *    Autopilot
+     *    Bot lái rắn của một Simulation bằng A* trên lưới chiếm chỗ, dùng cho soak test và chế độ tự chơi.
+     *        Đường đi được giữ giữa các bước và chỉ kiểm tra lại: khi đầu rắn đi đúng đường thì bỏ ô đầu tiên,
+     *        khi một vật cản động chắn đường thì chỉ tìm lại đoạn bị chặn (A* cục bộ có giới hạn số ô) rồi nối vào phần còn lại.
+     *        Chỉ tìm lại từ đầu khi mồi đổi chỗ, rắn lệch khỏi đường hoặc việc sửa thất bại.
+     *        Ô thân rắn được coi là trống từ bước đuôi rút khỏi nó: tick đầu rắn đi vào mỗi ô được ghi lại
+     *        (cập nhật O(1) mỗi bước), nên đuôi di chuyển không làm đường đi cũ mất hiệu lực.
+     *        Trước khi nhận một đường, kiểm tra sau khi ăn mồi đầu rắn vẫn còn đủ chỗ để chờ đuôi rút đi
+     *        (tìm kiếm theo chiều rộng có giới hạn); nếu không có đường an toàn, chọn hướng dẫn tới vùng trống lớn nhất.
+     */
+    class Autopilot {
+    public:
+        Autopilot() = default;
+
+        /**
+         *    Chọn hướng cho bước tiếp theo của sim. Gọi một lần trước mỗi step();
+         *        gọi lại trong cùng tick không làm thay đổi đường đi.
+         */
+        [[nodiscard]] Direction chooseDirection(const Simulation& sim);
+
+        /**    Chọn hướng và đưa vào bộ đệm input của rắn (Simulation::queueDirection -> Snake::queueDirectionChange). */
+        Direction drive(Simulation& sim);
+
+        /**    Quên đường đi hiện tại; lần gọi sau đồng bộ lại toàn bộ thân rắn. */
+        void reset();
+
+        [[nodiscard]] const AutopilotStats& getStats() const { return stats; }
+
+        /**    Các ô (chỉ số đã gói) của đường đi hiện tại, từ mồi về ô kế tiếp của đầu rắn (để vẽ debug). */
+        [[nodiscard]] const std::vector<int>& getPath() const { return path; }
+
+    private:
+        struct OpenNode {
+            std::uint32_t f;
+            std::uint32_t g;
+            int cell;
+        };
+
+        // Bàn chơi và trạng thái rắn của lần đồng bộ gần nhất
+        const OccupancyGrid* grid = nullptr;
+        int width = 0;
+        int height = 0;
+        bool wrap = false;              // PortalWalls: đi qua mép bàn chơi
+        std::uint32_t now = 0;          // Tick hiện tại (32 bit, phép trừ tràn số vẫn đúng)
+        std::uint32_t length = 0;       // Chiều dài thân
+        std::uint32_t growDelay = 0;    // 1 nếu rắn đang lớn (đuôi đứng yên một bước)
+        bool synced = false;
+        std::uint32_t lastTick = 0;
+        int head = -1;
+
+        // Dữ liệu theo ô (kích thước bàn chơi), dùng lại giữa các lần tìm kiếm
+        std::vector<std::uint32_t> enterTick;  // Tick mà đầu rắn đi vào ô
+        std::vector<std::uint32_t> visitStamp; // Đánh dấu ô đã thăm theo lượt tìm kiếm (không cần xóa mảng)
+        std::vector<std::uint32_t> cost;       // g của A* / độ sâu của tìm kiếm theo chiều rộng
+        std::vector<std::uint8_t> parentDir;   // Hướng đã đi vào ô (để dựng lại đường)
+        std::uint32_t stamp = 0;
+        std::vector<OpenNode> open;            // Heap của A*
+        std::vector<int> frontier;             // Hàng đợi của tìm kiếm theo chiều rộng
+        std::unordered_map<int, std::uint32_t> pathVacate; // Ô trên đường đi -> bước thân rắn rời khỏi ô (A* cục bộ / kiểm tra sau khi ăn)
+
+        // Đường đi hiện tại (đảo ngược: path.back() là ô kế tiếp của đầu rắn)
+        std::vector<int> path;
+        std::vector<int> scratch;
+        int goal = -1;                  // Ô mồi của đường đi
+        int lastFood = -1;
+        std::uint32_t retryTick = 0;    // Sau một lần tìm thất bại, chờ tới tick này mới tìm lại (trừ khi mồi đổi chỗ)
+
+        AutopilotStats stats;
+
+        /**    Cập nhật trạng thái rắn/bàn chơi từ sim; đồng bộ lại toàn bộ thân nếu bỏ lỡ bước nào. */
+        void sync(const Simulation& sim);
+        /**    Ô kề theo hướng dir (0..3 theo thứ tự Direction), -1 nếu ra ngoài bàn chơi (Classic). */
+        [[nodiscard]] int neighbour(int cell, int dir) const;
+        /**    Khoảng cách Manhattan (tính cả wrap) giữa hai ô. */
+        [[nodiscard]] std::uint32_t heuristic(int from, int to) const;
+        /**    true nếu đầu rắn không thể ở ô cell sau step bước nữa (vật cản, hoặc thân rắn chưa rút khỏi ô). */
+        [[nodiscard]] bool blockedAt(int cell, std::uint32_t step) const;
+        /**    Như blockedAt, nhưng cho thời điểm sau khi rắn đã đi hết đường hiện tại và ăn mồi. */
+        [[nodiscard]] bool blockedAfterMeal(int cell, std::uint32_t step) const;
+        /**
+         *    A* từ start (đầu rắn đã đi startStep bước) tới target, mở rộng tối đa budget ô.
+         *    out Các ô của đường tìm được, từ target về ô đầu tiên sau start.
+         */
+        bool search(int start, std::uint32_t startStep, int target, std::size_t budget, std::vector<int>& out);
+        /**    Kiểm tra lại đường cũ theo trạng thái hiện tại; sửa cục bộ đoạn bị chặn. false nếu cần tìm lại từ đầu. */
+        bool validatePath();
+        /**    true nếu sau khi đi hết đường và ăn mồi, đầu rắn còn đủ chỗ trống để chờ đuôi rút đi. */
+        bool hasEscapeRoute();
+        /**    Số ô tới được từ start (đã đi startStep bước), dừng khi đạt limit. */
+        std::uint32_t floodCount(int start, std::uint32_t startStep, std::uint32_t limit);
+        /**    Không có đường an toàn: chọn ô kề có vùng trống lớn nhất (ưu tiên gần mồi). -1 nếu mọi ô đều bị chặn. */
+        int chooseFallback(int food);
+        /**    Bắt đầu một lượt đánh dấu mới cho visitStamp. */
+        void nextStamp();
+    };
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "BatchEnv.hpp"
+#include <algorithm>
+
+namespace SnakeGame {
+
+    namespace {
+        constexpr std::size_t PARALLEL_GRAIN = 4;
+
+        // Trộn 64-bit (splitmix64) để các chuỗi seed của từng môi trường không trùng nhau
+        std::uint64_t mix(std::uint64_t value) {
+            value += 0x9E3779B97F4A7C15ull;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+            return value ^ (value >> 31);
+        }
+    }
+
+    BatchEnv::BatchEnv(int count, const BatchEnvConfig& initialConfig, std::uint32_t seed, JobSystem* jobSystem)
+            : config(initialConfig),
+              jobs(jobSystem),
+              baseSeed(seed)
+    {
+        const std::size_t size = static_cast<std::size_t>(std::max(1, count));
+        envs.reserve(size);
+        // Constructor đã bắt đầu tập đầu tiên (episode 0) với đúng seed và số vật cản: mỗi bàn chơi chỉ được sinh một lần
+        for (std::size_t i = 0; i < size; ++i) {
+            envs.emplace_back(config.boardWidth, config.boardHeight, episodeSeed(static_cast<int>(i), 0), config.mode, config.obstacleCount);
+        }
+        episodes.assign(size, 1);
+        result.rewards.assign(size, 0.0f);
+        result.done.assign(size, 0);
+        result.truncated.assign(size, 0);
+        result.events.assign(size, StepResult{});
+        result.episodeScores.assign(size, 0);
+        result.episodeTicks.assign(size, 0);
+    }
+
+    void BatchEnv::reset(std::uint32_t seed) {
+        baseSeed = seed;
+        std::fill(episodes.begin(), episodes.end(), 0);
+        for (int i = 0; i < getCount(); ++i) resetEnv(i);
+    }
+
+    std::uint32_t BatchEnv::episodeSeed(int index, std::uint64_t episode) const {
+        const std::uint64_t key = (static_cast<std::uint64_t>(baseSeed) << 32) ^ (static_cast<std::uint64_t>(index) << 20) ^ episode;
+        return static_cast<std::uint32_t>(mix(key));
+    }
+
+    void BatchEnv::resetEnv(int index) {
+        envs[index].reset(episodeSeed(index, episodes[index]), config.mode);
+        ++episodes[index];
+    }
+
+    const BatchStepResult& BatchEnv::step(const Action* actions) {
+        const std::size_t count = envs.size();
+        if (jobs) jobs->parallelFor(count, [&](std::size_t i) { stepEnv(static_cast<int>(i), actions[i]); }, PARALLEL_GRAIN);
+        else for (std::size_t i = 0; i < count; ++i) stepEnv(static_cast<int>(i), actions[i]);
+        return result;
+    }
+
+    void BatchEnv::stepEnv(int index, const Action& action) {
+        Simulation& sim = envs[index];
+        StepInput input;
+        switch (action.turn) {
+            case ActionTurn::Keep:  break;
+            case ActionTurn::Up:    input.direction = Direction::UP; break;
+            case ActionTurn::Down:  input.direction = Direction::DOWN; break;
+            case ActionTurn::Left:  input.direction = Direction::LEFT; break;
+            case ActionTurn::Right: input.direction = Direction::RIGHT; break;
+        }
+        input.boost = action.boost;
+
+        const int scoreBefore = sim.getScore();
+        const StepResult events = sim.step(input);
+        const bool truncated = !events.gameOver && config.maxEpisodeTicks > 0 && sim.getTick() >= config.maxEpisodeTicks;
+
+        float reward = static_cast<float>(sim.getScore() - scoreBefore);
+        if (events.gameOver) reward += config.deathPenalty;
+        result.rewards[index] = reward;
+        result.events[index] = events;
+        result.truncated[index] = truncated ? 1 : 0;
+        result.done[index] = (events.gameOver || truncated) ? 1 : 0;
+        if (result.done[index]) {
+            result.episodeScores[index] = sim.getScore();
+            result.episodeTicks[index] = sim.getTick();
+            resetEnv(index);
+        }
+    }
+
+}
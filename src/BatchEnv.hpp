@@ -0,0 +1,108 @@
+#ifndef BATCH_ENV_HPP
+#define BATCH_ENV_HPP
+
+#include "Simulation.hpp"
+#include "JobSystem.hpp"
+#include "CoreConfig.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    ActionTurn
+     *    Lệnh đổi hướng trong một Action (Keep = giữ hướng hiện tại).
+     */
+    enum class ActionTurn : std::uint8_t { Keep, Up, Down, Left, Right };
+
+    /**
+     *    Action
+     *    Hành động của một môi trường trong một bước. Kiểu POD để caller có thể ghi thẳng vào một mảng liên tục.
+     */
+    struct Action {
+        ActionTurn turn = ActionTurn::Keep;
+        bool boost = false;
+    };
+
+    /**
+     *    BatchEnvConfig
+     *    Tham số chung cho mọi ván trong BatchEnv.
+     */
+    struct BatchEnvConfig {
+        int boardWidth = Config::BOARD_WIDTH;
+        int boardHeight = Config::BOARD_HEIGHT;
+        int obstacleCount = Config::OBSTACLE_COUNT;
+        GameMode mode = GameMode::Classic;
+        std::uint64_t maxEpisodeTicks = 0;  // > 0: cắt ván (done) khi đạt số bước này
+        float deathPenalty = -1.0f;         // Phần thưởng cộng thêm ở bước rắn chết
+    };
+
+    /**
+     *    BatchStepResult
+     *    Kết quả của một lần BatchEnv::step(), mỗi mảng có một phần tử cho mỗi môi trường.
+     *        Khi done[i] = 1, môi trường i đã được reset sang ván mới; episodeScores/episodeTicks giữ kết quả của ván vừa kết thúc.
+     */
+    struct BatchStepResult {
+        std::vector<float> rewards;                // Thay đổi điểm trong bước (+ deathPenalty nếu chết)
+        std::vector<std::uint8_t> done;            // 1 nếu ván kết thúc (chết hoặc bị cắt) trong bước này
+        std::vector<std::uint8_t> truncated;       // 1 nếu ván bị cắt bởi maxEpisodeTicks (không phải chết)
+        std::vector<StepResult> events;            // Sự kiện chi tiết của Simulation::step
+        std::vector<int> episodeScores;            // Điểm cuối của ván vừa kết thúc (chỉ có nghĩa khi done)
+        std::vector<std::uint64_t> episodeTicks;   // Số bước của ván vừa kết thúc (chỉ có nghĩa khi done)
+    };
+
+    /**
+     *    BatchEnv
+     *    N ván Simulation độc lập lưu liên tục trong một vector, bước đồng thời bằng một lời gọi step().
+     *        Dùng cho huấn luyện bot và quét cân bằng luật chơi mà không cần Renderer/SDL.
+     *        Mỗi ván có chuỗi seed riêng (suy ra từ seed gốc, chỉ số và số ván đã chơi) nên kết quả không phụ thuộc số luồng.
+     */
+    class BatchEnv {
+    public:
+        /**
+         *    Khởi tạo count ván và reset tất cả.
+         *    count Số môi trường.
+         *    config Tham số chung.
+         *    seed Seed gốc.
+         *    jobs Hệ thống công việc để bước song song (nullptr = chạy trên luồng gọi).
+         */
+        BatchEnv(int count, const BatchEnvConfig& config, std::uint32_t seed, JobSystem* jobs = nullptr);
+
+        /**    Reset mọi môi trường với seed gốc mới (đếm lại số ván từ 0). */
+        void reset(std::uint32_t seed);
+
+        /**
+         *    Bước mọi môi trường một lần, ván nào kết thúc được tự động reset.
+         *    actions Mảng getCount() hành động, actions[i] cho môi trường i.
+         *    BatchStepResult Kết quả của bước (tham chiếu tới bộ nhớ bên trong, bị ghi đè ở lần step() sau).
+         */
+        const BatchStepResult& step(const Action* actions);
+
+        /**    Thay hệ thống công việc dùng cho step(). */
+        void setJobSystem(JobSystem* newJobs) { jobs = newJobs; }
+
+        [[nodiscard]] int getCount() const { return static_cast<int>(envs.size()); }
+        [[nodiscard]] const Simulation& getSimulation(int index) const { return envs[index]; }
+        [[nodiscard]] std::uint64_t getEpisodeCount(int index) const { return episodes[index]; }
+        [[nodiscard]] const BatchStepResult& getLastResult() const { return result; }
+        [[nodiscard]] const BatchEnvConfig& getConfig() const { return config; }
+
+    private:
+        BatchEnvConfig config;
+        JobSystem* jobs;
+        std::uint32_t baseSeed;
+        std::vector<Simulation> envs;
+        std::vector<std::uint64_t> episodes;  // Số ván đã bắt đầu của mỗi môi trường
+        BatchStepResult result;
+
+        /**    Seed của ván thứ episode trong môi trường index. */
+        [[nodiscard]] std::uint32_t episodeSeed(int index, std::uint64_t episode) const;
+        /**    Bắt đầu ván tiếp theo của môi trường index. */
+        void resetEnv(int index);
+        /**    Bước môi trường index và ghi kết quả vào phần tử index của result. */
+        void stepEnv(int index, const Action& action);
+    };
+
+}
+
+#endif
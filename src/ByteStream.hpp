@@ -0,0 +1,191 @@
+#ifndef BYTE_STREAM_HPP
+#define BYTE_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    ByteWriter
+     *    Ghi dữ liệu nhị phân gọn (varint LEB128 và giá trị thô) vào cuối một vector byte.
+     *        Dùng chung cho định dạng replay và ảnh chụp trạng thái mô phỏng (mảng được sao chép nguyên khối).
+     */
+    class ByteWriter {
+    public:
+        explicit ByteWriter(std::vector<std::uint8_t>& out) : out(out) {}
+
+        void varint(std::uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        /**    Số nguyên có dấu (zigzag, để số âm nhỏ cũng chỉ tốn 1 byte). */
+        void signedVarint(std::int64_t value) {
+            varint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+        }
+
+        void bytes(const void* data, std::size_t size) {
+            const std::size_t offset = out.size();
+            out.resize(offset + size);
+            if (size > 0) std::memcpy(out.data() + offset, data, size);
+        }
+
+        template <typename T>
+        void raw(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            bytes(&value, sizeof(T));
+        }
+
+        /**    Mảng giá trị thô: độ dài (varint) rồi toàn bộ phần tử bằng một lần sao chép. */
+        template <typename T>
+        void array(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            varint(values.size());
+            bytes(values.data(), values.size() * sizeof(T));
+        }
+
+        [[nodiscard]] std::size_t size() const { return out.size(); }
+
+    private:
+        std::vector<std::uint8_t>& out;
+    };
+
+    /**
+     *    RawArrayView
+     *    Khung nhìn chỉ đọc tới một dãy giá trị thô nằm ngay trong dữ liệu của ByteReader (không sao chép, không cần căn lề):
+     *        mỗi phần tử được đọc bằng memcpy. Dùng để kiểm tra ảnh chụp trước khi nạp vào đối tượng.
+     */
+    template <typename T>
+    class RawArrayView {
+    public:
+        RawArrayView() = default;
+        RawArrayView(const std::uint8_t* data, std::size_t count) : data(data), count(count) {}
+
+        T operator[](std::size_t i) const {
+            T value;
+            std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+            return value;
+        }
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+    private:
+        const std::uint8_t* data = nullptr;
+        std::size_t count = 0;
+    };
+
+    /**
+     *    ByteReader
+     *    Đọc dữ liệu do ByteWriter ghi. Mọi lần đọc đều kiểm tra giới hạn; khi dữ liệu hỏng, ok() trả về false
+     *        và các lần đọc sau trả về 0.
+     */
+    class ByteReader {
+    public:
+        ByteReader(const std::uint8_t* data, std::size_t size) : cursor(data), end(data + size) {}
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64 && cursor < end; shift += 7) {
+                const std::uint8_t byte = *cursor++;
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            valid = false;
+            return 0;
+        }
+
+        std::int64_t signedVarint() {
+            const std::uint64_t value = varint();
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        bool bytes(void* data, std::size_t size) {
+            if (!valid || static_cast<std::size_t>(end - cursor) < size) {
+                valid = false;
+                return false;
+            }
+            std::memcpy(data, cursor, size);
+            cursor += size;
+            return true;
+        }
+
+        template <typename T>
+        T raw() {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value{};
+            bytes(&value, sizeof(T));
+            return value;
+        }
+
+        /**
+         *    Đọc mảng do ByteWriter::array ghi bằng một lần sao chép (tái sử dụng bộ nhớ của values nếu đủ).
+         *        maxCount giới hạn độ dài để dữ liệu hỏng không gây cấp phát lớn.
+         */
+        template <typename T>
+        void array(std::vector<T>& values, std::size_t maxCount) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const std::uint64_t count = varint();
+            if (!valid || count > maxCount || count > remaining() / sizeof(T)) {
+                valid = false;
+                values.clear();
+                return;
+            }
+            values.resize(static_cast<std::size_t>(count));
+            bytes(values.data(), values.size() * sizeof(T));
+        }
+
+        /**    Khung nhìn tới count giá trị thô liền nhau rồi bỏ qua chúng (rỗng và đánh dấu hỏng nếu thiếu dữ liệu). */
+        template <typename T>
+        RawArrayView<T> view(std::size_t count) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (!valid || count > remaining() / sizeof(T)) {
+                valid = false;
+                return {};
+            }
+            const RawArrayView<T> result(cursor, count);
+            cursor += count * sizeof(T);
+            return result;
+        }
+
+        /**    Khung nhìn tới mảng do ByteWriter::array ghi (độ dài tối đa maxCount), không sao chép. */
+        template <typename T>
+        RawArrayView<T> arrayView(std::size_t maxCount) {
+            const std::uint64_t count = varint();
+            if (count > maxCount) {
+                valid = false;
+                return {};
+            }
+            return view<T>(static_cast<std::size_t>(count));
+        }
+
+        /**    Con trỏ tới phần dữ liệu chưa đọc (để đọc một khối nhúng). */
+        [[nodiscard]] const std::uint8_t* position() const { return cursor; }
+        [[nodiscard]] std::size_t remaining() const { return static_cast<std::size_t>(end - cursor); }
+        /**    Bỏ qua size byte. */
+        bool skip(std::size_t size) {
+            if (!valid || remaining() < size) {
+                valid = false;
+                return false;
+            }
+            cursor += size;
+            return true;
+        }
+
+        [[nodiscard]] bool ok() const { return valid; }
+
+    private:
+        const std::uint8_t* cursor;
+        const std::uint8_t* end;
+        bool valid = true;
+    };
+
+}
+
+#endif
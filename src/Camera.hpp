@@ -0,0 +1,72 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include "CoreConfig.hpp"
+#include <algorithm>
+
+namespace SnakeGame {
+
+    /**
+     *    Camera
+     *    Khung nhìn (tính theo ô) lên bàn chơi, dùng khi bàn chơi lớn hơn cửa sổ.
+     *        Đi theo đầu rắn và bị kẹp trong biên bàn chơi; khi bàn chơi vừa cửa sổ thì gốc luôn là (0, 0).
+     *        Gốc gồm ô nguyên (originX/originY) và độ lệch pixel trong ô đó (offsetX/offsetY), để khung cảnh cuộn mượt
+     *        theo vị trí nội suy của đầu rắn thay vì nhảy từng ô mỗi bước.
+     *        Không phụ thuộc SDL: Game/Renderer dùng để lọc các đối tượng nằm trong khung nhìn và đổi tọa độ.
+     */
+    struct Camera {
+        int originX = 0; // Cột của ô ở góc trên trái khung nhìn
+        int originY = 0; // Hàng của ô ở góc trên trái khung nhìn
+        int columns = 0; // Số ô hiển thị theo chiều ngang
+        int rows = 0;    // Số ô hiển thị theo chiều dọc
+        int offsetX = 0; // Độ lệch (pixel, trong [0, cellSize)) của khung nhìn bên trong cột originX
+        int offsetY = 0; // Độ lệch (pixel, trong [0, cellSize)) của khung nhìn bên trong hàng originY
+
+        /**
+         *    Đặt khung nhìn sao cho target nằm giữa, kẹp trong bàn chơi.
+         *    target Ô cần theo dõi (thường là đầu rắn).
+         *    boardWidth Số ô theo chiều ngang của bàn chơi.
+         *    boardHeight Số ô theo chiều dọc của bàn chơi.
+         */
+        void follow(Point target, int boardWidth, int boardHeight) {
+            originX = std::clamp(target.x - columns / 2, 0, std::max(0, boardWidth - columns));
+            originY = std::clamp(target.y - rows / 2, 0, std::max(0, boardHeight - rows));
+            offsetX = 0;
+            offsetY = 0;
+        }
+
+        /**
+         *    Như follow(Point, ...) nhưng với vị trí liên tục (theo ô, ví dụ đầu rắn nội suy giữa hai bước):
+         *        phần lẻ của gốc khung nhìn trở thành độ lệch pixel offsetX/offsetY.
+         *    cellSize Kích thước một ô (pixel).
+         */
+        void follow(float targetX, float targetY, int boardWidth, int boardHeight, int cellSize) {
+            const float x = std::clamp(targetX - static_cast<float>(columns / 2), 0.0f, static_cast<float>(std::max(0, boardWidth - columns)));
+            const float y = std::clamp(targetY - static_cast<float>(rows / 2), 0.0f, static_cast<float>(std::max(0, boardHeight - rows)));
+            originX = static_cast<int>(x);
+            originY = static_cast<int>(y);
+            offsetX = std::min(cellSize - 1, static_cast<int>((x - static_cast<float>(originX)) * static_cast<float>(cellSize)));
+            offsetY = std::min(cellSize - 1, static_cast<int>((y - static_cast<float>(originY)) * static_cast<float>(cellSize)));
+        }
+
+        /**    Số cột/hàng có ít nhất một phần hiển thị (thêm một khi khung nhìn lệch giữa hai ô). */
+        [[nodiscard]] int visibleColumns() const { return columns + (offsetX > 0 ? 1 : 0); }
+        [[nodiscard]] int visibleRows() const { return rows + (offsetY > 0 ? 1 : 0); }
+
+        /**    true nếu ô hiển thị (dù chỉ một phần) trong khung nhìn. */
+        [[nodiscard]] bool contains(Point cell) const {
+            return cell.x >= originX && cell.y >= originY && cell.x < originX + visibleColumns() && cell.y < originY + visibleRows();
+        }
+
+        /**    Đổi ô trên bàn chơi sang ô tương đối trong khung nhìn. */
+        [[nodiscard]] Point toView(Point cell) const { return {cell.x - originX, cell.y - originY}; }
+
+        /**    Tọa độ pixel trên màn hình của góc trên trái một ô (đã trừ độ lệch pixel của khung nhìn). */
+        [[nodiscard]] Point toScreen(Point cell, int cellSize) const {
+            return {(cell.x - originX) * cellSize - offsetX, (cell.y - originY) * cellSize - offsetY};
+        }
+    };
+
+}
+
+#endif
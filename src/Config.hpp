@@ -2,49 +2,44 @@
 #define VORAX_SERPENS_CONFIG_HPP
 
 #include <SDL.h>
+#include <cstddef>
 #include <string>
+#include "CoreConfig.hpp"
 
 
 namespace SnakeGame {
     namespace Config {
 
-        // --- Cài đặt màn hình và lưới ---
-        constexpr int SCREEN_WIDTH = 1000;
-        constexpr int SCREEN_HEIGHT = 800;
-        constexpr int CELL_SIZE = 20;
-
-        // --- Cài đặt Rắn ---
-        constexpr int DEFAULT_SNAKE_LENGTH = 3;
-        constexpr int INITIAL_SNAKE_SPEED_DELAY_MS = 150; // Khoảng thời gian (ms) giữa các bước di chuyển ban đầu
-        constexpr int SPEED_INCREMENT_MS = 4;             // Mức giảm delay mỗi khi ăn mồi
-        constexpr int MIN_MOVE_INTERVAL_MS = 50;          // Khoảng thời gian tối thiểu (tốc độ tối đa thông thường)
-        constexpr int SNAKE_INPUT_BUFFER_SIZE = 2;        // Kích thước bộ đệm lệnh di chuyển
-
-        // --- Cài đặt Boost (Shift) ---
-        constexpr int MIN_BOOST_LENGTH = 3;           // Chiều dài tối thiểu của rắn để có thể boost
-        constexpr int BOOST_MOVE_INTERVAL_MS = 60;    // Khoảng thời gian (ms) giữa các bước khi boost (phải >= MIN_MOVE_INTERVAL_MS)
-        constexpr int BOOST_SCORE_COST = 1;           // Số điểm bị trừ mỗi lần áp dụng chi phí boost
-        constexpr int BOOST_COST_INTERVAL_MS = 200;   // Áp dụng chi phí boost mỗi 200ms
-        constexpr int BOOST_LENGTH_COST_INTERVALS = 1;// Giảm chiều dài rắn sau mỗi X lần trừ điểm
+        // --- Cài đặt màn hình ---
+        constexpr int CELL_SIZE = 20;                     // Kích thước một ô khi vẽ (pixel)
+        constexpr int SCREEN_WIDTH = BOARD_WIDTH * CELL_SIZE;
+        constexpr int SCREEN_HEIGHT = BOARD_HEIGHT * CELL_SIZE;
+        constexpr Uint32 IDLE_FRAME_DELAY_MS = 8;         // Thời gian ngủ của vòng lặp chính khi frame không đổi (bỏ qua vẽ và present)
+        constexpr int IDLE_WAIT_MAX_MS = 1000;            // Thời gian chờ sự kiện tối đa khi không mô phỏng (menu, tạm dừng, game over)
+        constexpr Uint32 CURSOR_BLINK_MS = 500;           // Nửa chu kỳ nhấp nháy của con trỏ nhập tên
+        constexpr bool PRESENT_VSYNC = true;              // Đồng bộ present với tần số quét (tắt để so sánh độ trễ input)
+        constexpr std::size_t INPUT_LATENCY_WINDOW = 120; // Số mẫu độ trễ input -> present gần nhất trên overlay F3
+
+        // --- Cài đặt Minimap (bàn chơi lớn) ---
+        constexpr int MINIMAP_SIZE = 160;                 // Cạnh dài của minimap trên màn hình (pixel)
+        constexpr int MINIMAP_MAX_TEXELS = 256;           // Độ phân giải tối đa của texture minimap theo mỗi chiều
+        constexpr int MINIMAP_MARGIN = 10;                // Khoảng cách tới góc dưới phải màn hình
+        constexpr SDL_Color MINIMAP_BACKGROUND_COLOR = {0, 0, 0, 170};    // Ô trống trên minimap
+        constexpr SDL_Color MINIMAP_VIEWPORT_COLOR = {255, 255, 255, 255}; // Khung nhìn của camera trên minimap
+        constexpr SDL_Color MINIMAP_FOOD_COLOR = {255, 60, 60, 255};       // Điểm đánh dấu mồi
+        constexpr int STATIC_LAYER_MARGIN_CELLS = 8;      // Số ô nướng thêm quanh khung nhìn mỗi phía (camera cuộn trong phạm vi này không phải nướng lại)
 
         // --- Cài đặt Game ---
         constexpr int MAX_HIGH_SCORES = 5;                // Số lượng điểm cao tối đa hiển thị/lưu trữ
-        constexpr int OBSTACLE_COUNT = 10;                // Số lượng vật cản ban đầu
-        constexpr int OBSTACLE_ADD_SCORE_INTERVAL = 2;    // Thêm vật cản mới sau mỗi X điểm
-
-
-        // --- Cấu hình Độ khó Vật cản theo Điểm ---
-        constexpr float BASE_MOVING_OBSTACLE_RATIO = 0.3f;  // Tỷ lệ vật cản động ban đầu (30%)
-        constexpr float MAX_MOVING_OBSTACLE_RATIO = 0.8f;   // Tỷ lệ vật cản động tối đa (80%)
-        constexpr float MOVING_RATIO_SCORE_FACTOR = 0.005f; // Tỷ lệ tăng thêm cho mỗi điểm (0.5% / điểm)
-
-        constexpr int BASE_OBSTACLE_SPEED_FACTOR = 3;   // Factor tốc độ ban đầu (chậm)
-        constexpr int MIN_OBSTACLE_SPEED_FACTOR = 1;    // Factor tốc độ tối thiểu (nhanh nhất)
-        constexpr int OBSTACLE_SPEED_SCORE_DIVISOR = 50; // Giảm speed factor sau mỗi X điểm
+        constexpr std::size_t PLAYER_NAME_MAX_LENGTH = 15; // Số ký tự (không phải byte) tối đa của tên người chơi
 
         // --- Màu sắc ---
         constexpr SDL_Color SNAKE_COLOR = {0, 255, 0, 255};     // Màu thân rắn
          constexpr SDL_Color SNAKE_HEAD_COLOR = {0, 200, 0, 255}; // Tùy chọn: màu đầu rắn khác
+        constexpr float SNAKE_TAIL_SHADE = 0.45f;       // Độ sáng của đốt đuôi so với màu thân (thân chuyển dần từ cổ tới đuôi)
+        constexpr float SNAKE_CORNER_CUT = 0.3f;        // Phần cạnh ô bị vát ở mỗi góc đốt rắn (góc ngoài trông tròn)
+        constexpr SDL_Color BOT_SNAKE_COLOR = {0, 170, 255, 255};     // Màu thân rắn bot (Arena)
+        constexpr SDL_Color BOT_SNAKE_HEAD_COLOR = {0, 120, 220, 255}; // Màu đầu rắn bot (Arena)
         constexpr SDL_Color OBSTACLE_COLOR = {100, 100, 100, 255}; // Màu vật cản
         constexpr SDL_Color BACKGROUND_COLOR = {30, 30, 30, 255}; // Màu nền mặc định
         constexpr SDL_Color TEXT_COLOR = {255, 255, 255, 255};  // Màu text chung
@@ -57,19 +52,23 @@ namespace SnakeGame {
         // --- Đường dẫn Tài nguyên ---
         const std::string FONT_PATH = "assets/fonts/Roboto-Regular.ttf"; // Đường dẫn font
         constexpr int FONT_SIZE = 24;                                    // Kích thước font hiển thị
+        constexpr int GLYPH_ATLAS_PAGE_SIZE = 1024;                      // Cạnh của mỗi trang texture trong atlas glyph (pixel)
         const std::string MENU_IMAGE_PATH = "assets/images/main_menu.png";   // Ảnh nền menu chính
         const std::string BACKGROUND_IMAGE_PATH = "assets/images/Space_Background.png"; // Ảnh nền trong game
         const std::string FOOD_IMAGE_PATH = "assets/images/apple.png";       // Ảnh mồi (mặc định)
+        const std::string REPLAY_DIRECTORY = "replays";                     // Thư mục lưu replay của mọi ván đơn
+        constexpr int REPLAY_SEEK_TICKS = 100;                               // Số bước tua mỗi lần nhấn trái/phải trong trình xem replay (x10 khi giữ Shift)
+
+        // --- Ghi hình (F12, --capture) ---
+        const std::string CAPTURE_DIRECTORY = "captures";                   // Thư mục của các bản ghi bật bằng F12
+        constexpr int CAPTURE_FPS = 30;                                      // Tốc độ khung hình của bản ghi
+        constexpr int CAPTURE_BUFFER_COUNT = 8;                              // Số bộ đệm frame trong pool (giới hạn hàng đợi mã hóa)
+        constexpr int CAPTURE_WORKER_THREADS = 2;                            // Số luồng đổi màu / nén / ghi file
         const std::string HIGHSCORE_FILE = "highscore.dat";                  // Tên file lưu điểm cao
         const std::string EAT_SOUND_PATH = "assets/sounds/eat.wav";        // Âm thanh ăn mồi
         const std::string COLLISION_SOUND_PATH = "assets/sounds/hit.wav"; // Âm thanh va chạm chung
         const std::string GAME_OVER_SOUND_PATH = "assets/sounds/game_over.wav"; // Âm thanh kết thúc
 
-        /**
-         * Xác định các hướng di chuyển có thể của rắn.
-         */
-        enum class Direction { UP, DOWN, LEFT, RIGHT };
-
         /**
          *  ControlInput
          *  Đại diện cho các hành động điều khiển của người chơi, được dịch từ input thô.
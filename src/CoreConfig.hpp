@@ -0,0 +1,88 @@
+#ifndef VORAX_SERPENS_CORE_CONFIG_HPP
+#define VORAX_SERPENS_CORE_CONFIG_HPP
+
+// Các hằng số luật chơi dùng chung cho lõi mô phỏng (vorax_core).
+// File này KHÔNG được include SDL để lõi có thể build độc lập (headless, Linux).
+
+namespace SnakeGame {
+    namespace Config {
+
+        // --- Cài đặt lưới (tính theo ô, độc lập với kích thước cửa sổ) ---
+        constexpr int BOARD_WIDTH = 50;
+        constexpr int BOARD_HEIGHT = 40;
+        constexpr int HUGE_BOARD_WIDTH = 2048;  // Bàn chơi lớn (camera + minimap), độc lập với cửa sổ
+        constexpr int HUGE_BOARD_HEIGHT = 2048;
+
+        // --- Cài đặt Arena (nhiều rắn trên một bàn chơi) ---
+        constexpr int ARENA_BOARD_WIDTH = 120;
+        constexpr int ARENA_BOARD_HEIGHT = 120;
+        constexpr int ARENA_SNAKE_COUNT = 32;        // Gồm cả rắn của người chơi
+        constexpr int ARENA_FOOD_COUNT = 40;
+        constexpr int ARENA_MOVE_INTERVAL_MS = 100;  // Arena chạy với tốc độ cố định (không có boost)
+
+        // --- Cài đặt Replay ---
+        constexpr int REPLAY_KEYFRAME_INTERVAL = 1200; // Số bước giữa hai keyframe (ảnh chụp trạng thái) trong replay
+        constexpr long long REPLAY_KEYFRAME_BUDGET_BYTES = 64ll << 20; // Bộ nhớ tối đa cho keyframe; vượt quá thì giãn khoảng cách gấp đôi
+
+        // --- Cài đặt Autopilot ---
+        constexpr int AUTOPILOT_REPAIR_NODE_BUDGET = 4096; // Số ô tối đa A* cục bộ được mở rộng khi sửa một đoạn đường bị chặn
+        constexpr int AUTOPILOT_RETRY_TICKS = 8;           // Sau khi không tìm được đường an toàn, chờ số bước này mới tìm lại
+
+        // --- Cài đặt Tournament ---
+        constexpr int TOURNAMENT_GAMES_PER_JOB = 8;  // Số seed liên tiếp mỗi công việc (cũng là mẫu để ước lượng games/sec)
+
+        // --- Cài đặt Lookahead (bot tìm kiếm nhiều bước) ---
+        constexpr int LOOKAHEAD_MAX_DEPTH = 12;             // Độ sâu tối đa của tìm kiếm đào sâu dần
+        constexpr int LOOKAHEAD_SAMPLES = 3;                // Số mẫu ngẫu nhiên (vị trí mồi mới, vật cản) lấy trung bình mỗi nước
+        constexpr float LOOKAHEAD_BUDGET_FRACTION = 0.25f;  // Thời gian tìm kiếm mỗi nước = tỷ lệ này x stepIntervalMs()
+        constexpr int LOOKAHEAD_TABLE_BITS = 16;            // Bảng chuyển vị có 2^bits mục
+        constexpr int LOOKAHEAD_BENCH_NODE_BUDGET = 1000;   // Headless: số nút mỗi nước thay cho thời gian (kết quả tất định)
+
+        // --- Cài đặt Rắn ---
+        constexpr int DEFAULT_SNAKE_LENGTH = 3;
+        constexpr int INITIAL_SNAKE_SPEED_DELAY_MS = 150; // Khoảng thời gian (ms) giữa các bước di chuyển ban đầu
+        constexpr int SPEED_INCREMENT_MS = 4;             // Mức giảm delay mỗi khi ăn mồi
+        constexpr int MIN_MOVE_INTERVAL_MS = 50;          // Khoảng thời gian tối thiểu (tốc độ tối đa thông thường)
+        constexpr int SNAKE_INPUT_BUFFER_SIZE = 2;        // Kích thước bộ đệm lệnh di chuyển
+
+        // --- Cài đặt Boost (Shift) ---
+        constexpr int MIN_BOOST_LENGTH = 3;           // Chiều dài tối thiểu của rắn để có thể boost
+        constexpr int BOOST_MOVE_INTERVAL_MS = 60;    // Khoảng thời gian (ms) giữa các bước khi boost (phải >= MIN_MOVE_INTERVAL_MS)
+        constexpr int BOOST_SCORE_COST = 1;           // Số điểm bị trừ mỗi lần áp dụng chi phí boost
+        constexpr int BOOST_COST_INTERVAL_MS = 200;   // Áp dụng chi phí boost mỗi 200ms
+        constexpr int BOOST_LENGTH_COST_INTERVALS = 1;// Giảm chiều dài rắn sau mỗi X lần trừ điểm
+
+        // --- Cài đặt Vật cản ---
+        constexpr int OBSTACLE_COUNT = 10;                // Số lượng vật cản ban đầu
+        constexpr int OBSTACLE_ADD_SCORE_INTERVAL = 2;    // Thêm vật cản mới sau mỗi X điểm
+        constexpr int OBSTACLE_SAFE_RADIUS = 2;           // Bán kính (ô) quanh đầu rắn không đặt vật cản ban đầu
+
+        // --- Cấu hình Độ khó Vật cản theo Điểm ---
+        constexpr float BASE_MOVING_OBSTACLE_RATIO = 0.3f;  // Tỷ lệ vật cản động ban đầu (30%)
+        constexpr float MAX_MOVING_OBSTACLE_RATIO = 0.8f;   // Tỷ lệ vật cản động tối đa (80%)
+        constexpr float MOVING_RATIO_SCORE_FACTOR = 0.005f; // Tỷ lệ tăng thêm cho mỗi điểm (0.5% / điểm)
+
+        constexpr int BASE_OBSTACLE_SPEED_FACTOR = 3;   // Factor tốc độ ban đầu (chậm)
+        constexpr int MIN_OBSTACLE_SPEED_FACTOR = 1;    // Factor tốc độ tối thiểu (nhanh nhất)
+        constexpr int OBSTACLE_SPEED_SCORE_DIVISOR = 50; // Giảm speed factor sau mỗi X điểm
+
+        /**
+         * Xác định các hướng di chuyển có thể của rắn.
+         */
+        enum class Direction { UP, DOWN, LEFT, RIGHT };
+
+    }
+
+    /**
+     *    Point
+     *    Tọa độ nguyên (x, y) dùng trong lõi mô phỏng, tương đương SDL_Point nhưng không phụ thuộc SDL.
+     */
+    struct Point {
+        int x = 0;
+        int y = 0;
+
+        bool operator==(const Point& other) const = default;
+    };
+
+}
+#endif
@@ -0,0 +1,50 @@
+#include "DisplayList.hpp"
+#include <iostream>
+
+namespace SnakeGame {
+
+    void DisplayList::begin(std::uint64_t key) {
+        items.clear();
+        ownedTextures.clear();
+        builtKey = key;
+        built = true;
+    }
+
+    void DisplayList::addTexture(SDL_Texture* texture, const SDL_Rect& dest) {
+        if (!texture) return;
+        items.push_back({texture, dest, {0, 0, 0, 0}, false});
+    }
+
+    void DisplayList::addRect(const SDL_Rect& rect, SDL_Color color, bool filled) {
+        items.push_back({nullptr, rect, color, filled});
+    }
+
+    SDL_Rect DisplayList::addText(const Renderer& renderer, const std::string& text, int x, int y, SDL_Color color) {
+        SDL_Rect dest = {x, y, 0, 0};
+        if (text.empty()) return dest;
+        std::unique_ptr<SDL_Texture, SDLTextureDestroyer> texture(renderer.createTextTexture(text, color));
+        if (!texture) {
+            std::cerr << "Warning: Could not build UI text \"" << text << "\"." << std::endl;
+            return dest;
+        }
+        const SDL_Point size = renderer.getTextSize(text);
+        dest.w = size.x;
+        dest.h = size.y;
+        items.push_back({texture.get(), dest, {0, 0, 0, 0}, false});
+        ownedTextures.push_back(std::move(texture));
+        return dest;
+    }
+
+    SDL_Rect DisplayList::addCenteredText(const Renderer& renderer, const std::string& text, int screenWidth, int y, SDL_Color color) {
+        const SDL_Point size = renderer.getTextSize(text);
+        return addText(renderer, text, (screenWidth - size.x) / 2, y, color);
+    }
+
+    void DisplayList::draw(const Renderer& renderer) const {
+        for (const Item& item : items) {
+            if (item.texture) renderer.drawTexture(item.texture, &item.rect);
+            else renderer.drawRect(&item.rect, item.color, item.filled);
+        }
+    }
+
+}
@@ -0,0 +1,68 @@
+#ifndef DISPLAY_LIST_HPP
+#define DISPLAY_LIST_HPP
+
+#include "Renderer.hpp"
+#include <SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    DisplayList
+     *    Danh sách lệnh vẽ đã dựng sẵn của một màn hình UI (retained mode): các texture (kèm rect đích) và hình chữ nhật màu.
+     *        Caller tính một khóa từ mọi đầu vào của màn hình (mục đang chọn, nội dung tùy chọn, bảng điểm cao...)
+     *        và chỉ dựng lại khi khóa đổi; các frame còn lại draw() chỉ phát lại danh sách, mỗi dòng chữ là một lần chép texture.
+     *        Texture chữ do danh sách sở hữu và được tạo lại khi dựng lại.
+     */
+    class DisplayList {
+    public:
+        /**    true nếu danh sách đã được dựng với đúng khóa này (không cần dựng lại). */
+        [[nodiscard]] bool isCurrent(std::uint64_t key) const { return built && key == builtKey; }
+
+        /**    Xóa danh sách (và giải phóng texture chữ cũ) để dựng lại cho khóa mới. */
+        void begin(std::uint64_t key);
+
+        /**    Buộc lần kiểm tra isCurrent() tiếp theo dựng lại (ví dụ khi caller đã xóa dữ liệu suy ra từ danh sách). */
+        void invalidate() { built = false; }
+
+        /**    Thêm một texture không thuộc sở hữu của danh sách (ảnh nền, chữ cache sẵn). */
+        void addTexture(SDL_Texture* texture, const SDL_Rect& dest);
+
+        /**    Thêm một hình chữ nhật màu (đặc hoặc chỉ viền). */
+        void addRect(const SDL_Rect& rect, SDL_Color color, bool filled);
+
+        /**
+         *    Tạo texture cho một dòng chữ UTF-8 và thêm vào danh sách tại (x, y).
+         *    SDL_Rect Vùng chữ trên màn hình (dùng cho hit test), {x, y, 0, 0} nếu không tạo được texture.
+         */
+        SDL_Rect addText(const Renderer& renderer, const std::string& text, int x, int y, SDL_Color color);
+
+        /**    Như addText nhưng căn giữa theo chiều ngang của màn hình rộng screenWidth. */
+        SDL_Rect addCenteredText(const Renderer& renderer, const std::string& text, int screenWidth, int y, SDL_Color color);
+
+        /**    Phát lại toàn bộ danh sách theo thứ tự đã thêm. */
+        void draw(const Renderer& renderer) const;
+
+        [[nodiscard]] std::size_t size() const { return items.size(); }
+
+    private:
+        struct Item {
+            SDL_Texture* texture = nullptr;  // nullptr: hình chữ nhật màu
+            SDL_Rect rect = {0, 0, 0, 0};
+            SDL_Color color = {0, 0, 0, 0};
+            bool filled = false;
+        };
+
+        std::vector<Item> items;
+        std::vector<std::unique_ptr<SDL_Texture, SDLTextureDestroyer>> ownedTextures;
+        std::uint64_t builtKey = 0;
+        bool built = false;
+    };
+
+}
+
+#endif
@@ -1,10 +1,11 @@
 #ifndef FOOD_HPP
 #define FOOD_HPP
 
-#include <SDL.h>
-#include <vector>
-#include <random>
-#include <deque>
+#include "Random.hpp"
+#include <cstdint>
+#include "CoreConfig.hpp"
+#include "OccupancyGrid.hpp"
+#include "ByteStream.hpp"
 
 namespace SnakeGame {
 
@@ -17,35 +18,46 @@ namespace SnakeGame {
     public:
         /**
          *   Khởi tạo đối tượng Food.
-         *   cellSize Kích thước của mỗi ô (cell) trong game.
+         *   seed Hạt giống cho bộ sinh số ngẫu nhiên (cùng seed -> cùng chuỗi vị trí mồi).
          */
-        explicit Food(int cellSize);
+        explicit Food(std::uint32_t seed);
+
+        /**
+         *   Đặt lại hạt giống cho bộ sinh số ngẫu nhiên (dùng khi bắt đầu ván mới có seed).
+         *   seed Hạt giống mới.
+         */
+        void reseed(std::uint32_t seed);
 
         /**
          *   Tạo vị trí mới cho thức ăn, đảm bảo không trùng với thân rắn hoặc chướng ngại vật.
-         *   screenWidth Chiều rộng màn hình (pixels).
-         *   screenHeight Chiều cao màn hình (pixels).
-         *   snakeBody Deque chứa các điểm (SDL_Point) của thân rắn.
-         *   obstacles Vector chứa các điểm (SDL_Point) của chướng ngại vật (vị trí hiện tại).
+         *        Rút ngẫu nhiên đều đúng một lần từ tập ô trống của lưới, ở mọi mức độ lấp đầy bàn chơi.
+         *        Không tự cập nhật bit Food trên lưới.
+         *   grid Lưới chiếm chỗ của bàn chơi (caller xóa bit Food của mồi cũ trước khi gọi).
          */
-        void generate(int screenWidth, int screenHeight, const std::deque<SDL_Point>& snakeBody, const std::vector<SDL_Point>& obstacles);
+        void generate(const OccupancyGrid& grid);
 
         /**
          *   Lấy vị trí hiện tại của thức ăn.
-         *   SDL_Point chứa tọa độ (x, y) của thức ăn. Trả về {-cellSize, -cellSize} nếu chưa được đặt hoặc không thể đặt.
+         *   Point chứa tọa độ ô (x, y) của thức ăn. Trả về {-1, -1} nếu chưa được đặt hoặc không thể đặt.
          */
-        [[nodiscard]] SDL_Point getPosition() const;
+        [[nodiscard]] Point getPosition() const;
 
         /**
          *   Đặt thức ăn đến một vị trí cụ thể (hữu ích cho debug hoặc kịch bản).
-         *   x Tọa độ x mới.
-         *   y Tọa độ y mới.
+         *   x Cột mới (tọa độ ô).
+         *   y Hàng mới (tọa độ ô).
          */
         void forcePosition(int x, int y);
+
+        /**   Ghi vị trí và trạng thái bộ sinh số ngẫu nhiên vào ảnh chụp. */
+        void saveState(ByteWriter& writer) const;
+        /**   Kiểm tra dữ liệu do saveState ghi mà không nạp: vị trí nằm trong bàn chơi width x height hoặc là {-1, -1}. */
+        static bool checkState(ByteReader& reader, int width, int height);
+        /**   Khôi phục trạng thái do saveState ghi; dữ liệu phải đã qua checkState. */
+        void loadState(ByteReader& reader);
     private:
-        SDL_Point position; // Vị trí hiện tại của thức ăn
-        int cellSize;       // Kích thước ô
-        std::mt19937 rng;   // Bộ sinh số ngẫu nhiên Mersenne Twister
+        Point position; // Vị trí hiện tại của thức ăn
+        Rng rng;        // Bộ sinh số ngẫu nhiên (PCG32, 16 byte)
     };
 
 }
@@ -0,0 +1,225 @@
+#include "FrameCapture.hpp"
+#include "Config.hpp"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+namespace SnakeGame {
+
+    namespace {
+        std::uint8_t clampByte(int value) {
+            return static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+        }
+    }
+
+    FrameCapture::FrameCapture(const std::string& path, int width, int height, int fps)
+            : path(path), format(formatFor(path)), width(width), height(height) {
+        if (width <= 0 || height <= 0 || fps <= 0) {
+            std::cerr << "Warning: Invalid capture size " << width << "x" << height << " at " << fps << " fps." << std::endl;
+            return;
+        }
+
+        std::error_code error;
+        const std::filesystem::path target(path);
+        if (format == CaptureFormat::PngSequence) {
+            std::filesystem::create_directories(target, error);
+            if (error) {
+                std::cerr << "Warning: Could not create capture directory " << path << ": " << error.message() << std::endl;
+                return;
+            }
+        } else {
+            if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path(), error);
+            file.open(path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "Warning: Could not open capture file " << path << std::endl;
+                return;
+            }
+            file << "YUV4MPEG2 W" << width << " H" << height << " F" << fps << ":1 Ip A1:1 C420jpeg\n";
+        }
+
+        const std::size_t pixelCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        buffers.resize(static_cast<std::size_t>(std::max(1, Config::CAPTURE_BUFFER_COUNT)));
+        for (std::size_t i = 0; i < buffers.size(); ++i) {
+            buffers[i].resize(pixelCount);
+            freeBuffers.push_back(i);
+        }
+        const int threadCount = std::max(1, Config::CAPTURE_WORKER_THREADS);
+        for (int i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+        open = true;
+    }
+
+    FrameCapture::~FrameCapture() {
+        finish();
+    }
+
+    CaptureFormat FrameCapture::formatFor(const std::string& path) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".y4m" ? CaptureFormat::Y4M : CaptureFormat::PngSequence;
+    }
+
+    std::uint32_t* FrameCapture::acquire(bool wait) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!open || stopping) return nullptr;
+        if (freeBuffers.empty()) {
+            if (!wait) {
+                ++framesDropped;
+                return nullptr;
+            }
+            bufferFreed.wait(lock, [this] { return !freeBuffers.empty(); });
+        }
+        const std::size_t index = freeBuffers.back();
+        freeBuffers.pop_back();
+        return buffers[index].data();
+    }
+
+    void FrameCapture::submit(std::uint32_t* frame) {
+        const std::size_t index = indexOf(frame);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back({index, nextSequence++});
+        }
+        jobReady.notify_one();
+    }
+
+    void FrameCapture::discard(std::uint32_t* frame) {
+        releaseBuffer(indexOf(frame));
+    }
+
+    void FrameCapture::finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobReady.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+        workers.clear();
+        if (file.is_open()) file.close();
+        open = false;
+    }
+
+    std::size_t FrameCapture::indexOf(const std::uint32_t* frame) const {
+        for (std::size_t i = 0; i < buffers.size(); ++i) {
+            if (buffers[i].data() == frame) return i;
+        }
+        return buffers.size();
+    }
+
+    void FrameCapture::releaseBuffer(std::size_t index) {
+        if (index >= buffers.size()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(index);
+        }
+        bufferFreed.notify_one();
+    }
+
+    void FrameCapture::workerLoop() {
+        std::vector<std::uint8_t> planes; // Bộ đệm YUV riêng của luồng, dùng lại giữa các frame
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (jobs.empty()) return; // Đang dừng và đã ghi hết
+                job = jobs.front();
+                jobs.pop_front();
+            }
+
+            std::uint32_t* pixels = buffers[job.buffer].data();
+            if (format == CaptureFormat::Y4M) {
+                convertToYuv(pixels, planes);
+                releaseBuffer(job.buffer); // Đã đổi màu xong: luồng vẽ dùng lại được ngay, không chờ ghi file
+                writeY4mFrame(planes, job.sequence);
+            } else {
+                writePngFrame(pixels, job.sequence);
+                releaseBuffer(job.buffer);
+            }
+        }
+    }
+
+    void FrameCapture::convertToYuv(const std::uint32_t* pixels, std::vector<std::uint8_t>& planes) const {
+        const int chromaWidth = (width + 1) / 2;
+        const int chromaHeight = (height + 1) / 2;
+        const std::size_t lumaSize = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        const std::size_t chromaSize = static_cast<std::size_t>(chromaWidth) * static_cast<std::size_t>(chromaHeight);
+        planes.resize(lumaSize + 2 * chromaSize);
+        std::uint8_t* yPlane = planes.data();
+        std::uint8_t* uPlane = yPlane + lumaSize;
+        std::uint8_t* vPlane = uPlane + chromaSize;
+
+        for (std::size_t i = 0; i < lumaSize; ++i) {
+            const std::uint32_t p = pixels[i];
+            const int r = static_cast<int>((p >> 16) & 0xFF);
+            const int g = static_cast<int>((p >> 8) & 0xFF);
+            const int b = static_cast<int>(p & 0xFF);
+            yPlane[i] = static_cast<std::uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+        }
+
+        // Mỗi mẫu chroma là trung bình của khối 2x2 (ít hơn ở mép phải/dưới nếu kích thước lẻ)
+        for (int cy = 0; cy < chromaHeight; ++cy) {
+            for (int cx = 0; cx < chromaWidth; ++cx) {
+                int r = 0, g = 0, b = 0, count = 0;
+                for (int y = cy * 2; y < std::min(cy * 2 + 2, height); ++y) {
+                    for (int x = cx * 2; x < std::min(cx * 2 + 2, width); ++x) {
+                        const std::uint32_t p = pixels[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x)];
+                        r += static_cast<int>((p >> 16) & 0xFF);
+                        g += static_cast<int>((p >> 8) & 0xFF);
+                        b += static_cast<int>(p & 0xFF);
+                        ++count;
+                    }
+                }
+                r /= count; g /= count; b /= count;
+                const std::size_t c = static_cast<std::size_t>(cy) * static_cast<std::size_t>(chromaWidth) + static_cast<std::size_t>(cx);
+                uPlane[c] = clampByte(128 + ((-43 * r - 85 * g + 128 * b + 128) >> 8));
+                vPlane[c] = clampByte(128 + ((128 * r - 107 * g - 21 * b + 128) >> 8));
+            }
+        }
+    }
+
+    void FrameCapture::writeY4mFrame(const std::vector<std::uint8_t>& planes, std::uint64_t sequence) {
+        std::unique_lock<std::mutex> lock(writeMutex);
+        writeTurn.wait(lock, [this, sequence] { return nextWrite == sequence; });
+        if (!writeFailed) {
+            file << "FRAME\n";
+            file.write(reinterpret_cast<const char*>(planes.data()), static_cast<std::streamsize>(planes.size()));
+            if (file) ++framesWritten;
+            else reportWriteFailure(path);
+        }
+        ++nextWrite; // Vẫn tăng khi lỗi để các luồng đang chờ lượt không bị treo
+        lock.unlock();
+        writeTurn.notify_all();
+    }
+
+    void FrameCapture::writePngFrame(std::uint32_t* pixels, std::uint64_t sequence) {
+        if (writeFailed) return;
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06llu.png", static_cast<unsigned long long>(sequence));
+        const std::string framePath = (std::filesystem::path(path) / name).string();
+
+        SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels, width, height, 32, getPitch(), SDL_PIXELFORMAT_ARGB8888);
+        if (!surface) {
+            reportWriteFailure(framePath + ": " + SDL_GetError());
+            return;
+        }
+        if (IMG_SavePNG(surface, framePath.c_str()) != 0) reportWriteFailure(framePath + ": " + IMG_GetError());
+        else ++framesWritten;
+        SDL_FreeSurface(surface);
+    }
+
+    void FrameCapture::reportWriteFailure(const std::string& what) {
+        if (!writeFailed.exchange(true)) {
+            std::cerr << "Warning: Capture write failed (" << what << "); remaining frames are discarded." << std::endl;
+        }
+    }
+
+}
@@ -0,0 +1,116 @@
+#ifndef FRAME_CAPTURE_HPP
+#define FRAME_CAPTURE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    CaptureFormat
+     *    Định dạng ghi hình: video YUV 4:2:0 thô (.y4m, một file) hoặc chuỗi ảnh PNG (một thư mục).
+     */
+    enum class CaptureFormat { Y4M, PngSequence };
+
+    /**
+     *    FrameCapture
+     *    Ghi các frame đã vẽ ra đĩa mà luồng vẽ không phải chờ I/O.
+     *        Luồng vẽ lấy một bộ đệm ARGB8888 từ pool cố định (Config::CAPTURE_BUFFER_COUNT), đọc back buffer vào đó
+     *        rồi gửi đi; Config::CAPTURE_WORKER_THREADS luồng nền đổi màu (RGB -> YUV) / nén PNG và ghi file,
+     *        sau đó trả bộ đệm về pool. Pool chính là giới hạn của hàng đợi: khi cạn, acquire(false) bỏ frame
+     *        (ghi hình trực tiếp), acquire(true) chờ (dựng video từ replay, không được mất frame).
+     *        Frame .y4m được đổi màu song song nhưng ghi đúng thứ tự gửi.
+     */
+    class FrameCapture {
+    public:
+        /**
+         *    Mở đích ghi và khởi động các luồng mã hóa. Kiểm tra isOpen() sau khi tạo.
+         *    path File .y4m, hoặc thư mục chứa frame_NNNNNN.png (mọi đuôi khác).
+         *    width/height Kích thước frame (pixel); fps Tốc độ khung hình ghi vào header .y4m.
+         */
+        FrameCapture(const std::string& path, int width, int height, int fps);
+        /**    Ghi nốt các frame đang chờ rồi dừng các luồng (như finish()). */
+        ~FrameCapture();
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        /**    Định dạng tương ứng với đường dẫn: .y4m là video, còn lại là thư mục PNG. */
+        [[nodiscard]] static CaptureFormat formatFor(const std::string& path);
+
+        /**    true nếu đích ghi đã mở được và các luồng mã hóa đang chạy. */
+        [[nodiscard]] bool isOpen() const { return open; }
+
+        /**
+         *    Lấy một bộ đệm trống (height dòng, getPitch() byte mỗi dòng).
+         *    wait false: trả nullptr (và tính là frame bị bỏ) nếu pool đã cạn; true: chờ tới khi có bộ đệm trống.
+         */
+        [[nodiscard]] std::uint32_t* acquire(bool wait);
+
+        /**    Gửi bộ đệm đã điền cho các luồng mã hóa (theo thứ tự gọi). */
+        void submit(std::uint32_t* frame);
+
+        /**    Trả bộ đệm về pool mà không ghi (ví dụ đọc pixel thất bại). */
+        void discard(std::uint32_t* frame);
+
+        /**    Chờ mọi frame đã gửi được ghi xong, dừng các luồng và đóng file. Gọi nhiều lần vô hại. */
+        void finish();
+
+        [[nodiscard]] int getPitch() const { return width * static_cast<int>(sizeof(std::uint32_t)); }
+        [[nodiscard]] const std::string& getPath() const { return path; }
+        [[nodiscard]] std::uint64_t getFramesWritten() const { return framesWritten.load(); }
+        [[nodiscard]] std::uint64_t getFramesDropped() const { return framesDropped.load(); }
+
+    private:
+        struct Job {
+            std::size_t buffer = 0;
+            std::uint64_t sequence = 0;
+        };
+
+        std::string path;
+        CaptureFormat format;
+        int width;
+        int height;
+        bool open = false;
+        std::ofstream file;                      // Chỉ dùng cho .y4m
+
+        std::vector<std::vector<std::uint32_t>> buffers;
+        std::vector<std::size_t> freeBuffers;
+        std::deque<Job> jobs;
+        std::uint64_t nextSequence = 0;          // Số thứ tự của frame gửi tiếp theo
+        bool stopping = false;
+        std::mutex mutex;                        // Bảo vệ freeBuffers, jobs, nextSequence, stopping
+        std::condition_variable jobReady;
+        std::condition_variable bufferFreed;
+
+        std::uint64_t nextWrite = 0;             // Frame .y4m tiếp theo được phép ghi
+        std::mutex writeMutex;                   // Bảo vệ file và nextWrite (tách khỏi mutex để luồng vẽ không chờ I/O)
+        std::condition_variable writeTurn;
+
+        std::vector<std::thread> workers;
+        std::atomic<std::uint64_t> framesWritten{0};
+        std::atomic<std::uint64_t> framesDropped{0};
+        std::atomic<bool> writeFailed{false};
+
+        void workerLoop();
+        /**    Chỉ số của bộ đệm trong pool. */
+        [[nodiscard]] std::size_t indexOf(const std::uint32_t* frame) const;
+        void releaseBuffer(std::size_t index);
+        /**    Đổi ARGB8888 sang YUV 4:2:0 toàn dải (BT.601, như C420jpeg) vào planes. */
+        void convertToYuv(const std::uint32_t* pixels, std::vector<std::uint8_t>& planes) const;
+        void writeY4mFrame(const std::vector<std::uint8_t>& planes, std::uint64_t sequence);
+        void writePngFrame(std::uint32_t* pixels, std::uint64_t sequence);
+        void reportWriteFailure(const std::string& what);
+    };
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef FREE_CELL_SET_HPP
+#define FREE_CELL_SET_HPP
+
+#include "ByteStream.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    FreeCellSet
+     *    Tập thưa (sparse set) các chỉ số ô trống: mảng dày 'cells' chứa các ô trống theo thứ tự bất kỳ,
+     *        mảng thưa 'slots' lưu vị trí của từng ô trong mảng dày (-1 nếu ô không trống).
+     *        Thêm/xóa (swap-remove) và lấy mẫu ngẫu nhiên đều là O(1), bất kể bàn chơi đầy bao nhiêu.
+     */
+    class FreeCellSet {
+    public:
+        FreeCellSet() = default;
+
+        /**    Khởi tạo lại với cellCount ô, tất cả đều trống. */
+        void fill(int cellCount) {
+            cells.resize(cellCount);
+            slots.resize(cellCount);
+            for (int i = 0; i < cellCount; ++i) {
+                cells[i] = i;
+                slots[i] = i;
+            }
+        }
+
+        /**    Đánh dấu ô là trống (không làm gì nếu đã có trong tập). */
+        void insert(int cell) {
+            if (slots[cell] >= 0) return;
+            slots[cell] = static_cast<std::int32_t>(cells.size());
+            cells.push_back(cell);
+        }
+
+        /**    Đánh dấu ô là bị chiếm: hoán đổi với phần tử cuối rồi pop (không làm gì nếu không có trong tập). */
+        void erase(int cell) {
+            const std::int32_t slot = slots[cell];
+            if (slot < 0) return;
+            const std::int32_t last = cells.back();
+            cells[slot] = last;
+            slots[last] = slot;
+            cells.pop_back();
+            slots[cell] = -1;
+        }
+
+        [[nodiscard]] bool contains(int cell) const { return slots[cell] >= 0; }
+        [[nodiscard]] int size() const { return static_cast<int>(cells.size()); }
+        [[nodiscard]] bool empty() const { return cells.empty(); }
+
+        /**
+         *    Lấy ngẫu nhiên đều một ô trống bằng đúng một lần rút số.
+         *    rng Bộ sinh số ngẫu nhiên (chuẩn UniformRandomBitGenerator).
+         *    int Chỉ số ô trống, hoặc -1 nếu không còn ô trống.
+         */
+        template <typename Rng>
+        [[nodiscard]] int sample(Rng& rng) const {
+            if (cells.empty()) return -1;
+            std::uniform_int_distribution<int> dist(0, static_cast<int>(cells.size()) - 1);
+            return cells[dist(rng)];
+        }
+
+        /**
+         *    Ghi cả hai mảng vào ảnh chụp. Thứ tự trong mảng dày phụ thuộc lịch sử thêm/xóa và quyết định kết quả của sample(),
+         *        nên phải được chép nguyên vẹn (không thể dựng lại từ lưới) để mô phỏng sau khi khôi phục vẫn tất định.
+         */
+        void saveState(ByteWriter& writer) const {
+            writer.array(cells);
+            writer.array(slots);
+        }
+
+        /**
+         *    Kiểm tra dữ liệu do saveState ghi mà không nạp: mọi chỉ số nằm trong [0, cellCount)
+         *        và hai mảng là nghịch đảo của nhau (để insert/erase/sample sau khi nạp không truy cập ngoài mảng).
+         */
+        static bool checkState(ByteReader& reader, int cellCount) {
+            const auto dense = reader.arrayView<std::int32_t>(static_cast<std::size_t>(cellCount));
+            const auto sparse = reader.arrayView<std::int32_t>(static_cast<std::size_t>(cellCount));
+            if (!reader.ok() || sparse.size() != static_cast<std::size_t>(cellCount)) return false;
+            // Mỗi ô trong mảng dày trỏ ngược về đúng vị trí của nó, và số ô có vị trí (>= 0) bằng độ dài mảng dày
+            bool valid = true;
+            std::size_t members = 0;
+            for (std::size_t cell = 0; cell < sparse.size(); ++cell) {
+                const std::int32_t slot = sparse[cell];
+                valid &= slot >= -1;
+                members += static_cast<std::size_t>(slot >= 0);
+            }
+            for (std::size_t slot = 0; slot < dense.size() && valid; ++slot) {
+                const std::int32_t cell = dense[slot];
+                valid = cell >= 0 && cell < cellCount && sparse[static_cast<std::size_t>(cell)] == static_cast<std::int32_t>(slot);
+            }
+            return valid && members == dense.size();
+        }
+
+        /**    Khôi phục trạng thái do saveState ghi; dữ liệu phải đã qua checkState với cùng cellCount. */
+        void loadState(ByteReader& reader, int cellCount) {
+            reader.array(cells, static_cast<std::size_t>(cellCount));
+            reader.array(slots, static_cast<std::size_t>(cellCount));
+        }
+
+    private:
+        std::vector<std::int32_t> cells; // Mảng dày: các ô trống
+        std::vector<std::int32_t> slots; // Mảng thưa: vị trí trong 'cells' hoặc -1
+    };
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Game.hpp"
 #include "Renderer.hpp"
+#include "GlyphAtlas.hpp"
 #include "Config.hpp"
 #include <SDL_mixer.h>
 #include <string>
@@ -8,9 +9,13 @@
 #include <fstream>
 #include <random>
 #include <sstream>
+#include <iomanip>
+#include <ctime>
 #include <vector>
 #include <SDL.h>
 #include <cstring>
+#include <cstdlib>
+#include <filesystem>
 
 namespace SnakeGame {
 
@@ -26,34 +31,89 @@ namespace SnakeGame {
             : screenWidth(w),
               screenHeight(h),
               cellSize(size),
-              snake(calculateStartPosition().x, calculateStartPosition().y, size, Config::DEFAULT_SNAKE_LENGTH),
-              food(size),
+              simulation(w / size, h / size, std::random_device{}(), GameMode::Classic),
+              camera{0, 0, w / size, h / size},
               currentState(GameState::MainMenu),
               currentGameMode(GameMode::Classic),
               soundEnabled(true),
-              score(0),
-              moveInterval(Config::INITIAL_SNAKE_SPEED_DELAY_MS),
               quitRequested(false),
               timeAccumulator(0.0f),
-              isBoosting(false),
-              boostCostTimer(0.0f),
-              boostCostCycles(0),
+              boostHeld(false),
               selectedButtonIndex(0),
               selectedOptionIndex(0),
-              isEnteringName(false),
-              nextObstacleScoreThreshold(Config::OBSTACLE_ADD_SCORE_INTERVAL),
-              rng(std::random_device{}())
+              isEnteringName(false)
     {
         loadHighScores();
         initAssets(renderer);
         initOptions();
-        generateObstacles();
-        placeFood();
         std::cout << "Game Initialized. Mode: "
                   << (currentGameMode == GameMode::Classic ? "Classic" : "Portal")
                   << ". High Scores Loaded. Ready for Main Menu." << std::endl;
     }
 
+    Game::~Game() {
+        finishReplay();
+        stopCapture();
+        reportInputLatency();
+    }
+
+    bool Game::startCapture(const std::string& path, bool offline) {
+        stopCapture();
+        auto started = std::make_unique<FrameCapture>(path, screenWidth, screenHeight, Config::CAPTURE_FPS);
+        if (!started->isOpen()) return false;
+        capture = std::move(started);
+        offlineCapture = offline;
+        lastCaptureCounter = 0;
+        markDirty();
+        std::cout << "Capture started: " << path << (offline ? " (offline, every frame)" : "") << std::endl;
+        return true;
+    }
+
+    void Game::stopCapture() {
+        if (!capture) return;
+        capture->finish();
+        std::cout << "Capture finished: " << capture->getPath() << " (" << capture->getFramesWritten() << " frames written, "
+                  << capture->getFramesDropped() << " dropped)." << std::endl;
+        capture.reset();
+    }
+
+    void Game::captureFrame(Renderer& renderer) {
+        if (!offlineCapture) {
+            const std::uint64_t now = SDL_GetPerformanceCounter();
+            const std::uint64_t interval = SDL_GetPerformanceFrequency() / static_cast<std::uint64_t>(Config::CAPTURE_FPS);
+            if (lastCaptureCounter == 0) {
+                lastCaptureCounter = now;
+            } else {
+                if (now - lastCaptureCounter < interval) return;
+                // Giữ pha theo lưới CAPTURE_FPS để video không bị tua nhanh; tụt quá một chu kỳ thì bắt kịp thay vì ghi dồn
+                lastCaptureCounter += interval;
+                if (now - lastCaptureCounter > interval) lastCaptureCounter = now - interval;
+            }
+        }
+        std::uint32_t* frame = capture->acquire(offlineCapture);
+        if (!frame) return; // Pool cạn: bỏ frame này thay vì chặn luồng vẽ
+        if (renderer.readPixels(frame, capture->getPitch())) capture->submit(frame);
+        else capture->discard(frame);
+    }
+
+    void Game::reportInputLatency() const {
+        const SampleStats present = inputLatency.sessionStats();
+        if (present.count == 0) return;
+        const SampleStats apply = inputLatency.sessionApplyStats();
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Input latency (" << present.count << " direction inputs; vsync " << (Config::PRESENT_VSYNC ? "on" : "off")
+                  << ", idle frame delay " << Config::IDLE_FRAME_DELAY_MS << " ms, input buffer " << Config::SNAKE_INPUT_BUFFER_SIZE << "):\n"
+                  << "  input -> tick:    p50 " << apply.p50 << " ms | p95 " << apply.p95 << " ms | p99 " << apply.p99 << " ms | max " << apply.max << " ms\n"
+                  << "  input -> present: p50 " << present.p50 << " ms | p95 " << present.p95 << " ms | p99 " << present.p99 << " ms | max " << present.max << " ms"
+                  << std::defaultfloat << std::endl;
+    }
+
+    void Game::setSessionSeed(std::uint32_t seed) {
+        sessionSeed = seed;
+        gamesStarted = 0;
+        std::cout << "Session seed set to " << seed << "." << std::endl;
+    }
+
     void Game::initAssets(Renderer& renderer) {
         backgroundTexture.reset(renderer.loadTexture(Config::BACKGROUND_IMAGE_PATH));
         menuTexture.reset(renderer.loadTexture(Config::MENU_IMAGE_PATH));
@@ -110,6 +170,8 @@ namespace SnakeGame {
         optionsMenuItems.clear();
         optionsMenuItems.push_back({ "", OptionAction::TOGGLE_MODE });
         optionsMenuItems.push_back({ "", OptionAction::TOGGLE_SOUND });
+        optionsMenuItems.push_back({ "", OptionAction::TOGGLE_BOARD_SIZE });
+        optionsMenuItems.push_back({ "", OptionAction::TOGGLE_ARENA });
         optionsMenuItems.push_back({ "Reset High Scores", OptionAction::RESET_HIGHSCORES });
         optionsMenuItems.push_back({ "Back", OptionAction::GOTO_MAINMENU });
         updateOptionTexts();
@@ -123,23 +185,41 @@ namespace SnakeGame {
                 item.text = "Game Mode: " + std::string(currentGameMode == GameMode::Classic ? "Classic" : "Portal Walls");
             } else if (item.action == OptionAction::TOGGLE_SOUND) {
                 item.text = "Sound: " + std::string(soundEnabled ? "On" : "Off");
+            } else if (item.action == OptionAction::TOGGLE_BOARD_SIZE) {
+                const Point size = selectedBoardSize();
+                item.text = "Board: " + std::string(hugeBoard ? "Huge " : "Normal ") + std::to_string(size.x) + "x" + std::to_string(size.y);
+            } else if (item.action == OptionAction::TOGGLE_ARENA) {
+                item.text = "Arena: " + (arenaEnabled ? std::to_string(Config::ARENA_SNAKE_COUNT) + " snakes" : std::string("Off"));
             }
         }
+        ++uiRevision;
     }
 
-    SDL_Point Game::calculateStartPosition() const {
-        int startGridX = std::max(0, (screenWidth / cellSize) / 2);
-        int startGridY = std::max(0, (screenHeight / cellSize) / 2);
-        return {startGridX * cellSize, startGridY * cellSize};
-    }
-
-    void Game::handleInput(const SDL_Event& event) {
+    void Game::handleInput(const SDL_Event& event, std::uint64_t polledAt) {
+        markDirty(); // Mọi sự kiện (phím, chuột, cửa sổ bị che/hiện lại) có thể làm đổi frame
+        currentInputStamp = polledAt;
         if (event.type == SDL_QUIT) {
             quitRequested = true;
             std::cout << "Quit requested via window close button." << std::endl;
             return;
         }
 
+        if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+            staticLayer.invalidate(); // Nội dung render target bị mất, nướng lại ở frame sau
+            return;
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3) {
+            showLatencyOverlay = !showLatencyOverlay;
+            return;
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F12) {
+            if (capture) stopCapture();
+            else startCapture(Config::CAPTURE_DIRECTORY + "/vorax_" + std::to_string(std::time(nullptr)) + ".y4m", false);
+            return;
+        }
+
         if (currentState == GameState::EnteringHighScore) {
             handleHighScoreInput(event);
             return;
@@ -150,6 +230,18 @@ namespace SnakeGame {
             return;
         }
 
+        if (event.type == SDL_KEYDOWN && !arena && (event.key.keysym.sym == SDLK_F5 || event.key.keysym.sym == SDLK_F9) &&
+            (currentState == GameState::Playing || currentState == GameState::Paused || currentState == GameState::GameOver)) {
+            if (event.key.keysym.sym == SDLK_F5) quickSave(); else quickLoad();
+            return;
+        }
+
+        if (event.type == SDL_KEYDOWN && !arena && event.key.keysym.sym == SDLK_F2 &&
+            (currentState == GameState::Playing || currentState == GameState::Paused)) {
+            cycleAutopilot();
+            return;
+        }
+
         Config::ControlInput control = Config::handleRawInput(event);
 
         switch (currentState) {
@@ -158,6 +250,7 @@ namespace SnakeGame {
             case GameState::Playing:         handlePlayingInput(event, control);  break;
             case GameState::Paused:          handlePausedInput(event, control);   break;
             case GameState::GameOver:        handleGameOverInput(event, control); break;
+            case GameState::ReplayViewer:    handleReplayViewerInput(event, control); break;
             case GameState::EnteringHighScore: break;
         }
     }
@@ -166,7 +259,7 @@ namespace SnakeGame {
         if (event.type == SDL_KEYDOWN) {
             if (event.key.keysym.sym == SDLK_RETURN || event.key.keysym.sym == SDLK_KP_ENTER) {
                 if (!currentPlayerNameInput.empty()) {
-                    addHighScore(currentPlayerNameInput, score);
+                    addHighScore(currentPlayerNameInput, getScore());
                     saveHighScores();
                     currentState = GameState::GameOver;
                     if(isEnteringName) SDL_StopTextInput();
@@ -177,6 +270,10 @@ namespace SnakeGame {
                 }
             }
             else if (event.key.keysym.sym == SDLK_BACKSPACE && !currentPlayerNameInput.empty()) {
+                // Xóa cả ký tự UTF-8 cuối (các byte tiếp nối 10xxxxxx rồi byte đầu)
+                while (currentPlayerNameInput.size() > 1 && (static_cast<unsigned char>(currentPlayerNameInput.back()) & 0xC0) == 0x80) {
+                    currentPlayerNameInput.pop_back();
+                }
                 currentPlayerNameInput.pop_back();
             }
             else if (event.key.keysym.sym == SDLK_ESCAPE) {
@@ -187,8 +284,10 @@ namespace SnakeGame {
             }
         }
         else if (event.type == SDL_TEXTINPUT) {
-            if (currentPlayerNameInput.length() < 15 && !(SDL_GetModState() & KMOD_CTRL) &&
-                event.text.text[0] >= ' ' && event.text.text[0] <= '~')
+            // Nhận mọi ký tự in được, kể cả chữ có dấu (UTF-8 nhiều byte); giới hạn tính theo ký tự, không theo byte
+            const auto first = static_cast<unsigned char>(event.text.text[0]);
+            if (utf8Length(currentPlayerNameInput) + utf8Length(event.text.text) <= Config::PLAYER_NAME_MAX_LENGTH &&
+                !(SDL_GetModState() & KMOD_CTRL) && first >= ' ' && first != 0x7F)
             {
                 currentPlayerNameInput += event.text.text;
             }
@@ -224,6 +323,12 @@ namespace SnakeGame {
                 isEnteringName = false;
                 std::cout << "High score entry cancelled via ESC. Returning to Game Over screen." << std::endl;
                 break;
+            case GameState::ReplayViewer:
+                currentState = GameState::MainMenu;
+                selectedButtonIndex = 0;
+                replayViewer.reset();
+                std::cout << "Closing replay viewer." << std::endl;
+                break;
             case GameState::MainMenu:
                 quitRequested = true;
                 std::cout << "Quit requested via Escape from Main Menu." << std::endl;
@@ -304,6 +409,7 @@ namespace SnakeGame {
                     selectedOptionIndex = 0;
                     updateOptionTexts();
                     for(auto& rect : optionsMenuItemRects) { rect = {0,0,0,0}; }
+                    optionsUi.invalidate();
                     std::cout << "Entering Options..." << std::endl;
                 }
             }
@@ -387,9 +493,20 @@ namespace SnakeGame {
                 if (eatSound) Mix_VolumeChunk(eatSound.get(), soundEnabled ? MIX_MAX_VOLUME / 2 : 0);
                 updateOptionTexts();
                 break;
+            case OptionAction::TOGGLE_BOARD_SIZE:
+                hugeBoard = !hugeBoard;
+                std::cout << "Board size toggled to " << (hugeBoard ? "Huge" : "Normal") << " (applies to the next game)." << std::endl;
+                updateOptionTexts();
+                break;
+            case OptionAction::TOGGLE_ARENA:
+                arenaEnabled = !arenaEnabled;
+                std::cout << "Arena mode toggled " << (arenaEnabled ? "ON" : "OFF") << " (applies to the next game)." << std::endl;
+                updateOptionTexts();
+                break;
             case OptionAction::RESET_HIGHSCORES:
                 std::cout << "Resetting high scores." << std::endl;
                 highScores.clear();
+                ++uiRevision;
                 saveHighScores();
                 break;
             case OptionAction::GOTO_MAINMENU:
@@ -419,7 +536,7 @@ namespace SnakeGame {
             timeAccumulator = 0.0f;
             std::cout << "Game Paused" << std::endl;
         } else {
-            Direction requestedDir = snake.getCurrentDirection();
+            Direction requestedDir = arena ? arena->getSnake(0).getCurrentDirection() : simulation.getSnake().getCurrentDirection();
             bool directionInput = false;
             switch (control) {
                 case Config::ControlInput::UP:    requestedDir = Direction::UP; directionInput = true; break;
@@ -429,7 +546,16 @@ namespace SnakeGame {
                 default: break;
             }
             if (directionInput) {
-                snake.queueDirectionChange(requestedDir);
+                if (arena) {
+                    arena->queueDirection(0, requestedDir, currentInputStamp);
+                } else {
+                    if (autopilotMode != AutopilotMode::Off) { // Người chơi cầm lái lại
+                        autopilotMode = AutopilotMode::Off;
+                        std::cout << "Autopilot disabled." << std::endl;
+                    }
+                    simulation.queueDirection(requestedDir, currentInputStamp);
+                    recordReplayInput(replayInputFor(requestedDir));
+                }
             }
         }
     }
@@ -446,18 +572,50 @@ namespace SnakeGame {
         if (control == Config::ControlInput::RESTART) {
             std::cout << "Restarting game..." << std::endl;
             reset();
+        } else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_r && !arena && replay.getHeader().finalTick > 0) {
+            startReplayViewer(replay);
+        }
+    }
+
+    void Game::handleReplayViewerInput(const SDL_Event& event, Config::ControlInput control) {
+        if (!replayViewer) return;
+        if (control == Config::ControlInput::RESTART || control == Config::ControlInput::PAUSE) {
+            replayViewerPaused = !replayViewerPaused;
+            timeAccumulator = 0.0f;
+            return;
+        }
+        if (event.type != SDL_KEYDOWN) return;
+
+        const std::uint64_t tick = replayViewer->getTick();
+        const std::uint64_t stride = static_cast<std::uint64_t>(Config::REPLAY_SEEK_TICKS) * ((SDL_GetModState() & KMOD_SHIFT) ? 10 : 1);
+        std::uint64_t target = tick;
+        switch (event.key.keysym.sym) {
+            case SDLK_LEFT:  target = tick > stride ? tick - stride : 0; break;
+            case SDLK_RIGHT: target = tick + stride; break;
+            case SDLK_HOME:  target = 0; break;
+            case SDLK_END:   target = replayViewer->getHeader().finalTick; break;
+            default: return;
         }
+        replayViewer->seek(target);
+        previousSnakeBody.clear(); // Tua là nhảy, không nội suy
+        timeAccumulator = 0.0f;
     }
 
     void Game::runFrame(float deltaTime) {
-        handleBoosting(deltaTime);
+        handleBoosting();
+        if (capture) markDirty(); // Bản ghi cần frame đều đặn kể cả khi màn hình đứng yên
+
+        if (currentState == GameState::EnteringHighScore) {
+            const bool blinkOn = (SDL_GetTicks() / Config::CURSOR_BLINK_MS) % 2 == 0;
+            if (blinkOn != cursorBlinkOn) { cursorBlinkOn = blinkOn; markDirty(); }
+        }
+
+        if (currentState == GameState::ReplayViewer) {
+            advanceReplayViewer(deltaTime);
+            return;
+        }
 
         if (currentState != GameState::Playing) {
-            if (isBoosting) {
-                isBoosting = false;
-                boostCostTimer = 0.0f;
-                boostCostCycles = 0;
-            }
             if (currentState != GameState::EnteringHighScore) {
                 timeAccumulator = 0.0f;
             }
@@ -465,442 +623,578 @@ namespace SnakeGame {
         }
 
         timeAccumulator += deltaTime;
-        Uint32 currentRequiredInterval = isBoosting ? Config::BOOST_MOVE_INTERVAL_MS : moveInterval;
-        const float timeStep = static_cast<float>(currentRequiredInterval) / 1000.0f;
+        if (!arena) markDirty(); // Rắn được vẽ nội suy giữa hai bước nên mỗi frame đều khác
 
-        while (timeAccumulator >= timeStep && timeStep > 0.0f) {
+        while (currentState == GameState::Playing) {
+            const int intervalMs = arena ? Config::ARENA_MOVE_INTERVAL_MS : simulation.stepIntervalMs();
+            const float timeStep = static_cast<float>(intervalMs) / 1000.0f;
+            if (timeStep <= 0.0f || timeAccumulator < timeStep) break;
+
+            if (!arena) capturePreviousPose(simulation);
             update();
+            markDirty();
 
-            if(currentState != GameState::Playing) {
+            if (currentState != GameState::Playing) {
                 timeAccumulator = 0.0f;
-                if (isBoosting) { isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0;}
                 break;
             }
+            timeAccumulator -= timeStep;
+        }
+    }
 
-            updateObstacles();
-
-            if (checkObstacleCollision(snake.getHeadPosition())) {
-                std::cout << "Collision! Game Over. Reason: Obstacle moved into snake head." << std::endl;
-                PlaySoundEffect(collisionSound.get(), soundEnabled);
-                PlaySoundEffect(gameOverSound.get(), soundEnabled);
-                if (isHighScore(score)) { currentState = GameState::EnteringHighScore; currentPlayerNameInput = ""; if(!isEnteringName) SDL_StartTextInput(); isEnteringName = true; }
-                else { currentState = GameState::GameOver; if(isEnteringName) SDL_StopTextInput(); isEnteringName = false; }
-                timeAccumulator = 0.0f; if (isBoosting) { isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0;}
-                break;
+    int Game::idleWaitMs() const {
+        if (capture) return 0;
+        switch (currentState) {
+            case GameState::Playing: {
+                if (!arena) return 0; // Rắn vẽ nội suy và phím Shift được đọc mỗi frame
+                const float untilTick = static_cast<float>(Config::ARENA_MOVE_INTERVAL_MS) - timeAccumulator * 1000.0f;
+                return std::max(0, static_cast<int>(untilTick));
             }
-            const auto& snakeBody = snake.getBody();
-            bool bodyCollision = false;
-            for(const auto& obs : obstacles) {
-                for(size_t i = 1; i < snakeBody.size(); ++i) {
-                    if (obs.position.x == snakeBody[i].x && obs.position.y == snakeBody[i].y) {
-                        bodyCollision = true; break;
-                    }
-                } if (bodyCollision) break;
-            }
-            if (bodyCollision) {
-                std::cout << "Collision! Game Over. Reason: Obstacle moved into snake body." << std::endl;
-                PlaySoundEffect(collisionSound.get(), soundEnabled);
-                PlaySoundEffect(gameOverSound.get(), soundEnabled);
-                if (isHighScore(score)) { currentState = GameState::EnteringHighScore; currentPlayerNameInput = ""; if(!isEnteringName) SDL_StartTextInput(); isEnteringName = true; }
-                else { currentState = GameState::GameOver; if(isEnteringName) SDL_StopTextInput(); isEnteringName = false; }
-                timeAccumulator = 0.0f; if (isBoosting) { isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0;}
+            case GameState::ReplayViewer:
+                if (replayViewer && !replayViewerPaused && !replayViewer->atEnd()) return 0;
+                return Config::IDLE_WAIT_MAX_MS;
+            case GameState::EnteringHighScore:
+                return static_cast<int>(Config::CURSOR_BLINK_MS - SDL_GetTicks() % Config::CURSOR_BLINK_MS); // Tới lần đổi pha con trỏ
+            case GameState::MainMenu:
+            case GameState::Options:
+            case GameState::Paused:
+            case GameState::GameOver:
                 break;
-            }
+        }
+        return Config::IDLE_WAIT_MAX_MS;
+    }
 
-            timeAccumulator -= timeStep;
+    void Game::capturePreviousPose(const Simulation& sim) {
+        const auto& body = sim.getSnake().getBody();
+        previousSnakeBody.assign(body.begin(), body.end());
+    }
 
-            if (isBoosting && (score <= 0 || snake.getBody().size() <= Config::MIN_BOOST_LENGTH)) {
-                isBoosting = false;
-                boostCostTimer = 0.0f;
-                boostCostCycles = 0;
-                std::cout << "Boost stopped mid-step due to low score/length." << std::endl;
-                currentRequiredInterval = moveInterval;
+    float Game::interpolationAlpha() const {
+        const Simulation* stepping = nullptr;
+        if (currentState == GameState::Playing && !arena) stepping = &simulation;
+        else if (currentState == GameState::ReplayViewer && replayViewer && !replayViewerPaused && !replayViewer->atEnd()) stepping = &replayViewer->getSimulation();
+        if (!stepping || previousSnakeBody.empty()) return 1.0f;
+        const float timeStep = static_cast<float>(stepping->stepIntervalMs()) / 1000.0f;
+        if (timeStep <= 0.0f) return 1.0f;
+        return std::clamp(timeAccumulator / timeStep, 0.0f, 1.0f);
+    }
+
+    SDL_FPoint Game::interpolatedHeadPosition() const {
+        const Point head = viewedSimulation().getSnake().getHeadPosition();
+        SDL_FPoint position = {static_cast<float>(head.x), static_cast<float>(head.y)};
+        const float alpha = interpolationAlpha();
+        if (alpha < 1.0f && !previousSnakeBody.empty()) {
+            const Point from = previousSnakeBody.front();
+            if (std::abs(head.x - from.x) + std::abs(head.y - from.y) == 1) { // Không nội suy qua cạnh wrap
+                position.x -= static_cast<float>(head.x - from.x) * (1.0f - alpha);
+                position.y -= static_cast<float>(head.y - from.y) * (1.0f - alpha);
             }
         }
+        return position;
     }
 
-    void Game::handleBoosting(float deltaTime) {
-        if (currentState != GameState::Playing) {
-            if (isBoosting) { isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0; }
-            return;
+    void Game::handleBoosting() {
+        bool wasBoosting = simulation.isBoosting();
+        const bool wasHeld = boostHeld;
+        if (currentState != GameState::Playing || arena) {
+            boostHeld = false;
+        } else {
+            const Uint8* currentKeyStates = SDL_GetKeyboardState(nullptr);
+            boostHeld = currentKeyStates[SDL_SCANCODE_LSHIFT] || currentKeyStates[SDL_SCANCODE_RSHIFT];
+        }
+        if (boostHeld != wasHeld) recordReplayInput(boostHeld ? ReplayInput::BoostOn : ReplayInput::BoostOff);
+        simulation.setBoostRequested(boostHeld);
+
+        if (wasBoosting != simulation.isBoosting()) markDirty();
+        if (!wasBoosting && simulation.isBoosting()) {
+            std::cout << "Boost started." << std::endl;
+        } else if (wasBoosting && !simulation.isBoosting()) {
+            std::cout << "Boost stopped (Shift released or conditions unmet)." << std::endl;
         }
+    }
 
-        const Uint8* currentKeyStates = SDL_GetKeyboardState(nullptr);
-        bool shiftPressed = currentKeyStates[SDL_SCANCODE_LSHIFT] || currentKeyStates[SDL_SCANCODE_RSHIFT];
-        bool canBoost = shiftPressed && score > 0 && snake.getBody().size() > Config::MIN_BOOST_LENGTH;
+    void Game::update() {
+        if (currentState != GameState::Playing) return;
+        if (arena) {
+            updateArena();
+            return;
+        }
 
-        if (canBoost) {
-            if (!isBoosting) {
-                isBoosting = true; boostCostTimer = 0.0f; boostCostCycles = 0;
-                std::cout << "Boost started." << std::endl;
+        if (autopilotMode != AutopilotMode::Off) {
+            const Direction current = simulation.getSnake().getCurrentDirection();
+            const Direction chosen = autopilotMode == AutopilotMode::AStar ? autopilot.chooseDirection(simulation)
+                                                                          : lookahead.chooseDirection(simulation);
+            if (chosen != current) {
+                simulation.queueDirection(chosen);
+                recordReplayInput(replayInputFor(chosen));
             }
+        }
 
-            boostCostTimer += deltaTime;
-            const float costIntervalSeconds = static_cast<float>(Config::BOOST_COST_INTERVAL_MS) / 1000.0f;
-
-            while (isBoosting && boostCostTimer >= costIntervalSeconds) {
-                boostCostTimer -= costIntervalSeconds;
+        bool wasBoosting = simulation.isBoosting();
+        StepResult result = simulation.step({std::nullopt, boostHeld});
+        inputLatency.onInputApplied(simulation.getSnake().getAppliedInputStamp(), SDL_GetPerformanceCounter());
+        if (recordingReplay && !result.gameOver && replay.wantsKeyframe(simulation.getTick())) {
+            replay.captureKeyframe(simulation, boostHeld);
+        }
 
-                if (score > 0 && snake.getBody().size() > Config::MIN_BOOST_LENGTH) {
-                    score -= Config::BOOST_SCORE_COST;
-                    if (score < 0) score = 0;
+        if (result.gameOver) {
+            handleGameOver(result.cause);
+            return;
+        }
 
-                    boostCostCycles++;
-                    if (boostCostCycles >= Config::BOOST_LENGTH_COST_INTERVALS) {
-                        boostCostCycles = 0;
-                        if (snake.getBody().size() > Config::MIN_BOOST_LENGTH) {
-                            snake.shrink();
-                            std::cout << "Shrunk due to boost. New length: " << snake.getBody().size() << std::endl;
-                        } else {
-                            // PlaySoundEffect(boostEndSound.get(), soundEnabled); // Bỏ âm thanh dừng boost
-                            isBoosting = false; std::cout << "Boost stopped: Cannot shrink further." << std::endl; boostCostTimer = 0.0f;
-                        }
-                    }
-                    if (score <= 0 || snake.getBody().size() <= Config::MIN_BOOST_LENGTH) {
-                        // PlaySoundEffect(boostEndSound.get(), soundEnabled); // Bỏ âm thanh dừng boost
-                        isBoosting = false; std::cout << "Boost stopped due to running out of score/length." << std::endl; boostCostTimer = 0.0f;
-                    }
-                } else {
-                    // PlaySoundEffect(boostEndSound.get(), soundEnabled); // Bỏ âm thanh dừng boost
-                    isBoosting = false; std::cout << "Boost stopped: Conditions not met before applying cost." << std::endl; boostCostTimer = 0.0f;
-                }
-            }
-        } else {
-            if (isBoosting) {
-                // PlaySoundEffect(boostEndSound.get(), soundEnabled); // Bỏ âm thanh dừng boost
-                isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0;
-                std::cout << "Boost stopped (Shift released or conditions unmet)." << std::endl;
+        if (result.ateFood) {
+            PlaySoundEffect(eatSound.get(), soundEnabled);
+            std::cout << "Ate food. Score: " << simulation.getScore() << ", New speed interval: " << simulation.getMoveInterval() << "ms" << std::endl;
+            if (result.obstacleAdded) {
+                std::cout << "Added new obstacle at score " << simulation.getScore() << "." << std::endl;
             }
         }
+        if (result.shrunkByBoost) {
+            std::cout << "Shrunk due to boost. New length: " << simulation.getSnake().getBody().size() << std::endl;
+        }
+        if (wasBoosting && !simulation.isBoosting()) {
+            std::cout << "Boost stopped due to running out of score/length." << std::endl;
+        }
     }
 
-    void Game::update() {
-        if (currentState != GameState::Playing) return;
+    void Game::recordReplayInput(ReplayInput input) {
+        if (recordingReplay) replay.record(simulation.getTick(), input);
+    }
 
-        SDL_Point nextHeadPos = snake.calculateNextHeadPosition();
+    void Game::finishReplay() {
+        if (!recordingReplay) return;
+        recordingReplay = false;
+        if (simulation.getTick() == 0) return; // Ván chưa chạy bước nào: không cần lưu
+        replay.finish(simulation.getTick(), simulation.getScore(), simulation.isGameOver());
+
+        std::error_code error;
+        std::filesystem::create_directories(Config::REPLAY_DIRECTORY, error);
+        // Tên gồm seed, chế độ và thời điểm; thêm hậu tố đếm nếu trùng để không bao giờ ghi đè replay cũ
+        const std::string base = Config::REPLAY_DIRECTORY + "/vorax_" + std::to_string(replay.getHeader().seed) + "_" +
+                                 (replay.getHeader().mode == GameMode::Classic ? "classic" : "portal") + "_" + std::to_string(std::time(nullptr));
+        std::string path = base + ".vxr";
+        for (int suffix = 1; std::filesystem::exists(path, error); ++suffix) {
+            path = base + "_" + std::to_string(suffix) + ".vxr";
+        }
+        if (replay.saveToFile(path)) {
+            std::cout << "Replay saved: " << path << " (" << replay.getEventCount() << " events, "
+                      << replay.serialize().size() << " bytes)." << std::endl;
+        }
+    }
 
-        bool wallCollision = false;
-        if (currentGameMode == GameMode::Classic) {
-            wallCollision = (nextHeadPos.x < 0 || nextHeadPos.x >= screenWidth ||
-                             nextHeadPos.y < 0 || nextHeadPos.y >= screenHeight);
-        } else {
-            if (nextHeadPos.x < 0) nextHeadPos.x = screenWidth - cellSize;
-            else if (nextHeadPos.x >= screenWidth) nextHeadPos.x = 0;
-            if (nextHeadPos.y < 0) nextHeadPos.y = screenHeight - cellSize;
-            else if (nextHeadPos.y >= screenHeight) nextHeadPos.y = 0;
-            wallCollision = false;
+    void Game::quickSave() {
+        if (currentState == GameState::GameOver) return;
+        simulation.saveState(quickSaveState);
+        std::cout << "Quick saved at tick " << simulation.getTick() << " (" << quickSaveState.size() << " bytes)." << std::endl;
+    }
+
+    void Game::quickLoad() {
+        if (quickSaveState.empty()) return;
+        finishReplay(); // Dòng input sau khi tải không còn khớp với ván bắt đầu từ seed
+        if (!simulation.loadState(quickSaveState.data(), quickSaveState.size())) {
+            quickSaveState.clear();
+            reset();
+            return;
+        }
+        autopilot.reset();
+        previousSnakeBody.clear();
+        currentState = GameState::Paused;
+        timeAccumulator = 0.0f;
+        std::cout << "Quick loaded tick " << simulation.getTick() << " (score " << simulation.getScore() << ")." << std::endl;
+    }
+
+    void Game::cycleAutopilot() {
+        switch (autopilotMode) {
+            case AutopilotMode::Off:       autopilotMode = AutopilotMode::AStar; break;
+            case AutopilotMode::AStar:     autopilotMode = AutopilotMode::Lookahead; break;
+            case AutopilotMode::Lookahead: autopilotMode = AutopilotMode::Off; break;
         }
+        autopilot.reset();
+        static const char* const NAMES[] = {"disabled.", "enabled (A*).", "enabled (lookahead search)."};
+        std::cout << "Autopilot " << NAMES[static_cast<int>(autopilotMode)] << std::endl;
+    }
 
-        bool obstacleCollision = checkObstacleCollision(nextHeadPos);
-        bool selfCollision = snake.checkSelfCollisionWithNext(nextHeadPos);
+    bool Game::openReplay(const std::string& path) {
+        Replay loaded;
+        if (!loaded.loadFromFile(path)) return false;
+        std::cout << "Opened replay " << path << " (seed " << loaded.getHeader().seed << ", " << loaded.getHeader().finalTick << " ticks)." << std::endl;
+        startReplayViewer(loaded);
+        return true;
+    }
 
-        if (wallCollision || obstacleCollision || selfCollision) {
-            std::cout << "Collision! Game Over. Reason: ";
-            if (wallCollision) std::cout << "Wall (Classic Mode).";
-            else if (obstacleCollision) std::cout << "Obstacle (Hit by snake).";
-            else if (selfCollision) std::cout << "Self.";
-            std::cout << " Final Score: " << score << std::endl;
-            if (isBoosting) { isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0;}
+    void Game::startReplayViewer(const Replay& source) {
+        finishReplay();
+        arena.reset();
+        replayViewer = std::make_unique<ReplayPlayer>(source);
+        replayViewer->buildKeyframes();
+        currentState = GameState::ReplayViewer;
+        replayViewer->setGridChangeTracking(boardExceedsViewport());
+        replayViewerPaused = false;
+        previousSnakeBody.clear();
+        timeAccumulator = 0.0f;
+        std::cout << "Replay viewer: " << replayViewer->getKeyframeCount() << " keyframes." << std::endl;
+    }
 
-            PlaySoundEffect(collisionSound.get(), soundEnabled);
-            PlaySoundEffect(gameOverSound.get(), soundEnabled);
+    void Game::advanceReplayViewer(float deltaTime) {
+        if (!replayViewer || replayViewerPaused || replayViewer->atEnd()) {
+            timeAccumulator = 0.0f;
+            return;
+        }
+        timeAccumulator += deltaTime;
+        markDirty(); // Rắn được vẽ nội suy giữa hai bước nên mỗi frame đều khác
+        for (;;) {
+            const float timeStep = static_cast<float>(replayViewer->getSimulation().stepIntervalMs()) / 1000.0f;
+            if (timeStep <= 0.0f || timeAccumulator < timeStep) break;
+            capturePreviousPose(replayViewer->getSimulation());
+            if (!replayViewer->step()) break;
+            timeAccumulator -= timeStep;
+        }
+    }
 
-            if (isHighScore(score)) { currentState = GameState::EnteringHighScore; currentPlayerNameInput = ""; if(!isEnteringName) SDL_StartTextInput(); isEnteringName = true; }
-            else { currentState = GameState::GameOver; if(isEnteringName) SDL_StopTextInput(); isEnteringName = false; }
+    void Game::updateArena() {
+        arena->step();
+        inputLatency.onInputApplied(arena->getSnake(0).getAppliedInputStamp(), SDL_GetPerformanceCounter());
+        const ArenaEvent& event = arena->getEvent(0);
+        if (event.died) {
+            handleGameOver(event.cause);
             return;
         }
+        if (event.ateFood) {
+            PlaySoundEffect(eatSound.get(), soundEnabled);
+            std::cout << "Ate food. Score: " << arena->getScore(0) << ", Snakes alive: " << arena->getAliveCount() << std::endl;
+        }
+    }
 
-        snake.move(nextHeadPos);
+    void Game::handleGameOver(CollisionCause cause) {
+        std::cout << "Collision! Game Over. Reason: ";
+        switch (cause) {
+            case CollisionCause::Wall:             std::cout << "Wall (Classic Mode)."; break;
+            case CollisionCause::Obstacle:         std::cout << "Obstacle (Hit by snake)."; break;
+            case CollisionCause::Self:             std::cout << "Self."; break;
+            case CollisionCause::ObstacleIntoHead: std::cout << "Obstacle moved into snake head."; break;
+            case CollisionCause::ObstacleIntoBody: std::cout << "Obstacle moved into snake body."; break;
+            case CollisionCause::OtherSnake:       std::cout << "Another snake's body."; break;
+            case CollisionCause::HeadOn:           std::cout << "Head-on collision with another snake."; break;
+            case CollisionCause::None:             break;
+        }
+        std::cout << " Final Score: " << getScore() << std::endl;
 
-        if (snake.checkFoodCollision(food.getPosition())) {
-            PlaySoundEffect(eatSound.get(), soundEnabled);
-            score++;
-            snake.grow();
-            placeFood();
-            increaseSpeed();
-            std::cout << "Ate food. Score: " << score << ", New speed interval: " << moveInterval << "ms" << std::endl;
-
-            if (score >= nextObstacleScoreThreshold) {
-                if (addSingleObstacle()) {
-                    std::cout << "Added new obstacle at score " << score << "." << std::endl;
-                    nextObstacleScoreThreshold += Config::OBSTACLE_ADD_SCORE_INTERVAL;
-                } else {
-                    nextObstacleScoreThreshold += Config::OBSTACLE_ADD_SCORE_INTERVAL;
-                }
-            }
+        finishReplay();
+        PlaySoundEffect(collisionSound.get(), soundEnabled);
+        PlaySoundEffect(gameOverSound.get(), soundEnabled);
+
+        if (isHighScore(getScore())) {
+            currentState = GameState::EnteringHighScore;
+            currentPlayerNameInput = "";
+            if (!isEnteringName) SDL_StartTextInput();
+            isEnteringName = true;
+        } else {
+            currentState = GameState::GameOver;
+            if (isEnteringName) SDL_StopTextInput();
+            isEnteringName = false;
         }
     }
 
-    void Game::render(Renderer& renderer) {
+    bool Game::render(Renderer& renderer) {
+        if (renderedGeneration == frameGeneration) return false;
+        renderedGeneration = frameGeneration;
         renderer.clear();
         switch (currentState) {
             case GameState::MainMenu:        renderMainMenu(renderer);       break;
             case GameState::Options:         renderOptions(renderer);        break;
             case GameState::Playing:
             case GameState::Paused:
-            case GameState::GameOver:        renderGameScreen(renderer);     break;
+            case GameState::GameOver:
+            case GameState::ReplayViewer:
+                if (arena) {
+                    if (arena->isAlive(0)) camera.follow(arena->getSnake(0).getHeadPosition(), arena->getBoardWidth(), arena->getBoardHeight());
+                } else {
+                    const Simulation& viewed = viewedSimulation();
+                    const SDL_FPoint head = interpolatedHeadPosition();
+                    camera.follow(head.x, head.y, viewed.getBoardWidth(), viewed.getBoardHeight(), cellSize);
+                }
+                if (boardExceedsViewport()) {
+                    minimap.refresh(renderer, activeGrid());
+                    if (arena) arena->clearGridChanges();
+                    else if (currentState == GameState::ReplayViewer) replayViewer->clearGridChanges();
+                    else simulation.clearGridChanges();
+                }
+                staticLayer.refresh(renderer, backgroundTexture.get(), arena ? nullptr : &viewedSimulation(), camera, cellSize, screenWidth, screenHeight);
+                renderGameScreen(renderer);
+                renderOverlay(renderer);
+                break;
             case GameState::EnteringHighScore: renderHighScoreEntry(renderer); break;
         }
+        if (showLatencyOverlay) renderLatencyOverlay(renderer);
+        if (capture) captureFrame(renderer);
         renderer.present();
+        inputLatency.onPresent(SDL_GetPerformanceCounter());
+        return true;
     }
 
-    void Game::renderMainMenu(Renderer& renderer) const {
-        if (menuTexture) {
-            SDL_Rect destRect = {0, 0, screenWidth, screenHeight};
-            renderer.drawTexture(menuTexture.get(), &destRect);
-            if (!menuButtons.empty() && selectedButtonIndex >= 0 && selectedButtonIndex < static_cast<int>(menuButtons.size())) {
-                SDL_Rect highlightRect = menuButtons[selectedButtonIndex].screenRect;
-                highlightRect.x -= 5; highlightRect.y -= 5; highlightRect.w += 10; highlightRect.h += 10;
-                renderer.drawRect(&highlightRect, Config::MENU_HIGHLIGHT_COLOR, false);
-            }
+    void Game::renderLatencyOverlay(Renderer& renderer) const {
+        std::ostringstream text;
+        const SampleStats stats = inputLatency.recentStats();
+        if (stats.count == 0) {
+            text << "Input -> present: no samples yet";
         } else {
-            renderer.clear();
-            renderer.renderCenteredText("Vorax Serpens", screenWidth, screenHeight / 4, Config::TEXT_COLOR);
-            int btnY = screenHeight / 2; int spacing = Config::FONT_SIZE * 2;
-            for(size_t i=0; i < menuButtons.size(); ++i) {
-                SDL_Color c = (static_cast<int>(i) == selectedButtonIndex) ? Config::MENU_HIGHLIGHT_COLOR : Config::TEXT_COLOR;
-                renderer.renderCenteredText(menuButtons[i].debugText, screenWidth, btnY + i * spacing, c);
-            }
+            text << std::fixed << std::setprecision(1) << "Input -> present p50 " << stats.p50 << " | p95 " << stats.p95
+                 << " | p99 " << stats.p99 << " ms (" << stats.count << ")";
         }
-        const int highScoreX = 20; const int highScoreY = 50;
-        renderer.renderText("High Scores:", highScoreX, highScoreY, Config::TEXT_COLOR);
-        int hs_y = highScoreY + Config::FONT_SIZE + 5; int rank = 1;
-        for(const auto& entry : highScores) {
-            std::string text = std::to_string(rank) + ". " + entry.name + ": " + std::to_string(entry.score);
-            renderer.renderText(text, highScoreX, hs_y, Config::TEXT_COLOR);
-            hs_y += Config::FONT_SIZE + 2; rank++;
-            if (rank > maxHighScores) break;
+        renderer.renderText(text.str(), 10, screenHeight - Config::FONT_SIZE - 10, Config::TEXT_COLOR);
+    }
+
+    void Game::renderMainMenu(Renderer& renderer) {
+        const std::uint64_t key = (static_cast<std::uint64_t>(uiRevision) << 32) | static_cast<std::uint32_t>(selectedButtonIndex);
+        if (!mainMenuUi.isCurrent(key)) {
+            mainMenuUi.begin(key);
+            if (menuTexture) {
+                mainMenuUi.addTexture(menuTexture.get(), {0, 0, screenWidth, screenHeight});
+                if (!menuButtons.empty() && selectedButtonIndex >= 0 && selectedButtonIndex < static_cast<int>(menuButtons.size())) {
+                    SDL_Rect highlightRect = menuButtons[selectedButtonIndex].screenRect;
+                    highlightRect.x -= 5; highlightRect.y -= 5; highlightRect.w += 10; highlightRect.h += 10;
+                    mainMenuUi.addRect(highlightRect, Config::MENU_HIGHLIGHT_COLOR, false);
+                }
+            } else {
+                mainMenuUi.addCenteredText(renderer, "Vorax Serpens", screenWidth, screenHeight / 4, Config::TEXT_COLOR);
+                int btnY = screenHeight / 2; int spacing = Config::FONT_SIZE * 2;
+                for(size_t i=0; i < menuButtons.size(); ++i) {
+                    SDL_Color c = (static_cast<int>(i) == selectedButtonIndex) ? Config::MENU_HIGHLIGHT_COLOR : Config::TEXT_COLOR;
+                    mainMenuUi.addCenteredText(renderer, menuButtons[i].debugText, screenWidth, btnY + static_cast<int>(i) * spacing, c);
+                }
+            }
+            const int highScoreX = 20; const int highScoreY = 50;
+            mainMenuUi.addText(renderer, "High Scores:", highScoreX, highScoreY, Config::TEXT_COLOR);
+            int hs_y = highScoreY + Config::FONT_SIZE + 5; int rank = 1;
+            for(const auto& entry : highScores) {
+                std::string text = std::to_string(rank) + ". " + entry.name + ": " + std::to_string(entry.score);
+                mainMenuUi.addText(renderer, text, highScoreX, hs_y, Config::TEXT_COLOR);
+                hs_y += Config::FONT_SIZE + 2; rank++;
+                if (rank > maxHighScores) break;
+            }
         }
+        mainMenuUi.draw(renderer);
     }
 
     void Game::renderOptions(Renderer& renderer) {
-        if (backgroundTexture) { SDL_Rect destRect = {0, 0, screenWidth, screenHeight}; renderer.drawTexture(backgroundTexture.get(), &destRect); }
-        else { renderer.clear(); }
-        renderer.renderCenteredText("OPTIONS", screenWidth, screenHeight / 5, Config::TEXT_COLOR);
-        int startY = screenHeight / 3; int y_offset = Config::FONT_SIZE * 2 + 10;
-        if (optionsMenuItemRects.size() != optionsMenuItems.size()) { optionsMenuItemRects.resize(optionsMenuItems.size()); }
-        for (size_t i = 0; i < optionsMenuItems.size(); ++i) {
-            const auto& item = optionsMenuItems[i];
-            SDL_Color color = (static_cast<int>(i) == selectedOptionIndex) ? Config::OPTIONS_HIGHLIGHT_COLOR : Config::OPTIONS_TEXT_COLOR;
-            std::string displayText = item.text;
-            if (item.action == OptionAction::TOGGLE_MODE || item.action == OptionAction::TOGGLE_SOUND) { displayText = "< " + displayText + " >"; }
-            SDL_Point textSize = renderer.getTextSize(displayText);
-            SDL_Rect& currentRect = optionsMenuItemRects[i];
-            currentRect.w = textSize.x; currentRect.h = textSize.y;
-            currentRect.x = (screenWidth - currentRect.w) / 2; currentRect.y = startY + i * y_offset;
-            renderer.renderText(displayText, currentRect.x, currentRect.y, color);
-        }
-        renderer.renderCenteredText("Controls: W/A/S/D or Arrows to Move. Eat food to Grow.", screenWidth, screenHeight - Config::FONT_SIZE * 6, Config::TEXT_COLOR);
-        renderer.renderCenteredText("Objective: Avoid walls (Classic), obstacles, and self. Survive!", screenWidth, screenHeight - Config::FONT_SIZE * 5, Config::TEXT_COLOR);
-        renderer.renderCenteredText("Boost: Hold Shift (costs score & length). Pause: P key.", screenWidth, screenHeight - Config::FONT_SIZE * 4, Config::TEXT_COLOR);
+        const std::uint64_t key = (static_cast<std::uint64_t>(uiRevision) << 32) | static_cast<std::uint32_t>(selectedOptionIndex);
+        if (!optionsUi.isCurrent(key)) {
+            optionsUi.begin(key);
+            if (backgroundTexture) { optionsUi.addTexture(backgroundTexture.get(), {0, 0, screenWidth, screenHeight}); }
+            optionsUi.addCenteredText(renderer, "OPTIONS", screenWidth, screenHeight / 5, Config::TEXT_COLOR);
+            int startY = screenHeight / 3; int y_offset = Config::FONT_SIZE * 2 + 10;
+            if (optionsMenuItemRects.size() != optionsMenuItems.size()) { optionsMenuItemRects.resize(optionsMenuItems.size()); }
+            for (size_t i = 0; i < optionsMenuItems.size(); ++i) {
+                const auto& item = optionsMenuItems[i];
+                SDL_Color color = (static_cast<int>(i) == selectedOptionIndex) ? Config::OPTIONS_HIGHLIGHT_COLOR : Config::OPTIONS_TEXT_COLOR;
+                std::string displayText = item.text;
+                if (item.action == OptionAction::TOGGLE_MODE || item.action == OptionAction::TOGGLE_SOUND || item.action == OptionAction::TOGGLE_BOARD_SIZE || item.action == OptionAction::TOGGLE_ARENA) { displayText = "< " + displayText + " >"; }
+                // Vùng chữ của mỗi mục được giữ lại cho hit test chuột đến lần dựng sau
+                optionsMenuItemRects[i] = optionsUi.addCenteredText(renderer, displayText, screenWidth, startY + static_cast<int>(i) * y_offset, color);
+            }
+            optionsUi.addCenteredText(renderer, "Controls: W/A/S/D or Arrows to Move. Eat food to Grow.", screenWidth, screenHeight - Config::FONT_SIZE * 6, Config::TEXT_COLOR);
+            optionsUi.addCenteredText(renderer, "Objective: Avoid walls (Classic), obstacles, and self. Survive!", screenWidth, screenHeight - Config::FONT_SIZE * 5, Config::TEXT_COLOR);
+            optionsUi.addCenteredText(renderer, "Boost: Hold Shift (costs score & length). Pause: P key.", screenWidth, screenHeight - Config::FONT_SIZE * 4, Config::TEXT_COLOR);
+        }
+        optionsUi.draw(renderer);
     }
 
     void Game::renderGameScreen(Renderer& renderer) const {
-        if (backgroundTexture) { SDL_Rect destRect = {0, 0, screenWidth, screenHeight}; renderer.drawTexture(backgroundTexture.get(), &destRect); }
+        const bool staticBaked = staticLayer.isReady();
+        if (staticBaked) { staticLayer.draw(renderer, camera); }
+        else if (backgroundTexture) {
+            StaticLayer::drawBackground(renderer, backgroundTexture.get(), camera.originX * cellSize + camera.offsetX, camera.originY * cellSize + camera.offsetY,
+                                        screenWidth, screenHeight, screenWidth, screenHeight);
+        }
         else { renderer.clear(); }
-        if (!obstacles.empty()) {
-            std::vector<SDL_Rect> obsRects; obsRects.reserve(obstacles.size());
-            for (const auto& obs : obstacles) { obsRects.push_back({obs.position.x, obs.position.y, cellSize, cellSize}); }
-            renderer.drawRects(obsRects, Config::OBSTACLE_COLOR, true);
-        }
-        SDL_Point foodPos = food.getPosition();
-        if (foodTexture && foodPos.x >= 0 && foodPos.y >= 0) { SDL_Rect foodRect = {foodPos.x, foodPos.y, cellSize, cellSize}; renderer.drawTexture(foodTexture.get(), &foodRect); }
-        else if (!foodTexture && foodPos.x >=0 && foodPos.y >=0) { SDL_Rect foodRect = {foodPos.x, foodPos.y, cellSize, cellSize}; renderer.drawRect(&foodRect, {255, 0, 0, 255}, true); }
-        snake.draw(renderer.getSDLRenderer());
-        int currentHighScore = highScores.empty() ? 0 : highScores[0].score;
-        const_cast<Renderer&>(renderer).renderUI(score, currentHighScore, 10, 10, 10, 10 + Config::FONT_SIZE + 5, Config::TEXT_COLOR);
-        if (isBoosting) { const_cast<Renderer&>(renderer).renderText("BOOST!", screenWidth - 100, 10, {255, 100, 0, 255}); }
-        if (currentState == GameState::Paused && pausedTextTexture) {
-            SDL_Rect destPausedRect = pausedTextRect; destPausedRect.x = (screenWidth - destPausedRect.w) / 2; destPausedRect.y = screenHeight / 2 - destPausedRect.h / 2;
-            renderer.drawTexture(pausedTextTexture.get(), &destPausedRect);
-            renderer.renderCenteredText("(Press P or Enter to Resume, ESC for Main Menu)", screenWidth, destPausedRect.y + destPausedRect.h + 10, Config::PAUSE_TEXT_COLOR);
-        } else if (currentState == GameState::GameOver && gameOverTextTexture) {
-            SDL_Rect destGameOverRect = gameOverTextRect; destGameOverRect.x = (screenWidth - destGameOverRect.w) / 2; destGameOverRect.y = screenHeight / 2 - destGameOverRect.h - 20;
-            renderer.drawTexture(gameOverTextTexture.get(), &destGameOverRect);
-            renderer.renderCenteredText("Press SPACE to Restart", screenWidth, destGameOverRect.y + destGameOverRect.h + 10, Config::GAMEOVER_TEXT_COLOR);
-            renderer.renderCenteredText("Press ESC for Main Menu", screenWidth, destGameOverRect.y + destGameOverRect.h + 10 + Config::FONT_SIZE + 5, Config::GAMEOVER_TEXT_COLOR);
-        }
-    }
-
-    void Game::renderHighScoreEntry(Renderer& renderer) const {
-        renderGameScreen(renderer);
-        SDL_Rect overlayRect = {0, 0, screenWidth, screenHeight}; renderer.drawRect(&overlayRect, {0, 0, 0, 150}, true);
-        SDL_Rect inputBgRect = { screenWidth / 4, screenHeight / 3, screenWidth / 2, screenHeight / 3 }; renderer.drawRect(&inputBgRect, {50, 50, 50, 220}, true);
-        int textY = inputBgRect.y + 30;
-        renderer.renderCenteredText("New High Score!", screenWidth, textY, Config::MENU_HIGHLIGHT_COLOR);
-        textY += Config::FONT_SIZE * 2; renderer.renderCenteredText("Enter Your Name:", screenWidth, textY, Config::TEXT_COLOR); textY += Config::FONT_SIZE * 2;
-        std::string displayText = currentPlayerNameInput; Uint32 ticks = SDL_GetTicks();
-        if ((ticks / 500) % 2 == 0) { displayText += '_'; } else { displayText += ' '; }
-        renderer.renderCenteredText(displayText, screenWidth, textY, Config::TEXT_COLOR);
-        renderer.renderCenteredText("(Max 15 chars, Enter to Confirm, ESC to Cancel)", screenWidth, inputBgRect.y + inputBgRect.h - 40, Config::PAUSE_TEXT_COLOR);
+        if (arena) {
+            renderArena(renderer);
+            if (boardExceedsViewport()) { renderMinimap(renderer); }
+            int currentHighScore = highScores.empty() ? 0 : highScores[0].score;
+            const_cast<Renderer&>(renderer).renderUI(arena->getScore(0), currentHighScore, 10, 10, 10, 10 + Config::FONT_SIZE + 5, Config::TEXT_COLOR);
+            const_cast<Renderer&>(renderer).renderText("Alive: " + std::to_string(arena->getAliveCount()), screenWidth - 140, 10, Config::TEXT_COLOR);
+        } else {
+            const Simulation& simulation = viewedSimulation();
+            // Chỉ gửi tới Renderer các đối tượng nằm trong khung nhìn. Khi lớp tĩnh đã nướng, chỉ còn vật cản di chuyển phải vẽ
+            // (chỉ duyệt danh sách vật cản động); nếu không, vật cản được quét từ lưới chiếm chỗ theo hình chữ nhật của camera
+            std::vector<SDL_Rect> obsRects;
+            if (staticBaked) {
+                const ObstacleField& obstacles = simulation.getObstacles();
+                for (const std::uint32_t i : obstacles.getMovingIndices()) {
+                    const Point pos = obstacles.positionAt(i);
+                    if (StaticLayer::isBaked(simulation, i) || !camera.contains(pos)) continue;
+                    const Point screen = camera.toScreen(pos, cellSize);
+                    obsRects.push_back({screen.x, screen.y, cellSize, cellSize});
+                }
+            } else {
+                simulation.getGrid().forEachInRect(CellTag::Obstacle, camera.originX, camera.originY, camera.originX + camera.visibleColumns(), camera.originY + camera.visibleRows(),
+                    [&](int x, int y) { const Point screen = camera.toScreen({x, y}, cellSize); obsRects.push_back({screen.x, screen.y, cellSize, cellSize}); });
+            }
+            if (!obsRects.empty()) { renderer.drawRects(obsRects, Config::OBSTACLE_COLOR, true); }
+            Point foodPos = simulation.getFoodPosition();
+            if (foodPos.x >= 0 && foodPos.y >= 0 && camera.contains(foodPos)) {
+                const Point foodScreen = camera.toScreen(foodPos, cellSize);
+                SDL_Rect foodRect = {foodScreen.x, foodScreen.y, cellSize, cellSize};
+                if (foodTexture) { renderer.drawTexture(foodTexture.get(), &foodRect); }
+                else { renderer.drawRect(&foodRect, {255, 0, 0, 255}, true); }
+            }
+            renderer.drawSnake(simulation.getSnake(), cellSize, camera, Config::SNAKE_HEAD_COLOR, Config::SNAKE_COLOR, previousSnakeBody, interpolationAlpha());
+            if (boardExceedsViewport()) { renderMinimap(renderer); }
+            int currentHighScore = highScores.empty() ? 0 : highScores[0].score;
+            const_cast<Renderer&>(renderer).renderUI(simulation.getScore(), currentHighScore, 10, 10, 10, 10 + Config::FONT_SIZE + 5, Config::TEXT_COLOR);
+            if (simulation.isBoosting()) { const_cast<Renderer&>(renderer).renderText("BOOST!", screenWidth - 100, 10, {255, 100, 0, 255}); }
+            if (autopilotMode != AutopilotMode::Off) {
+                const_cast<Renderer&>(renderer).renderText(autopilotMode == AutopilotMode::AStar ? "AUTOPILOT A* (F2)" : "AUTOPILOT SEARCH (F2)",
+                                                           screenWidth - 260, 10 + Config::FONT_SIZE + 5, {120, 200, 255, 255});
+            }
+        }
+        if (currentState == GameState::ReplayViewer && replayViewer) {
+            const std::string status = "Replay " + std::to_string(replayViewer->getTick()) + " / " + std::to_string(replayViewer->getHeader().finalTick)
+                                     + (replayViewerPaused ? "  [Paused]" : "");
+            renderer.renderCenteredText(status, screenWidth, screenHeight - Config::FONT_SIZE * 3, Config::TEXT_COLOR);
+            renderer.renderCenteredText("Left/Right: Seek (Shift: x10)  Space: Pause  ESC: Menu", screenWidth, screenHeight - Config::FONT_SIZE * 2, Config::TEXT_COLOR);
+        }
     }
 
-    GameState Game::getCurrentState() const { return currentState; }
+    void Game::renderArena(Renderer& renderer) const {
+        const OccupancyGrid& grid = arena->getGrid();
+        std::vector<SDL_Rect> foodRects;
+        grid.forEachInRect(CellTag::Food, camera.originX, camera.originY, camera.originX + camera.visibleColumns(), camera.originY + camera.visibleRows(),
+            [&](int x, int y) { const Point screen = camera.toScreen({x, y}, cellSize); foodRects.push_back({screen.x, screen.y, cellSize, cellSize}); });
+        for (SDL_Rect& foodRect : foodRects) {
+            if (foodTexture) { renderer.drawTexture(foodTexture.get(), &foodRect); }
+            else { renderer.drawRect(&foodRect, {255, 0, 0, 255}, true); }
+        }
+        // Bot vẽ trước để rắn của người chơi luôn nằm trên cùng
+        for (int i = 1; i < arena->getSnakeCount(); ++i) {
+            if (arena->isAlive(i)) renderer.drawSnake(arena->getSnake(i), cellSize, camera, Config::BOT_SNAKE_HEAD_COLOR, Config::BOT_SNAKE_COLOR);
+        }
+        if (arena->isAlive(0)) renderer.drawSnake(arena->getSnake(0), cellSize, camera);
+    }
 
-    bool Game::didQuit() const { return quitRequested; }
+    void Game::renderMinimap(Renderer& renderer) const {
+        const int boardWidth = activeGrid().getWidth();
+        const int boardHeight = activeGrid().getHeight();
+        const int longSide = std::max(boardWidth, boardHeight);
+        const int mapWidth = Config::MINIMAP_SIZE * boardWidth / longSide;
+        const int mapHeight = Config::MINIMAP_SIZE * boardHeight / longSide;
+        SDL_Rect dest = {screenWidth - mapWidth - Config::MINIMAP_MARGIN, screenHeight - mapHeight - Config::MINIMAP_MARGIN, mapWidth, mapHeight};
+        minimap.draw(renderer, dest);
+
+        // Khung nhìn của camera và vị trí mồi (một ô mồi nhỏ hơn một texel nên vẽ riêng)
+        SDL_Rect view = {dest.x + camera.originX * mapWidth / boardWidth, dest.y + camera.originY * mapHeight / boardHeight,
+                         std::max(2, camera.columns * mapWidth / boardWidth), std::max(2, camera.rows * mapHeight / boardHeight)};
+        renderer.drawRect(&view, Config::MINIMAP_VIEWPORT_COLOR, false);
+        const Point foodPos = arena ? Point{-1, -1} : viewedSimulation().getFoodPosition();
+        if (foodPos.x >= 0) {
+            SDL_Rect marker = {dest.x + foodPos.x * mapWidth / boardWidth - 1, dest.y + foodPos.y * mapHeight / boardHeight - 1, 3, 3};
+            renderer.drawRect(&marker, Config::MINIMAP_FOOD_COLOR, true);
+        }
+    }
 
-    void Game::increaseSpeed() {
-        moveInterval = std::max(static_cast<Uint32>(Config::MIN_MOVE_INTERVAL_MS), moveInterval - static_cast<Uint32>(Config::SPEED_INCREMENT_MS));
-    }
-
-    void Game::generateObstacles() {
-        obstacles.clear(); if (Config::OBSTACLE_COUNT <= 0) return;
-        int maxGridX = std::max(0, (screenWidth / cellSize) - 1); int maxGridY = std::max(0, (screenHeight / cellSize) - 1);
-        int gridArea = (maxGridX + 1) * (maxGridY + 1); if (gridArea <= 0) return;
-        std::vector<SDL_Point> allPositions; allPositions.reserve(gridArea);
-        for (int x = 0; x <= maxGridX; ++x) { for (int y = 0; y <= maxGridY; ++y) { allPositions.push_back({x * cellSize, y * cellSize}); } }
-        std::vector<SDL_Point> invalidPositions; const auto& initialSnakeBody = snake.getBody(); SDL_Point startHead = initialSnakeBody.empty() ? SDL_Point{-1,-1} : initialSnakeBody.front();
-        for (const auto& segment : initialSnakeBody) { invalidPositions.push_back(segment); }
-        if (startHead.x != -1) {
-            int safeRadius = 2;
-            for (int dx = -safeRadius; dx <= safeRadius; ++dx) { for (int dy = -safeRadius; dy <= safeRadius; ++dy) {
-                    SDL_Point safePos = {startHead.x + dx * cellSize, startHead.y + dy * cellSize};
-                    if (safePos.x >= 0 && safePos.x < screenWidth && safePos.y >= 0 && safePos.y < screenHeight) {
-                        bool alreadyInvalid = false;
-                        for(const auto& invalid : invalidPositions) { if(invalid.x == safePos.x && invalid.y == safePos.y) { alreadyInvalid = true; break; } }
-                        if (!alreadyInvalid) { invalidPositions.push_back(safePos); }
-                    } } }
-        }
-        std::vector<SDL_Point> validObstaclePositions; validObstaclePositions.reserve(allPositions.size());
-        for (const auto& p : allPositions) {
-            bool isInvalid = false; for (const auto& invalid : invalidPositions) { if (p.x == invalid.x && p.y == invalid.y) { isInvalid = true; break; } }
-            if (!isInvalid) { validObstaclePositions.push_back(p); }
-        }
-        std::shuffle(validObstaclePositions.begin(), validObstaclePositions.end(), rng);
-        int count = std::min(static_cast<int>(validObstaclePositions.size()), Config::OBSTACLE_COUNT);
-        if (count < Config::OBSTACLE_COUNT) { std::cout << "Warning: Could only place " << count << "/" << Config::OBSTACLE_COUNT << " initial obstacles due to space constraints." << std::endl; }
-        if (count <= 0) { std::cout << "No valid positions to place initial obstacles." << std::endl; return; }
-
-        std::uniform_real_distribution<float> moveTypeDist(0.0f, 1.0f);
-        std::uniform_int_distribution<int> rangeDist(3, 8);
-        std::uniform_int_distribution<int> dirDist(0, 1);
-
-        float currentMovingRatio = std::min(Config::MAX_MOVING_OBSTACLE_RATIO,
-                                            Config::BASE_MOVING_OBSTACLE_RATIO + score * Config::MOVING_RATIO_SCORE_FACTOR);
-        int currentSpeedFactor = std::max(Config::MIN_OBSTACLE_SPEED_FACTOR,
-                                          Config::BASE_OBSTACLE_SPEED_FACTOR - score / Config::OBSTACLE_SPEED_SCORE_DIVISOR);
-
-        obstacles.reserve(count);
-        for (int i = 0; i < count; ++i) {
-            Obstacle obs;
-            obs.position = validObstaclePositions[i];
-
-            if (moveTypeDist(rng) < currentMovingRatio) {
-                obs.movementType = (dirDist(rng) == 0) ? ObstacleMovement::Horizontal : ObstacleMovement::Vertical;
-                obs.moveRange = rangeDist(rng);
-                obs.currentMoveStep = 0;
-                if (obs.movementType == ObstacleMovement::Horizontal) {
-                    obs.moveDirection = (dirDist(rng) == 0) ? Direction::LEFT : Direction::RIGHT;
-                } else {
-                    obs.moveDirection = (dirDist(rng) == 0) ? Direction::UP : Direction::DOWN;
-                }
-                obs.moveSpeedFactor = currentSpeedFactor;
-                obs.moveDelayCounter = rng() % obs.moveSpeedFactor;
-            } else {
-                obs.movementType = ObstacleMovement::Static;
-            }
-            obstacles.push_back(obs);
-        }
-
-        std::cout << "Generated " << obstacles.size() << " initial obstacles ("
-                  << std::count_if(obstacles.begin(), obstacles.end(), [](const Obstacle& o){ return o.movementType != ObstacleMovement::Static; }) << " moving)."
-                  << std::endl;
-    }
-
-    bool Game::addSingleObstacle() {
-        int maxGridX = std::max(0, (screenWidth / cellSize) - 1); int maxGridY = std::max(0, (screenHeight / cellSize) - 1); int gridArea = (maxGridX + 1) * (maxGridY + 1);
-        const auto& snakeBody = snake.getBody(); SDL_Point foodPos = food.getPosition();
-        size_t occupiedSpots = snakeBody.size() + obstacles.size(); if (foodPos.x >= 0) occupiedSpots++;
-        if (occupiedSpots >= static_cast<size_t>(gridArea) * 0.9) { return false; }
-        std::uniform_int_distribution<int> distX(0, maxGridX); std::uniform_int_distribution<int> distY(0, maxGridY);
-        SDL_Point potentialPos; bool validPosition; const int maxAttempts = gridArea + 50; int attempts = 0;
-        do {
-            potentialPos.x = distX(rng) * cellSize; potentialPos.y = distY(rng) * cellSize; validPosition = true; attempts++;
-            for (const auto& segment : snakeBody) { if (potentialPos.x == segment.x && potentialPos.y == segment.y) { validPosition = false; break; } } if (!validPosition) continue;
-            for (const auto& obs : obstacles) { if (potentialPos.x == obs.position.x && potentialPos.y == obs.position.y) { validPosition = false; break; } } if (!validPosition) continue;
-            if (foodPos.x >= 0 && potentialPos.x == foodPos.x && potentialPos.y == foodPos.y) { validPosition = false; }
-        } while (!validPosition && attempts < maxAttempts);
-        if (!validPosition) { std::cerr << "Warning: Could not find a valid random position for new obstacle after " << maxAttempts << " attempts. Grid occupancy: " << occupiedSpots << "/" << gridArea << std::endl; return false; }
-
-        Obstacle newObs;
-        newObs.position = potentialPos;
-
-        float currentMovingRatio = std::min(Config::MAX_MOVING_OBSTACLE_RATIO,
-                                            Config::BASE_MOVING_OBSTACLE_RATIO + score * Config::MOVING_RATIO_SCORE_FACTOR);
-        int currentSpeedFactor = std::max(Config::MIN_OBSTACLE_SPEED_FACTOR,
-                                          Config::BASE_OBSTACLE_SPEED_FACTOR - score / Config::OBSTACLE_SPEED_SCORE_DIVISOR);
-
-        std::uniform_real_distribution<float> moveTypeDist(0.0f, 1.0f);
-        std::uniform_int_distribution<int> rangeDist(3, 6);
-        std::uniform_int_distribution<int> dirDist(0, 1);
-
-        if (moveTypeDist(rng) < currentMovingRatio) {
-            newObs.movementType = (dirDist(rng) == 0) ? ObstacleMovement::Horizontal : ObstacleMovement::Vertical;
-            newObs.moveRange = rangeDist(rng);
-            newObs.currentMoveStep = 0;
-            if (newObs.movementType == ObstacleMovement::Horizontal) {
-                newObs.moveDirection = (dirDist(rng) == 0) ? Direction::LEFT : Direction::RIGHT;
-            } else {
-                newObs.moveDirection = (dirDist(rng) == 0) ? Direction::UP : Direction::DOWN;
+    void Game::renderOverlay(Renderer& renderer) {
+        if (currentState != GameState::Paused && currentState != GameState::GameOver && currentState != GameState::EnteringHighScore) return;
+        const std::uint64_t key = (static_cast<std::uint64_t>(currentState) << 1) | (arena ? 1u : 0u);
+        if (!overlayUi.isCurrent(key)) {
+            overlayUi.begin(key);
+            if (currentState == GameState::Paused && pausedTextTexture) {
+                SDL_Rect destPausedRect = pausedTextRect; destPausedRect.x = (screenWidth - destPausedRect.w) / 2; destPausedRect.y = screenHeight / 2 - destPausedRect.h / 2;
+                overlayUi.addTexture(pausedTextTexture.get(), destPausedRect);
+                overlayUi.addCenteredText(renderer, "(Press P or Enter to Resume, ESC for Main Menu)", screenWidth, destPausedRect.y + destPausedRect.h + 10, Config::PAUSE_TEXT_COLOR);
+            } else if (currentState == GameState::GameOver && gameOverTextTexture) {
+                SDL_Rect destGameOverRect = gameOverTextRect; destGameOverRect.x = (screenWidth - destGameOverRect.w) / 2; destGameOverRect.y = screenHeight / 2 - destGameOverRect.h - 20;
+                overlayUi.addTexture(gameOverTextTexture.get(), destGameOverRect);
+                overlayUi.addCenteredText(renderer, "Press SPACE to Restart", screenWidth, destGameOverRect.y + destGameOverRect.h + 10, Config::GAMEOVER_TEXT_COLOR);
+                overlayUi.addCenteredText(renderer, "Press ESC for Main Menu", screenWidth, destGameOverRect.y + destGameOverRect.h + 10 + Config::FONT_SIZE + 5, Config::GAMEOVER_TEXT_COLOR);
+                if (!arena) overlayUi.addCenteredText(renderer, "Press R to Watch Replay", screenWidth, destGameOverRect.y + destGameOverRect.h + 10 + (Config::FONT_SIZE + 5) * 2, Config::GAMEOVER_TEXT_COLOR);
+            } else if (currentState == GameState::EnteringHighScore) {
+                overlayUi.addRect({0, 0, screenWidth, screenHeight}, {0, 0, 0, 150}, true);
+                SDL_Rect inputBgRect = { screenWidth / 4, screenHeight / 3, screenWidth / 2, screenHeight / 3 }; overlayUi.addRect(inputBgRect, {50, 50, 50, 220}, true);
+                int textY = inputBgRect.y + 30;
+                overlayUi.addCenteredText(renderer, "New High Score!", screenWidth, textY, Config::MENU_HIGHLIGHT_COLOR);
+                textY += Config::FONT_SIZE * 2; overlayUi.addCenteredText(renderer, "Enter Your Name:", screenWidth, textY, Config::TEXT_COLOR);
+                overlayUi.addCenteredText(renderer, "(Max " + std::to_string(Config::PLAYER_NAME_MAX_LENGTH) + " chars, Enter to Confirm, ESC to Cancel)", screenWidth, inputBgRect.y + inputBgRect.h - 40, Config::PAUSE_TEXT_COLOR);
             }
-            newObs.moveSpeedFactor = currentSpeedFactor;
-            newObs.moveDelayCounter = rng() % newObs.moveSpeedFactor;
-        } else {
-            newObs.movementType = ObstacleMovement::Static;
         }
+        overlayUi.draw(renderer);
+    }
 
-        obstacles.push_back(newObs);
-        return true;
+    void Game::renderHighScoreEntry(Renderer& renderer) {
+        renderGameScreen(renderer);
+        renderOverlay(renderer);
+        // Dòng tên đang nhập có danh sách riêng: chỉ dựng lại khi tên đổi hoặc con trỏ nhấp nháy (2 lần mỗi giây)
+        const bool cursorVisible = cursorBlinkOn;
+        const std::uint64_t key = (std::hash<std::string>{}(currentPlayerNameInput) << 1) | (cursorVisible ? 1u : 0u);
+        if (!nameEntryUi.isCurrent(key)) {
+            nameEntryUi.begin(key);
+            const int textY = screenHeight / 3 + 30 + Config::FONT_SIZE * 4;
+            nameEntryUi.addCenteredText(renderer, currentPlayerNameInput + (cursorVisible ? '_' : ' '), screenWidth, textY, Config::TEXT_COLOR);
+        }
+        nameEntryUi.draw(renderer);
     }
 
+    GameState Game::getCurrentState() const { return currentState; }
 
-    bool Game::checkObstacleCollision(const SDL_Point& pos) const {
-        return std::any_of(obstacles.begin(), obstacles.end(), [&](const Obstacle& obs){ return pos.x == obs.position.x && pos.y == obs.position.y; });
+    Point Game::selectedBoardSize() const {
+        if (hugeBoard) return {Config::HUGE_BOARD_WIDTH, Config::HUGE_BOARD_HEIGHT};
+        return {screenWidth / cellSize, screenHeight / cellSize};
     }
 
-    void Game::placeFood() {
-        std::vector<SDL_Point> currentObstaclePositions; currentObstaclePositions.reserve(obstacles.size());
-        for(const auto& obs : obstacles) { currentObstaclePositions.push_back(obs.position); }
-        food.generate(screenWidth, screenHeight, snake.getBody(), currentObstaclePositions);
-        if (food.getPosition().x < 0) { std::cerr << "Error: Failed to place food on the grid! The grid might be full." << std::endl; }
+    bool Game::boardExceedsViewport() const {
+        return activeGrid().getWidth() > camera.columns || activeGrid().getHeight() > camera.rows;
     }
 
-    void Game::updateObstacles() {
-        const auto& snakeBody = snake.getBody(); SDL_Point currentFoodPos = food.getPosition();
-        for (auto& obs : obstacles) {
-            if (currentGameMode == GameMode::PortalWalls && obs.movementType != ObstacleMovement::Static)
-            {
-                obs.moveDelayCounter++; if (obs.moveDelayCounter < obs.moveSpeedFactor) { continue; } obs.moveDelayCounter = 0;
-                SDL_Point nextPos = obs.position; int dx = 0, dy = 0;
-                switch (obs.moveDirection) { case Direction::UP: dy = -cellSize; break; case Direction::DOWN: dy = cellSize; break; case Direction::LEFT: dx = -cellSize; break; case Direction::RIGHT: dx = cellSize; break; }
-                nextPos.x += dx; nextPos.y += dy;
-                if (nextPos.x < 0) nextPos.x = screenWidth - cellSize; else if (nextPos.x >= screenWidth) nextPos.x = 0; if (nextPos.y < 0) nextPos.y = screenHeight - cellSize; else if (nextPos.y >= screenHeight) nextPos.y = 0;
-                bool collisionDetected = false;
-                for (const auto& otherObs : obstacles) { if (&obs == &otherObs) continue; if (nextPos.x == otherObs.position.x && nextPos.y == otherObs.position.y) { collisionDetected = true; break; } }
-                if (!collisionDetected) { for (size_t i = 0; i < snakeBody.size(); ++i) { if (nextPos.x == snakeBody[i].x && nextPos.y == snakeBody[i].y) { collisionDetected = true; break; } } }
-                if (currentFoodPos.x >= 0 && nextPos.x == currentFoodPos.x && nextPos.y == currentFoodPos.y) {
-                    if (!collisionDetected) { std::cout << "Obstacle moving into food! Generating new food." << std::endl; placeFood(); currentFoodPos = food.getPosition(); }
-                }
-                if (collisionDetected) {
-                    if (obs.movementType == ObstacleMovement::Horizontal) { obs.moveDirection = (obs.moveDirection == Direction::LEFT) ? Direction::RIGHT : Direction::LEFT; }
-                    else { obs.moveDirection = (obs.moveDirection == Direction::UP) ? Direction::DOWN : Direction::UP; }
-                    obs.currentMoveStep = 0;
-                } else {
-                    obs.position = nextPos; obs.currentMoveStep++;
-                    if (obs.currentMoveStep >= obs.moveRange) {
-                        if (obs.movementType == ObstacleMovement::Horizontal) { obs.moveDirection = (obs.moveDirection == Direction::LEFT) ? Direction::RIGHT : Direction::LEFT; }
-                        else { obs.moveDirection = (obs.moveDirection == Direction::UP) ? Direction::DOWN : Direction::UP; }
-                        obs.currentMoveStep = 0;
-                    } } } }
-    }
+    bool Game::didQuit() const { return quitRequested; }
 
     void Game::reset() {
         std::cout << "Resetting game state for mode: " << (currentGameMode == GameMode::Classic ? "Classic" : "Portal") << std::endl;
-        SDL_Point startPos = calculateStartPosition();
-        snake = Snake(startPos.x, startPos.y, cellSize, Config::DEFAULT_SNAKE_LENGTH);
-        score = 0; moveInterval = Config::INITIAL_SNAKE_SPEED_DELAY_MS; timeAccumulator = 0.0f; nextObstacleScoreThreshold = Config::OBSTACLE_ADD_SCORE_INTERVAL;
-        obstacles.clear(); generateObstacles(); placeFood();
-        isBoosting = false; boostCostTimer = 0.0f; boostCostCycles = 0;
+        finishReplay();
+        const std::uint32_t seed = sessionSeed + gamesStarted++;
+        std::cout << "Game seed: " << seed << std::endl;
+        if (arenaEnabled) {
+            ArenaConfig config;
+            config.boardWidth = Config::ARENA_BOARD_WIDTH;
+            config.boardHeight = Config::ARENA_BOARD_HEIGHT;
+            config.snakeCount = Config::ARENA_SNAKE_COUNT;
+            config.foodCount = Config::ARENA_FOOD_COUNT;
+            config.mode = currentGameMode;
+            if (!jobSystem) jobSystem = std::make_unique<JobSystem>();
+            arena = std::make_unique<Arena>(config, seed, jobSystem.get());
+            arena->setController(0, ArenaController::Human);
+            arena->setGridChangeTracking(boardExceedsViewport());
+            std::cout << "Arena started with " << arena->getAliveCount() << " snakes on a " << config.boardWidth << "x" << config.boardHeight
+                      << " board (" << jobSystem->getThreadCount() << " threads)." << std::endl;
+        } else {
+            arena.reset(); // Ván Arena không dùng mô phỏng một rắn: chỉ dựng/reset nó khi chơi ván đơn
+            const Point boardSize = selectedBoardSize();
+            if (boardSize.x != simulation.getBoardWidth() || boardSize.y != simulation.getBoardHeight()) {
+                std::cout << "Creating " << boardSize.x << "x" << boardSize.y << " board." << std::endl;
+                // Giữ mật độ vật cản của bàn chơi thường; constructor đã bắt đầu ván nên không reset lại
+                const long long area = static_cast<long long>(boardSize.x) * boardSize.y;
+                const int obstacleCount = static_cast<int>(area * Config::OBSTACLE_COUNT / (Config::BOARD_WIDTH * Config::BOARD_HEIGHT));
+                simulation = Simulation(boardSize.x, boardSize.y, seed, currentGameMode, obstacleCount);
+            } else {
+                simulation.reset(seed, currentGameMode);
+            }
+            autopilot.reset();
+            previousSnakeBody.clear();
+            simulation.setGridChangeTracking(boardExceedsViewport());
+
+            ReplayHeader header;
+            header.seed = seed;
+            header.mode = currentGameMode;
+            header.boardWidth = simulation.getBoardWidth();
+            header.boardHeight = simulation.getBoardHeight();
+            header.obstacleCount = simulation.getInitialObstacleCount();
+            replay.begin(header);
+            recordingReplay = true;
+
+            const auto& obstacles = simulation.getObstacles();
+            std::cout << "Generated " << obstacles.size() << " initial obstacles ("
+                      << obstacles.countMoving() << " moving)."
+                      << std::endl;
+        }
+        timeAccumulator = 0.0f; boostHeld = false;
         selectedButtonIndex = 0; selectedOptionIndex = 0; for(auto& rect : optionsMenuItemRects) { rect = {0,0,0,0}; }
         currentState = GameState::Playing;
         if(isEnteringName) { SDL_StopTextInput(); isEnteringName = false; } currentPlayerNameInput = "";
@@ -918,6 +1212,7 @@ namespace SnakeGame {
                 else { std::cerr << "Warning: Invalid line format in highscore file: '" << line << "'" << std::endl; } }
             file.close(); std::sort(highScores.begin(), highScores.end());
             if (highScores.size() > static_cast<size_t>(maxHighScores)) { highScores.resize(maxHighScores); }
+            ++uiRevision;
             std::cout << "Successfully loaded " << highScores.size() << " high scores." << std::endl;
         } else { std::cout << "High score file not found or could not be opened ('" << Config::HIGHSCORE_FILE << "'). Starting with empty scores." << std::endl; }
     }
@@ -946,6 +1241,7 @@ namespace SnakeGame {
         if (trimmedName.empty()) trimmedName = "Player";
         highScores.push_back({trimmedName, score}); std::sort(highScores.begin(), highScores.end());
         if (highScores.size() > static_cast<size_t>(maxHighScores)) { highScores.resize(maxHighScores); }
+        ++uiRevision;
         std::cout << "Added high score: " << trimmedName << " - " << score << ". High score list size: " << highScores.size() << std::endl;
     }
 
@@ -1,9 +1,19 @@
 #ifndef GAME_HPP
 #define GAME_HPP
 
-#include "Snake.hpp"
-#include "Food.hpp"
+#include "Simulation.hpp"
+#include "Arena.hpp"
+#include "JobSystem.hpp"
+#include "Replay.hpp"
+#include "Autopilot.hpp"
+#include "Lookahead.hpp"
 #include "Renderer.hpp"
+#include "Camera.hpp"
+#include "Minimap.hpp"
+#include "DisplayList.hpp"
+#include "StaticLayer.hpp"
+#include "InputLatency.hpp"
+#include "FrameCapture.hpp"
 #include "Config.hpp"
 #include <SDL.h>
 #include <SDL_mixer.h>
@@ -18,16 +28,16 @@
 namespace SnakeGame {
 
     /**
-     *  GameMode
-     *    Xác định các chế độ chơi khác nhau (ảnh hưởng đến va chạm tường).
+     * GameState
+     *    Xác định các trạng thái khác nhau của vòng lặp trò chơi.
      */
-    enum class GameMode { Classic, PortalWalls };
+    enum class GameState { MainMenu, Options, Playing, Paused, GameOver, EnteringHighScore, ReplayViewer };
 
     /**
-     * GameState
-     *    Xác định các trạng thái khác nhau của vòng lặp trò chơi.
+     *    AutopilotMode
+     *    Bot đang lái rắn trong ván đơn (F2 chuyển vòng: tắt -> A* -> tìm kiếm nhiều bước -> tắt).
      */
-    enum class GameState { MainMenu, Options, Playing, Paused, GameOver, EnteringHighScore };
+    enum class AutopilotMode { Off, AStar, Lookahead };
 
     /**
      *  MixChunkDeleter
@@ -75,6 +85,8 @@ namespace SnakeGame {
     enum class OptionAction {
         TOGGLE_MODE,       // Chuyển đổi giữa Classic/Portal
         TOGGLE_SOUND,      // Bật/tắt âm thanh
+        TOGGLE_BOARD_SIZE, // Chuyển đổi giữa bàn chơi thường và bàn chơi lớn
+        TOGGLE_ARENA,      // Bật/tắt chế độ Arena (nhiều rắn bot)
         RESET_HIGHSCORES, // Xóa điểm cao đã lưu
         GOTO_MAINMENU      // Quay lại menu chính
     };
@@ -88,31 +100,6 @@ namespace SnakeGame {
         OptionAction action; // Hành động tương ứng
     };
 
-    /**
-     *    ObstacleMovement
-     *    Xác định kiểu di chuyển của chướng ngại vật.
-     */
-    enum class ObstacleMovement {
-        Static,     // Đứng yên
-        Horizontal, // Di chuyển ngang
-        Vertical    // Di chuyển dọc
-    };
-
-    /**
-     *    Obstacle
-     *    Đại diện cho một chướng ngại vật (có thể tĩnh hoặc động).
-     */
-    struct Obstacle {
-        SDL_Point position;        // Vị trí hiện tại (góc trên trái)
-        ObstacleMovement movementType = ObstacleMovement::Static; // Kiểu di chuyển
-        Direction moveDirection = Direction::RIGHT; // Hướng di chuyển hiện tại (cho động)
-        int moveRange = 0;         // Số ô di chuyển tối đa theo một hướng trước khi đổi chiều (cho động)
-        int currentMoveStep = 0; // Số bước đã di chuyển theo hướng hiện tại (cho động)
-        int moveDelayCounter = 0; // Bộ đếm để làm chậm tốc độ di chuyển so với rắn
-        int moveSpeedFactor = 3;  // Vật cản di chuyển sau mỗi X lượt rắn di chuyển (giá trị mặc định)
-    };
-
-
     /**
      *    Game
      *    Lớp chính quản lý toàn bộ logic và luồng của trò chơi Snake.
@@ -123,12 +110,13 @@ namespace SnakeGame {
          *    Khởi tạo đối tượng Game.
          *    screenWidth Chiều rộng màn hình.
          *    screenHeight Chiều cao màn hình.
-         *    cellSize Kích thước mỗi ô (cell).
+         *    cellSize Kích thước mỗi ô (cell) khi vẽ; bàn chơi thường có (screenWidth / cellSize) x (screenHeight / cellSize) ô,
+         *        bàn chơi lớn (Config::HUGE_BOARD_WIDTH x HUGE_BOARD_HEIGHT) được xem qua camera và minimap.
          *    renderer Tham chiếu đến đối tượng Renderer để tải tài nguyên và vẽ.
          */
         Game(int screenWidth, int screenHeight, int cellSize, Renderer& renderer);
-        /**    Destructor mặc định, unique_ptr sẽ tự dọn dẹp tài nguyên. */
-        ~Game() = default;
+        /**    Destructor: lưu replay của ván đang dở (nếu có); unique_ptr sẽ tự dọn dẹp tài nguyên. */
+        ~Game();
 
         // Xóa các constructor/operator copy và move để tránh lỗi quản lý tài nguyên
         Game(const Game&) = delete;
@@ -139,21 +127,24 @@ namespace SnakeGame {
         /**
          *    Xử lý đầu vào từ người dùng (bàn phím, chuột, thoát game).
          *    event Sự kiện SDL cần xử lý.
+         *    polledAt Giá trị SDL_GetPerformanceCounter lúc sự kiện phím được lấy khỏi hàng đợi (0: không đo độ trễ).
          */
-        void handleInput(const SDL_Event& event);
+        void handleInput(const SDL_Event& event, std::uint64_t polledAt = 0);
 
         /**
-         *    Cập nhật trạng thái trò chơi cho một bước logic (di chuyển rắn, kiểm tra va chạm, ăn mồi).
-         *        Chỉ hoạt động khi ở trạng thái Playing.
+         *    Cập nhật trạng thái trò chơi cho một bước logic: chạy Simulation::step và xử lý kết quả
+         *        (âm thanh, chuyển trạng thái khi thua). Chỉ hoạt động khi ở trạng thái Playing.
          */
         void update();
 
         /**
          *    Vẽ trạng thái hiện tại của trò chơi lên màn hình dựa trên GameState.
+         *        Bỏ qua cả vẽ lẫn present nếu không có gì thay đổi kể từ frame đã hiển thị (frameGeneration không đổi).
          *    renderer Tham chiếu đến đối tượng Renderer để vẽ.
+         *    bool true nếu đã vẽ và present một frame mới, false nếu frame trên màn hình vẫn đúng.
          * @note Hàm này không còn là const vì renderOptions() cần cập nhật optionsMenuItemRects.
          */
-        void render(Renderer& renderer);
+        bool render(Renderer& renderer);
 
         /**
          *    Chạy một khung hình logic của trò chơi, bao gồm xử lý input, cập nhật và render.
@@ -162,6 +153,13 @@ namespace SnakeGame {
          */
         void runFrame(float deltaTime);
 
+        /**
+         *    Thời gian (ms) vòng lặp chính có thể ngủ chờ sự kiện trước khi frame tiếp theo cần được xử lý:
+         *        tới bước Arena kế tiếp, tới lần đổi pha con trỏ nhập tên, hoặc Config::IDLE_WAIT_MAX_MS ở menu/tạm dừng/game over.
+         *    int 0 nếu đang mô phỏng liên tục (ván đơn, replay đang chạy): không chờ, chỉ lấy các sự kiện có sẵn.
+         */
+        [[nodiscard]] int idleWaitMs() const;
+
         /**
          *    Lấy trạng thái hiện tại của trò chơi.
          *    GameState Trạng thái hiện tại.
@@ -172,7 +170,7 @@ namespace SnakeGame {
          *    Lấy điểm số hiện tại của người chơi.
          *    int Điểm số.
          */
-        [[nodiscard]] int getScore() const { return score; }
+        [[nodiscard]] int getScore() const { return arena ? arena->getScore(0) : simulation.getScore(); }
 
         /**
          *    Kiểm tra xem người dùng có yêu cầu thoát trò chơi không.
@@ -180,9 +178,39 @@ namespace SnakeGame {
          */
         [[nodiscard]] bool didQuit() const;
 
+        /**
+         *    Cố định seed của phiên chơi: ván thứ n dùng seed + n, nên cả phiên có thể tái tạo.
+         *        Mặc định seed phiên lấy từ std::random_device.
+         */
+        void setSessionSeed(std::uint32_t seed);
+
+        /**
+         *    Mở trình xem replay (trái/phải: tua, Shift: tua xa hơn, Home/End: đầu/cuối, Space/P: dừng/chạy, ESC: về menu).
+         *    path Đường dẫn file replay.
+         *    false nếu không đọc được file.
+         */
+        bool openReplay(const std::string& path);
+
+        /**
+         *    Bắt đầu ghi hình các frame được vẽ (F12 bật/tắt trong game với file trong Config::CAPTURE_DIRECTORY).
+         *    path File .y4m hoặc thư mục chuỗi PNG.
+         *    offline true khi dựng video từ replay: mỗi frame đều được ghi (chờ nếu pool cạn) và main chạy với bước
+         *        thời gian cố định 1 / Config::CAPTURE_FPS; false: lấy mẫu theo đồng hồ thực và bỏ frame nếu bộ mã hóa chậm.
+         *    false nếu không mở được đích ghi.
+         */
+        bool startCapture(const std::string& path, bool offline);
+
+        /**    Ghi nốt các frame đang chờ, dừng ghi hình và in số frame đã ghi / bị bỏ. */
+        void stopCapture();
+
+        /**    true nếu đang ở trình xem replay và replay đã phát hết (main dừng khi dựng video từ replay). */
+        [[nodiscard]] bool isReplayAtEnd() const {
+            return currentState == GameState::ReplayViewer && replayViewer && replayViewer->atEnd();
+        }
+
         /**
          *    Đặt lại trạng thái trò chơi về ban đầu để bắt đầu một lượt chơi mới.
-         *        Reset rắn, điểm, tốc độ, vật cản, thức ăn, trạng thái boost,...
+         *        Bắt đầu ván mới trong Simulation (seed mới) và reset trạng thái UI.
          */
         void reset();
 
@@ -192,26 +220,77 @@ namespace SnakeGame {
         int screenHeight;
         int cellSize;
 
-        // Đối tượng game chính
-        Snake snake;
-        Food food;
-        std::vector<Obstacle> obstacles; // Danh sách các vật cản
+        // Lõi mô phỏng (rắn, mồi, vật cản, điểm, tốc độ, boost)
+        Simulation simulation;
+
+        // Khung nhìn lên bàn chơi (bàn chơi lớn hơn cửa sổ khi hugeBoard)
+        bool hugeBoard = false;  // Áp dụng từ ván tiếp theo
+        Camera camera;
+        Minimap minimap;
+        StaticLayer staticLayer; // Ảnh nền + vật cản đứng yên, nướng sẵn vào render target
+
+        // Chế độ Arena: rắn 0 do người chơi điều khiển, các rắn còn lại là bot
+        bool arenaEnabled = false;               // Áp dụng từ ván tiếp theo
+        std::unique_ptr<JobSystem> jobSystem;    // Tạo khi bắt đầu ván Arena đầu tiên
+        std::unique_ptr<Arena> arena;            // nullptr khi chơi chế độ một rắn
 
         // Trạng thái game
         GameState currentState;
         GameMode currentGameMode;
         bool soundEnabled;
-        int score;
         std::vector<HighScoreEntry> highScores;
         const int maxHighScores = Config::MAX_HIGH_SCORES;
-        Uint32 moveInterval; // Khoảng thời gian giữa các bước (ms) - tốc độ nền
         bool quitRequested = false;
         float timeAccumulator = 0.0f; // Tích lũy thời gian cho game loop
-
-        // Trạng thái Boost (Shift)
-        bool isBoosting = false;      // Cờ cho biết có đang boost không
-        float boostCostTimer = 0.0f;  // Bộ đếm thời gian (s) để áp dụng chi phí boost
-        int boostCostCycles = 0;      // Đếm số lần trừ điểm để biết khi nào trừ chiều dài
+        bool boostHeld = false;       // Phím Shift đang được giữ (đọc mỗi khung hình)
+
+        // Phiên chơi có seed và bản ghi replay của ván đơn hiện tại
+        std::uint32_t sessionSeed = std::random_device{}();
+        std::uint32_t gamesStarted = 0;   // Số ván đã bắt đầu trong phiên (ván n dùng sessionSeed + n)
+        Replay replay;
+        bool recordingReplay = false;     // true khi replay đang ghi ván hiện tại
+        std::unique_ptr<ReplayPlayer> replayViewer; // Replay đang xem (trạng thái ReplayViewer)
+        bool replayViewerPaused = false;
+        std::vector<std::uint8_t> quickSaveState; // Ảnh chụp Simulation::saveState của lần lưu nhanh gần nhất (rỗng nếu chưa lưu)
+        Autopilot autopilot;              // Bot A* của chế độ tự chơi (F2)
+        LookaheadAgent lookahead;         // Bot tìm kiếm nhiều bước (độ khó cao), tìm trong 1/4 khoảng thời gian mỗi bước
+        AutopilotMode autopilotMode = AutopilotMode::Off;
+
+        // Theo dõi thay đổi để bỏ qua frame giống hệt frame trước
+        std::uint64_t frameGeneration = 1;    // Tăng khi có input, chuyển trạng thái, bước mô phỏng hoặc hoạt ảnh
+        std::uint64_t renderedGeneration = 0; // frameGeneration của frame đang hiển thị
+        bool cursorBlinkOn = false;           // Pha nhấp nháy của con trỏ nhập tên ở frame trước
+
+        /**    Đánh dấu frame hiện tại đã cũ (cần vẽ lại). */
+        void markDirty() { ++frameGeneration; }
+
+        // Độ trễ phím hướng -> present (F3: overlay; tóm tắt của phiên được in khi thoát)
+        InputLatencyMonitor inputLatency{SDL_GetPerformanceFrequency()};
+        std::uint64_t currentInputStamp = 0; // Nhãn thời gian của sự kiện đang xử lý
+        bool showLatencyOverlay = false;
+
+        /**    Vẽ p50/p95/p99 của cửa sổ trượt ở góc dưới trái màn hình. */
+        void renderLatencyOverlay(Renderer& renderer) const;
+        // Ghi hình: frame được đọc trước present vào pool bộ đệm, các luồng của FrameCapture mã hóa và ghi file
+        std::unique_ptr<FrameCapture> capture;
+        bool offlineCapture = false;
+        std::uint64_t lastCaptureCounter = 0; // Mốc lấy mẫu gần nhất trên lưới 1 / CAPTURE_FPS (SDL_GetPerformanceCounter, ghi trực tiếp)
+
+        /**    Đọc frame vừa vẽ vào một bộ đệm của capture nếu đã tới lượt lấy mẫu (gọi ngay trước present). */
+        void captureFrame(Renderer& renderer);
+
+        /**    In tóm tắt độ trễ của cả phiên kèm các thiết lập ảnh hưởng tới nó (VSync, giới hạn frame, bộ đệm input). */
+        void reportInputLatency() const;
+
+        // Vẽ nội suy: tư thế rắn trước bước gần nhất, trộn với tư thế hiện tại theo phần timeAccumulator đã trôi qua
+        std::vector<Point> previousSnakeBody; // Rỗng: vẽ đúng tư thế hiện tại (sau reset, tải nhanh, tua replay)
+
+        /**    Lưu tư thế rắn của sim ngay trước khi nó bước (dùng lại bộ nhớ của lần trước). */
+        void capturePreviousPose(const Simulation& sim);
+        /**    Tỷ lệ nội suy [0, 1] cho frame hiện tại; 1 khi mô phỏng đang xem không chạy (tạm dừng, game over, Arena). */
+        [[nodiscard]] float interpolationAlpha() const;
+        /**    Vị trí đầu rắn (theo ô) của mô phỏng đang xem, nội suy như khi vẽ rắn: camera cuộn theo vị trí này. */
+        [[nodiscard]] SDL_FPoint interpolatedHeadPosition() const;
 
         // Trạng thái UI và nhập liệu
         std::string currentPlayerNameInput; // Chuỗi tên đang nhập
@@ -238,11 +317,14 @@ namespace SnakeGame {
         int selectedButtonIndex = 0;              // Chỉ số nút đang được chọn ở Main Menu
         std::vector<OptionItem> optionsMenuItems; // Các mục trong Options Menu
         int selectedOptionIndex = 0;              // Chỉ số mục đang được chọn ở Options Menu
-        std::vector<SDL_Rect> optionsMenuItemRects; // Vùng chữ nhật bao quanh các mục Options (dùng cho click chuột)
+        std::vector<SDL_Rect> optionsMenuItemRects; // Vùng chữ nhật bao quanh các mục Options (dùng cho click chuột), điền khi dựng optionsUi
 
-        // Logic game khác
-        int nextObstacleScoreThreshold; // Ngưỡng điểm để thêm vật cản mới
-        std::mt19937 rng;               // Bộ sinh số ngẫu nhiên
+        // UI giữ lại (retained): mỗi màn hình là một display list, chỉ dựng lại khi khóa từ đầu vào của nó đổi
+        DisplayList mainMenuUi;
+        DisplayList optionsUi;
+        DisplayList overlayUi;        // Paused / Game Over / khung nhập tên (phần tĩnh)
+        DisplayList nameEntryUi;      // Dòng tên đang nhập
+        std::uint32_t uiRevision = 0; // Tăng khi nội dung menu đổi (chữ của các tùy chọn, bảng điểm cao)
 
         /**    Tải các tài nguyên (textures, sounds) và khởi tạo cache, nút menu. */
         void initAssets(Renderer& renderer);
@@ -250,20 +332,8 @@ namespace SnakeGame {
         void initOptions();
         /**    Cập nhật nội dung text của các mục options dựa trên trạng thái game (Mode, Sound). */
         void updateOptionTexts();
-        /**    Tính toán vị trí xuất phát ban đầu cho rắn (thường là giữa màn hình). */
-        [[nodiscard]] SDL_Point calculateStartPosition() const;
-        /**    Tăng tốc độ di chuyển nền của rắn (giảm moveInterval) sau khi ăn mồi. */
-        void increaseSpeed();
-        /**    Đặt thức ăn vào một vị trí mới hợp lệ trên lưới, tránh rắn và vật cản. */
-        void placeFood();
-        /**    Tạo các chướng ngại vật ban đầu (tĩnh và động) khi bắt đầu game. */
-        void generateObstacles();
-        /**    Kiểm tra va chạm giữa một điểm (thường là đầu rắn) và vị trí hiện tại của các chướng ngại vật. */
-        [[nodiscard]] bool checkObstacleCollision(const SDL_Point& pos) const;
-        /**    Thêm một chướng ngại vật mới (thường là động) vào vị trí ngẫu nhiên hợp lệ khi đạt ngưỡng điểm. */
-        bool addSingleObstacle();
-        /**    Cập nhật vị trí của các chướng ngại vật động, xử lý va chạm của chúng và đổi hướng nếu cần. */
-        void updateObstacles();
+        /**    Xử lý kết thúc ván: log nguyên nhân, phát âm thanh và chuyển sang GameOver/EnteringHighScore. */
+        void handleGameOver(CollisionCause cause);
 
         /**    Tải điểm cao từ tệp vào vector highScores. */
         void loadHighScores();
@@ -288,6 +358,8 @@ namespace SnakeGame {
         void handlePausedInput(const SDL_Event& event, Config::ControlInput control);
         /**    Xử lý input (restart) cho trạng thái GameOver. */
         void handleGameOverInput(const SDL_Event& event, Config::ControlInput control);
+        /**    Xử lý input (tua, dừng/chạy) cho trạng thái ReplayViewer. */
+        void handleReplayViewerInput(const SDL_Event& event, Config::ControlInput control);
 
         /**    Kích hoạt hành động của nút được chọn trên Main Menu (chuyển state hoặc quit). */
         void activateMainMenuButton(int index);
@@ -295,23 +367,54 @@ namespace SnakeGame {
         void activateOptionItem(int index);
         /**    Chuyển đổi giữa các chế độ chơi Classic và PortalWalls. */
         void toggleGameMode();
+        /**    Kích thước bàn chơi (số ô) cho ván tiếp theo theo tùy chọn hugeBoard. */
+        [[nodiscard]] Point selectedBoardSize() const;
+        /**    Lưới của ván đang chơi (Arena hoặc Simulation). */
+        [[nodiscard]] const OccupancyGrid& activeGrid() const { return arena ? arena->getGrid() : viewedSimulation().getGrid(); }
+        /**    Mô phỏng đang được hiển thị: replay đang xem trong ReplayViewer, ván đang chơi ở các trạng thái khác. */
+        [[nodiscard]] const Simulation& viewedSimulation() const {
+            return currentState == GameState::ReplayViewer && replayViewer ? replayViewer->getSimulation() : simulation;
+        }
+        /**    Chuyển sang trình xem cho một replay đã có trong bộ nhớ. */
+        void startReplayViewer(const Replay& source);
+        /**    Phát replay đang xem theo thời gian thực (cùng nhịp bước như khi chơi). */
+        void advanceReplayViewer(float deltaTime);
+        /**    Ghi một input vào replay của ván hiện tại (nếu đang ghi). */
+        void recordReplayInput(ReplayInput input);
+        /**    Kết thúc replay của ván hiện tại và lưu vào Config::REPLAY_DIRECTORY. */
+        void finishReplay();
+        /**    Lưu nhanh (F5): chụp trạng thái mô phỏng của ván đơn vào bộ nhớ. */
+        void quickSave();
+        /**    Tải nhanh (F9): khôi phục ảnh chụp đã lưu (không qua reset()) và tạm dừng; replay đang ghi được kết thúc tại đây. */
+        void quickLoad();
+        /**    Chuyển chế độ tự chơi (F2, chỉ ván đơn): bot chọn hướng trước mỗi bước; hướng của nó được ghi vào replay như input thường. */
+        void cycleAutopilot();
+        /**    Chạy một bước Arena và xử lý sự kiện của rắn người chơi. */
+        void updateArena();
+        /**    Vẽ mồi và mọi con rắn của Arena trong khung nhìn. */
+        void renderArena(Renderer& renderer) const;
+        /**    true nếu bàn chơi hiện tại lớn hơn khung nhìn (cần camera và minimap). */
+        [[nodiscard]] bool boardExceedsViewport() const;
 
         /**
-         *    Xử lý logic bắt đầu/dừng boost dựa trên trạng thái phím Shift và điều kiện game.
-         *        Đồng thời áp dụng chi phí (điểm, chiều dài) nếu đang boost.
-         *    deltaTime Thời gian trôi qua của khung hình hiện tại, dùng để tính thời gian áp dụng cost.
+         *    Đọc trạng thái phím Shift và chuyển cho Simulation để bắt đầu/dừng boost.
+         *        Chi phí boost (điểm, chiều dài) do Simulation áp dụng theo thời gian của từng bước.
          */
-        void handleBoosting(float deltaTime);
+        void handleBoosting();
 
         // Các hàm vẽ cho từng trạng thái
         /**    Vẽ màn hình Main Menu, bao gồm các nút và danh sách điểm cao. */
-        void renderMainMenu(Renderer& renderer) const;
+        void renderMainMenu(Renderer& renderer); // Không const vì có thể dựng lại mainMenuUi
         /**    Vẽ màn hình Options, bao gồm các mục tùy chọn và cập nhật vùng rect của chúng. */
-        void renderOptions(Renderer& renderer); // Không const vì cập nhật optionsMenuItemRects
-        /**    Vẽ màn hình khi đang chơi, tạm dừng hoặc game over (vẽ rắn, mồi, vật cản, UI, thông báo). */
+        void renderOptions(Renderer& renderer); // Không const vì có thể dựng lại optionsUi và optionsMenuItemRects
+        /**    Vẽ màn hình khi đang chơi, tạm dừng hoặc game over (vẽ rắn, mồi, vật cản, HUD, trạng thái replay). */
         void renderGameScreen(Renderer& renderer) const;
+        /**    Vẽ lớp phủ thông báo của Paused / Game Over / nhập điểm cao từ overlayUi (dựng lại khi trạng thái đổi). */
+        void renderOverlay(Renderer& renderer);
+        /**    Vẽ minimap của bàn chơi lớn ở góc dưới phải, kèm khung nhìn của camera và vị trí mồi. */
+        void renderMinimap(Renderer& renderer) const;
         /**    Vẽ màn hình nhập điểm cao với lớp phủ và ô nhập text. */
-        void renderHighScoreEntry(Renderer& renderer) const;
+        void renderHighScoreEntry(Renderer& renderer);
 
     };
 
@@ -0,0 +1,200 @@
+#include "GlyphAtlas.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace SnakeGame {
+
+    namespace {
+        constexpr std::uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+        constexpr int GLYPH_PADDING = 1;  // Khoảng trống giữa các ô để lọc texture không lấn sang glyph bên cạnh
+
+        /**    Các chữ cái tiếng Việt ngoài ASCII (Latin-1, Latin Extended-A/B) được nướng sẵn cùng dải U+1EA0..U+1EF9. */
+        constexpr std::uint32_t VIETNAMESE_LETTERS[] = {
+            0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C8, 0x00C9, 0x00CA, 0x00CC, 0x00CD, 0x00D2, 0x00D3, 0x00D4, 0x00D5,
+            0x00D9, 0x00DA, 0x00DD, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E8, 0x00E9, 0x00EA, 0x00EC, 0x00ED, 0x00F2,
+            0x00F3, 0x00F4, 0x00F5, 0x00F9, 0x00FA, 0x00FD, 0x0102, 0x0103, 0x0110, 0x0111, 0x0128, 0x0129, 0x0168,
+            0x0169, 0x01A0, 0x01A1, 0x01AF, 0x01B0
+        };
+    }
+
+    std::uint32_t decodeUtf8(std::string_view text, std::size_t& pos) {
+        const auto lead = static_cast<unsigned char>(text[pos++]);
+        if (lead < 0x80) return lead;
+
+        int extra = 0;
+        std::uint32_t codepoint = 0;
+        if ((lead & 0xE0) == 0xC0) { extra = 1; codepoint = lead & 0x1F; }
+        else if ((lead & 0xF0) == 0xE0) { extra = 2; codepoint = lead & 0x0F; }
+        else if ((lead & 0xF8) == 0xF0) { extra = 3; codepoint = lead & 0x07; }
+        else return REPLACEMENT_CHARACTER;
+
+        if (pos + static_cast<std::size_t>(extra) > text.size()) return REPLACEMENT_CHARACTER;
+        for (int i = 0; i < extra; ++i) {
+            const auto next = static_cast<unsigned char>(text[pos + static_cast<std::size_t>(i)]);
+            if ((next & 0xC0) != 0x80) return REPLACEMENT_CHARACTER;
+            codepoint = (codepoint << 6) | (next & 0x3F);
+        }
+        pos += static_cast<std::size_t>(extra);
+        return codepoint <= 0x10FFFF ? codepoint : REPLACEMENT_CHARACTER;
+    }
+
+    std::size_t utf8Length(std::string_view text) {
+        std::size_t count = 0;
+        for (std::size_t pos = 0; pos < text.size(); ++count) {
+            (void)decodeUtf8(text, pos);
+        }
+        return count;
+    }
+
+    GlyphAtlas::GlyphAtlas(SDL_Renderer* renderer, TTF_Font* font, int scale)
+            : renderer(renderer), font(font), scale(scale > 0 ? scale : 1), lineHeight(font ? TTF_FontHeight(font) : 0) {
+        if (!addPage()) {
+            throw RendererError("Failed to create glyph atlas texture: " + std::string(SDL_GetError()));
+        }
+        for (std::uint32_t c = ' '; c <= '~'; ++c) (void)glyph(c);
+        for (std::uint32_t c : VIETNAMESE_LETTERS) (void)glyph(c);
+        for (std::uint32_t c = 0x1EA0; c <= 0x1EF9; ++c) (void)glyph(c);
+        std::cout << "Glyph atlas built: " << glyphs.size() << " glyphs on " << pages.size() << " page(s) of "
+                  << Config::GLYPH_ATLAS_PAGE_SIZE << "x" << Config::GLYPH_ATLAS_PAGE_SIZE << std::endl;
+    }
+
+    bool GlyphAtlas::addPage() {
+        const int size = Config::GLYPH_ATLAS_PAGE_SIZE;
+        Page page;
+        page.texture.reset(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size));
+        if (!page.texture) return false;
+        SDL_SetTextureBlendMode(page.texture.get(), SDL_BLENDMODE_BLEND);
+        // Nội dung ban đầu của texture không xác định: xóa thành trong suốt một lần
+        const std::vector<std::uint32_t> transparent(static_cast<std::size_t>(size) * static_cast<std::size_t>(size), 0);
+        SDL_UpdateTexture(page.texture.get(), nullptr, transparent.data(), size * static_cast<int>(sizeof(std::uint32_t)));
+        pages.push_back(std::move(page));
+        return true;
+    }
+
+    const GlyphAtlas::Glyph& GlyphAtlas::glyph(std::uint32_t codepoint) {
+        auto it = glyphs.find(codepoint);
+        if (it != glyphs.end()) return it->second;
+        if (codepoint != '?' && (codepoint > 0xFFFF || !TTF_GlyphIsProvided32(font, codepoint))) {
+            const Glyph fallback = glyph('?');
+            return glyphs.emplace(codepoint, fallback).first->second;
+        }
+        return glyphs.emplace(codepoint, rasterize(codepoint)).first->second;
+    }
+
+    GlyphAtlas::Glyph GlyphAtlas::rasterize(std::uint32_t codepoint) {
+        Glyph result;
+        int minX = 0, maxX = 0, minY = 0, maxY = 0;
+        if (TTF_GlyphMetrics32(font, codepoint, &minX, &maxX, &minY, &maxY, &result.advance) != 0) {
+            std::cerr << "Warning: TTF_GlyphMetrics32 failed for U+" << std::hex << codepoint << std::dec << ": " << TTF_GetError() << std::endl;
+            return result;
+        }
+
+        SDL_Surface* surface = TTF_RenderGlyph32_Blended(font, codepoint, {255, 255, 255, 255});
+        if (!surface) return result; // Khoảng trắng: không có điểm ảnh, chỉ có advance
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(surface);
+        if (!converted) {
+            std::cerr << "Warning: Could not convert glyph surface for U+" << std::hex << codepoint << std::dec << ": " << SDL_GetError() << std::endl;
+            return result;
+        }
+
+        const int size = Config::GLYPH_ATLAS_PAGE_SIZE;
+        const int w = converted->w;
+        const int h = converted->h;
+        if (w <= 0 || h <= 0 || w + GLYPH_PADDING > size || h + GLYPH_PADDING > size) {
+            SDL_FreeSurface(converted);
+            return result;
+        }
+
+        Page* page = &pages.back();
+        if (page->cursorX + w + GLYPH_PADDING > size) {
+            page->cursorX = 0;
+            page->cursorY += page->rowHeight;
+            page->rowHeight = 0;
+        }
+        if (page->cursorY + h + GLYPH_PADDING > size) {
+            if (!addPage()) {
+                std::cerr << "Warning: Glyph atlas is full and a new page could not be created: " << SDL_GetError() << std::endl;
+                SDL_FreeSurface(converted);
+                return result;
+            }
+            page = &pages.back();
+        }
+
+        result.page = static_cast<int>(pages.size()) - 1;
+        result.src = {page->cursorX, page->cursorY, w, h};
+        SDL_UpdateTexture(page->texture.get(), &result.src, converted->pixels, converted->pitch);
+        SDL_FreeSurface(converted);
+
+        page->cursorX += w + GLYPH_PADDING;
+        page->rowHeight = std::max(page->rowHeight, h + GLYPH_PADDING);
+        return result;
+    }
+
+    int GlyphAtlas::kerning(std::uint32_t previous, std::uint32_t codepoint) const {
+        if (previous == 0) return 0;
+        return TTF_GetFontKerningSizeGlyphs32(font, previous, codepoint);
+    }
+
+    void GlyphAtlas::appendText(std::string_view text, float x, float y, SDL_Color color) {
+        const float inverseScale = 1.0f / static_cast<float>(scale);
+        const float texel = 1.0f / static_cast<float>(Config::GLYPH_ATLAS_PAGE_SIZE);
+        int penX = 0;
+        std::uint32_t previous = 0;
+        for (std::size_t pos = 0; pos < text.size();) {
+            const std::uint32_t codepoint = decodeUtf8(text, pos);
+            const Glyph& g = glyph(codepoint);
+            penX += kerning(previous, codepoint);
+            previous = codepoint;
+
+            if (g.page >= 0) {
+                Page& page = pages[static_cast<std::size_t>(g.page)];
+                const float left = x + static_cast<float>(penX) * inverseScale;
+                const float top = y;
+                const float right = left + static_cast<float>(g.src.w) * inverseScale;
+                const float bottom = top + static_cast<float>(g.src.h) * inverseScale;
+                const float u0 = static_cast<float>(g.src.x) * texel;
+                const float v0 = static_cast<float>(g.src.y) * texel;
+                const float u1 = static_cast<float>(g.src.x + g.src.w) * texel;
+                const float v1 = static_cast<float>(g.src.y + g.src.h) * texel;
+
+                const int base = static_cast<int>(page.vertices.size());
+                page.vertices.push_back({{left, top}, color, {u0, v0}});
+                page.vertices.push_back({{right, top}, color, {u1, v0}});
+                page.vertices.push_back({{right, bottom}, color, {u1, v1}});
+                page.vertices.push_back({{left, bottom}, color, {u0, v1}});
+                for (int corner : {0, 1, 2, 0, 2, 3}) page.indices.push_back(base + corner);
+                ++pendingQuads;
+            }
+            penX += g.advance;
+        }
+    }
+
+    SDL_Point GlyphAtlas::measure(std::string_view text) {
+        if (text.empty()) return {0, 0};
+        int penX = 0;
+        std::uint32_t previous = 0;
+        for (std::size_t pos = 0; pos < text.size();) {
+            const std::uint32_t codepoint = decodeUtf8(text, pos);
+            penX += kerning(previous, codepoint) + glyph(codepoint).advance;
+            previous = codepoint;
+        }
+        return {penX / scale, lineHeight / scale};
+    }
+
+    void GlyphAtlas::flush() {
+        if (pendingQuads == 0) return;
+        for (Page& page : pages) {
+            if (page.indices.empty()) continue;
+            if (SDL_RenderGeometry(renderer, page.texture.get(), page.vertices.data(), static_cast<int>(page.vertices.size()),
+                                   page.indices.data(), static_cast<int>(page.indices.size())) != 0) {
+                std::cerr << "Warning: SDL_RenderGeometry failed for text batch: " << SDL_GetError() << std::endl;
+            }
+            page.vertices.clear();
+            page.indices.clear();
+        }
+        pendingQuads = 0;
+    }
+
+}
@@ -0,0 +1,95 @@
+#ifndef GLYPH_ATLAS_HPP
+#define GLYPH_ATLAS_HPP
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Renderer.hpp"
+
+namespace SnakeGame {
+
+    /**
+     *    Giải mã một ký tự UTF-8 bắt đầu tại text[pos] và đưa pos tới ký tự tiếp theo.
+     *        Chuỗi byte sai định dạng được đọc thành U+FFFD (mỗi byte lỗi một ký tự), nên vòng lặp luôn tiến.
+     */
+    [[nodiscard]] std::uint32_t decodeUtf8(std::string_view text, std::size_t& pos);
+
+    /**    Số ký tự (code point) của một chuỗi UTF-8. */
+    [[nodiscard]] std::size_t utf8Length(std::string_view text);
+
+    /**
+     *    GlyphAtlas
+     *    Bảng glyph của một font ở một kích thước: mỗi glyph được rasterize đúng một lần (TTF_RenderGlyph32_Blended,
+     *        màu trắng) và tải lên một ô trong các trang texture GLYPH_ATLAS_PAGE_SIZE x GLYPH_ATLAS_PAGE_SIZE.
+     *        ASCII và các chữ cái tiếng Việt được nướng sẵn khi tạo; ký tự khác được thêm khi gặp lần đầu.
+     *        Vẽ chữ chỉ thêm các quad (màu chữ nằm ở màu đỉnh) vào batch của trang tương ứng; flush() gửi mỗi trang
+     *        bằng một lệnh SDL_RenderGeometry, nên mỗi frame không còn rasterize hay tải texture cho chữ.
+     *        Glyph được rasterize ở kích thước lớn (font của Renderer) và thu nhỏ theo scale khi vẽ (supersampling).
+     */
+    class GlyphAtlas {
+    public:
+        /**
+         *    Tạo atlas cho font (đã mở ở kích thước render) và nướng sẵn các glyph thường dùng.
+         *    scale Tỷ lệ giữa kích thước render của font và kích thước hiển thị (FONT_RENDER_SCALE).
+         * @throws RendererError Nếu không tạo được trang texture đầu tiên.
+         */
+        GlyphAtlas(SDL_Renderer* renderer, TTF_Font* font, int scale);
+
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+        /**    Thêm các quad của text (UTF-8) vào batch, góc trên trái tại (x, y) theo pixel màn hình. */
+        void appendText(std::string_view text, float x, float y, SDL_Color color);
+
+        /**    Kích thước hiển thị (rộng, cao) của text, tính cùng cách với appendText. */
+        [[nodiscard]] SDL_Point measure(std::string_view text);
+
+        /**    Vẽ toàn bộ quad đang chờ (một lệnh vẽ cho mỗi trang có quad) rồi xóa batch. */
+        void flush();
+
+        [[nodiscard]] bool hasPending() const { return pendingQuads > 0; }
+        [[nodiscard]] std::size_t getGlyphCount() const { return glyphs.size(); }
+        [[nodiscard]] std::size_t getPageCount() const { return pages.size(); }
+
+    private:
+        struct Glyph {
+            int page = -1;          // -1: glyph rỗng (khoảng trắng), chỉ có advance
+            SDL_Rect src = {0, 0, 0, 0};
+            int advance = 0;        // Theo pixel của font render (chưa chia scale)
+        };
+
+        struct Page {
+            std::unique_ptr<SDL_Texture, SDLTextureDestroyer> texture;
+            int cursorX = 0;
+            int cursorY = 0;
+            int rowHeight = 0;
+            std::vector<SDL_Vertex> vertices;
+            std::vector<int> indices;
+        };
+
+        SDL_Renderer* renderer;
+        TTF_Font* font;
+        int scale;
+        int lineHeight;
+        std::unordered_map<std::uint32_t, Glyph> glyphs;
+        std::vector<Page> pages;
+        std::size_t pendingQuads = 0;
+
+        /**    Glyph của một code point, rasterize khi gặp lần đầu; ký tự font không có được thay bằng '?'. */
+        const Glyph& glyph(std::uint32_t codepoint);
+        /**    Rasterize và tải một glyph lên trang còn chỗ (mở trang mới khi cần). */
+        Glyph rasterize(std::uint32_t codepoint);
+        /**    Thêm một trang texture trong suốt mới; false nếu SDL không tạo được. */
+        bool addPage();
+        /**    Khoảng kerning (pixel font render) giữa hai ký tự liền nhau, 0 nếu font không có. */
+        int kerning(std::uint32_t previous, std::uint32_t codepoint) const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include "InputLatency.hpp"
+#include "Config.hpp"
+
+namespace SnakeGame {
+
+    InputLatencyMonitor::InputLatencyMonitor(std::uint64_t counterFrequency)
+            : millisecondsPerTick(counterFrequency > 0 ? 1000.0 / static_cast<double>(counterFrequency) : 0.0) {
+        recentSamples.reserve(Config::INPUT_LATENCY_WINDOW);
+    }
+
+    double InputLatencyMonitor::toMilliseconds(std::uint64_t from, std::uint64_t to) const {
+        return to > from ? static_cast<double>(to - from) * millisecondsPerTick : 0.0;
+    }
+
+    void InputLatencyMonitor::onInputApplied(std::uint64_t stamp, std::uint64_t appliedAt) {
+        if (stamp == 0) return;
+        pending.push_back({stamp, appliedAt});
+    }
+
+    void InputLatencyMonitor::onPresent(std::uint64_t presentedAt) {
+        for (const PendingInput& input : pending) {
+            const double latency = toMilliseconds(input.stamp, presentedAt);
+            if (recentSamples.size() < Config::INPUT_LATENCY_WINDOW) {
+                recentSamples.push_back(latency);
+            } else {
+                recentSamples[recentNext] = latency;
+                recentNext = (recentNext + 1) % recentSamples.size();
+            }
+            presentSamples.push_back(latency);
+            applySamples.push_back(toMilliseconds(input.stamp, input.appliedAt));
+        }
+        pending.clear();
+    }
+
+    SampleStats InputLatencyMonitor::recentStats() const {
+        std::vector<double> values = recentSamples; // SampleStats::of sắp xếp tại chỗ
+        return SampleStats::of(values);
+    }
+
+    SampleStats InputLatencyMonitor::sessionStats() const {
+        std::vector<double> values = presentSamples;
+        return SampleStats::of(values);
+    }
+
+    SampleStats InputLatencyMonitor::sessionApplyStats() const {
+        std::vector<double> values = applySamples;
+        return SampleStats::of(values);
+    }
+
+}
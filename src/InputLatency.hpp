@@ -0,0 +1,59 @@
+#ifndef INPUT_LATENCY_HPP
+#define INPUT_LATENCY_HPP
+
+#include "SampleStats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    InputLatencyMonitor
+     *    Đo độ trễ từ lúc một phím hướng được đọc khỏi hàng đợi sự kiện (main.cpp) tới bước mô phỏng áp dụng nó
+     *        và tới lần present đầu tiên hiển thị kết quả. Nhãn thời gian là giá trị của bộ đếm hiệu năng
+     *        (SDL_GetPerformanceCounter), đi kèm lệnh qua Simulation::queueDirection -> Snake::queueDirectionChange.
+     *        Giữ một cửa sổ trượt cho overlay (F3) và toàn bộ mẫu của phiên cho bản tóm tắt khi thoát.
+     */
+    class InputLatencyMonitor {
+    public:
+        /**    counterFrequency Số nhịp của bộ đếm trong một giây (SDL_GetPerformanceFrequency). */
+        explicit InputLatencyMonitor(std::uint64_t counterFrequency);
+
+        /**    Ghi nhận một lệnh vừa được bước mô phỏng áp dụng (stamp 0 bị bỏ qua); nó sẽ được đo ở lần present tiếp theo. */
+        void onInputApplied(std::uint64_t stamp, std::uint64_t appliedAt);
+
+        /**    Gọi ngay sau present: mọi lệnh đã áp dụng mà chưa hiển thị trở thành một mẫu độ trễ. */
+        void onPresent(std::uint64_t presentedAt);
+
+        /**    Thống kê (ms) input -> present trên cửa sổ trượt Config::INPUT_LATENCY_WINDOW mẫu gần nhất. */
+        [[nodiscard]] SampleStats recentStats() const;
+
+        /**    Thống kê (ms) input -> present trên mọi mẫu của phiên. */
+        [[nodiscard]] SampleStats sessionStats() const;
+
+        /**    Thống kê (ms) input -> bước áp dụng trên mọi mẫu của phiên (thời gian chờ trong bộ đệm input). */
+        [[nodiscard]] SampleStats sessionApplyStats() const;
+
+        /**    Tổng số mẫu đã đo trong phiên (tăng mỗi khi có mẫu mới, dùng làm khóa dựng lại overlay). */
+        [[nodiscard]] std::size_t sampleCount() const { return presentSamples.size(); }
+
+    private:
+        struct PendingInput {
+            std::uint64_t stamp = 0;
+            std::uint64_t appliedAt = 0;
+        };
+
+        [[nodiscard]] double toMilliseconds(std::uint64_t from, std::uint64_t to) const;
+
+        double millisecondsPerTick;
+        std::vector<PendingInput> pending;   // Đã áp dụng, chưa present
+        std::vector<double> recentSamples;   // Bộ đệm vòng input -> present (ms)
+        std::size_t recentNext = 0;
+        std::vector<double> presentSamples;  // Cả phiên: input -> present (ms)
+        std::vector<double> applySamples;    // Cả phiên: input -> bước áp dụng (ms)
+    };
+
+}
+
+#endif
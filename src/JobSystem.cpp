@@ -0,0 +1,124 @@
+#include "JobSystem.hpp"
+#include <chrono>
+
+namespace SnakeGame {
+
+    namespace {
+        thread_local const JobSystem* currentSystem = nullptr;
+        thread_local unsigned currentIndex = 0;
+
+        constexpr int SPIN_ROUNDS = 64;  // Số lần thử lấy việc trước khi worker đi ngủ
+        constexpr auto SLEEP_TIMEOUT = std::chrono::milliseconds(2);
+    }
+
+    JobSystem::JobSystem(unsigned threadCount) {
+        if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+        queues.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<WorkerQueue>());
+        workers.reserve(threadCount - 1);
+        for (unsigned i = 1; i < threadCount; ++i) {
+            workers.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true);
+        }
+        sleepWake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    unsigned JobSystem::currentQueue() const {
+        return currentSystem == this ? currentIndex : 0;
+    }
+
+    void JobSystem::run(TaskGroup& group, std::function<void()> job) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        WorkerQueue& queue = *queues[currentQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back({std::move(job), &group});
+        }
+        queuedJobs.fetch_add(1);
+        // Chỉ đánh thức khi có worker đang ngủ; thứ tự seq_cst giữa queuedJobs và sleepingWorkers tránh mất tín hiệu
+        if (sleepingWorkers.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepWake.notify_one();
+        }
+    }
+
+    bool JobSystem::tryPop(unsigned self, Job& out) {
+        {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.jobs.empty()) {
+                out = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                return true;
+            }
+        }
+        const unsigned count = static_cast<unsigned>(queues.size());
+        for (unsigned offset = 1; offset < count; ++offset) {
+            WorkerQueue& victim = *queues[(self + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.jobs.empty()) {
+                out = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool JobSystem::runOne(unsigned self) {
+        if (queuedJobs.load(std::memory_order_relaxed) == 0) return false;
+        Job job;
+        if (!tryPop(self, job)) return false;
+        queuedJobs.fetch_sub(1);
+        job.fn();
+        job.group->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void JobSystem::wait(TaskGroup& group) {
+        const unsigned self = currentQueue();
+        while (!group.isDone()) {
+            if (!runOne(self)) std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::splitRange(TaskGroup& group, const std::function<void(std::size_t, std::size_t)>& body,
+                               std::size_t begin, std::size_t end, std::size_t grain) {
+        while (end - begin > grain) {
+            const std::size_t mid = begin + (end - begin) / 2;
+            run(group, [this, &group, &body, mid, end, grain] { splitRange(group, body, mid, end, grain); });
+            end = mid;
+        }
+        body(begin, end);
+    }
+
+    void JobSystem::workerLoop(unsigned index) {
+        currentSystem = this;
+        currentIndex = index;
+        int idleRounds = 0;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            if (runOne(index)) {
+                idleRounds = 0;
+                continue;
+            }
+            if (++idleRounds < SPIN_ROUNDS) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepingWorkers.fetch_add(1);
+            sleepWake.wait_for(lock, SLEEP_TIMEOUT, [this] { return stopping.load() || queuedJobs.load() > 0; });
+            sleepingWorkers.fetch_sub(1);
+            idleRounds = 0;
+        }
+    }
+
+}
@@ -0,0 +1,144 @@
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    TaskGroup
+     *    Bộ đếm các công việc chưa xong của một lần fork; JobSystem::wait() chờ nó về 0.
+     *        Phải sống lâu hơn mọi công việc được giao qua nó (thường là biến cục bộ quanh một lần run/wait).
+     */
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        [[nodiscard]] bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<std::size_t> pending{0};
+    };
+
+    /**
+     *    JobSystem
+     *    Hệ thống công việc work-stealing cho các tác vụ lô phía mô phỏng (quét seed, kiểm tra replay, giải đấu bot...),
+     *        không phụ thuộc SDL.
+     *        Mỗi luồng có một hàng đợi hai đầu riêng: luồng chủ đẩy/lấy ở cuối (LIFO, giữ dữ liệu nóng trong cache),
+     *        luồng rảnh trộm ở đầu hàng đợi của luồng khác (FIFO, lấy được khối việc lớn nhất).
+     *        Luồng gọi wait() không ngồi chờ mà cũng thực thi công việc, nên fork/join lồng nhau không bị kẹt.
+     *        parallelFor() chia đôi dải chỉ số một cách đệ quy: các nửa chưa làm nằm trong hàng đợi chờ bị trộm.
+     *        Thân vòng lặp phải chỉ ghi vào dữ liệu riêng của chỉ số đó để kết quả không phụ thuộc số luồng.
+     */
+    class JobSystem {
+    public:
+        /**
+         *    Tạo hệ thống công việc.
+         *    threadCount Tổng số luồng tham gia (bao gồm luồng gọi). 0 = số nhân CPU.
+         */
+        explicit JobSystem(unsigned threadCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /**    Tổng số luồng tham gia (bao gồm luồng gọi). */
+        [[nodiscard]] unsigned getThreadCount() const { return static_cast<unsigned>(queues.size()); }
+
+        /**
+         *    Giao một công việc vào hàng đợi của luồng hiện tại (fork).
+         *    group Nhóm sẽ được wait() sau đó.
+         *    job Công việc.
+         */
+        void run(TaskGroup& group, std::function<void()> job);
+
+        /**    Chờ mọi công việc của group xong (join), trong lúc chờ thì thực thi công việc khác. */
+        void wait(TaskGroup& group);
+
+        /**
+         *    Chạy song song hai công việc và chờ cả hai: b được giao cho luồng khác trộm, a chạy ngay trên luồng gọi.
+         */
+        template <typename A, typename B>
+        void forkJoin(A&& a, B&& b) {
+            if (workers.empty()) {
+                a();
+                b();
+                return;
+            }
+            TaskGroup group;
+            run(group, [&b] { b(); });
+            a();
+            wait(group);
+        }
+
+        /**
+         *    Gọi fn(i) cho mọi i trong [0, count), phân phối trên các luồng bằng cách chia đôi đệ quy.
+         *    count Số phần tử.
+         *    fn Thân vòng lặp.
+         *    grain Kích thước khối nhỏ nhất không chia tiếp.
+         */
+        template <typename Fn>
+        void parallelFor(std::size_t count, Fn&& fn, std::size_t grain = 1) {
+            if (count == 0) return;
+            if (grain == 0) grain = 1;
+            if (workers.empty() || count <= grain) {
+                for (std::size_t i = 0; i < count; ++i) fn(i);
+                return;
+            }
+            const std::function<void(std::size_t, std::size_t)> body = [&fn](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) fn(i);
+            };
+            TaskGroup group;
+            splitRange(group, body, 0, count, grain);
+            wait(group);
+        }
+
+    private:
+        struct Job {
+            std::function<void()> fn;
+            TaskGroup* group = nullptr;
+        };
+
+        // Hàng đợi của một luồng; căn theo dòng cache để khóa của các luồng không chia sẻ dòng cache
+        struct alignas(64) WorkerQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues; // queues[0]: luồng ngoài (luồng gọi), queues[i]: worker i
+        std::vector<std::thread> workers;
+
+        std::atomic<std::size_t> queuedJobs{0};  // Tổng số công việc đang nằm trong các hàng đợi
+        std::atomic<unsigned> sleepingWorkers{0};
+        std::mutex sleepMutex;
+        std::condition_variable sleepWake;
+        std::atomic<bool> stopping{false};
+
+        /**    Chỉ số hàng đợi của luồng hiện tại (0 nếu không phải worker của hệ thống này). */
+        [[nodiscard]] unsigned currentQueue() const;
+        /**    Lấy một công việc: từ cuối hàng đợi của mình, nếu trống thì trộm đầu hàng đợi khác. */
+        bool tryPop(unsigned self, Job& out);
+        /**    Thực thi một công việc nếu có; false nếu mọi hàng đợi đều trống. */
+        bool runOne(unsigned self);
+        /**    Giao nửa trên của [begin, end) cho hàng đợi cho tới khi khối còn lại không lớn hơn grain, rồi xử lý khối đó. */
+        void splitRange(TaskGroup& group, const std::function<void(std::size_t, std::size_t)>& body,
+                        std::size_t begin, std::size_t end, std::size_t grain);
+        /**    Vòng lặp của mỗi worker. */
+        void workerLoop(unsigned index);
+    };
+
+}
+
+#endif
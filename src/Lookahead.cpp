@@ -0,0 +1,209 @@
+#include "Lookahead.hpp"
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace SnakeGame {
+
+    namespace {
+        constexpr float DEATH_VALUE = -1.0e6f;    // Rắn chết (cộng thêm số nước đã sống để chết muộn tốt hơn)
+        constexpr float FOOD_REWARD = 1000.0f;    // Mỗi điểm ăn được
+        constexpr float TRAP_PENALTY = -2.0e4f;   // Vùng trống quanh đầu nhỏ hơn chiều dài thân
+        constexpr float SPACE_WEIGHT = 2.0f;      // Mỗi ô trống tới được (tới giới hạn)
+        constexpr float DISTANCE_WEIGHT = 1.0f;   // Mỗi ô khoảng cách tới mồi
+        constexpr float DISCOUNT = 0.98f;         // Ăn sớm tốt hơn ăn muộn
+        constexpr std::uint64_t CHANCE_SALT = 0x5851F42D4C957F2Dull;
+        constexpr Direction DIRECTIONS[4] = {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT};
+
+        /**    Hướng ngược lại (thứ tự Direction: UP, DOWN, LEFT, RIGHT). */
+        Direction opposite(Direction dir) {
+            return static_cast<Direction>(static_cast<int>(dir) ^ 1);
+        }
+    }
+
+    LookaheadAgent::LookaheadAgent() : table(std::size_t{1} << Config::LOOKAHEAD_TABLE_BITS) {}
+
+    Direction LookaheadAgent::chooseDirection(const Simulation& sim) {
+        const Direction current = sim.getSnake().getCurrentDirection();
+        if (sim.isGameOver()) return current;
+        ++stats.decisions;
+        ++generation;
+
+        const std::size_t levels = static_cast<std::size_t>(Config::LOOKAHEAD_MAX_DEPTH) + 1;
+        if (stack.size() != levels || stack[0].getBoardWidth() != sim.getBoardWidth() || stack[0].getBoardHeight() != sim.getBoardHeight()) {
+            stack.assign(levels, sim);
+            for (Simulation& level : stack) level.setGridChangeTracking(false); // Bản sao không cần nhật ký thay đổi của minimap
+        }
+        aborted = false;
+        budgetActive = false;
+        nodeLimit = stats.nodes + nodeBudget;
+        const auto budget = std::chrono::duration<double, std::milli>(sim.stepIntervalMs() * Config::LOOKAHEAD_BUDGET_FRACTION);
+        deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+
+        Direction best = current;
+        for (int depth = 1; depth <= Config::LOOKAHEAD_MAX_DEPTH; ++depth) {
+            float totals[4] = {};
+            for (int sample = 0; sample < Config::LOOKAHEAD_SAMPLES && !aborted; ++sample) {
+                // Cùng hạt giống cho cùng mẫu ở mọi nước, để giá trị trong bảng dùng lại được giữa các nước liên tiếp
+                sampleKey = OccupancyGrid::zobristKey(sample, CellTag::Obstacle) * CHANCE_SALT;
+                stack[0].copyStateFrom(sim);
+                stack[0].reseedChance(CHANCE_SALT + static_cast<std::uint64_t>(sample));
+                for (Direction dir : DIRECTIONS) {
+                    if (dir == opposite(current)) continue;
+                    totals[static_cast<int>(dir)] += expand(0, dir, depth);
+                    if (aborted) break;
+                }
+            }
+            if (aborted) break; // Độ sâu chưa tìm xong: giữ kết quả của độ sâu trước
+
+            float bestValue = 0.0f;
+            bool found = false;
+            for (Direction dir : DIRECTIONS) {
+                if (dir == opposite(current)) continue;
+                if (!found || totals[static_cast<int>(dir)] > bestValue) {
+                    bestValue = totals[static_cast<int>(dir)];
+                    best = dir;
+                    found = true;
+                }
+            }
+            stats.depthSum += 1;
+            budgetActive = true;
+        }
+        return best;
+    }
+
+    float LookaheadAgent::expand(int level, Direction dir, int remaining) {
+        const Simulation& parent = stack[static_cast<std::size_t>(level)];
+        Simulation& child = stack[static_cast<std::size_t>(level) + 1];
+        child.copyStateFrom(parent);
+        ++stats.nodes;
+        const StepResult result = child.step({dir, false});
+        if (result.gameOver) return DEATH_VALUE + static_cast<float>(level);
+
+        const float reward = static_cast<float>(child.getScore() - parent.getScore()) * FOOD_REWARD;
+        if (remaining <= 1 || outOfBudget()) return reward + evaluate(child);
+        return reward + DISCOUNT * searchNode(level + 1, remaining - 1);
+    }
+
+    float LookaheadAgent::searchNode(int level, int remaining) {
+        const Simulation& node = stack[static_cast<std::size_t>(level)];
+        const std::uint64_t key = node.stateHash() ^ sampleKey;
+        TableEntry& entry = table[key & (table.size() - 1)];
+        Direction first = node.getSnake().getCurrentDirection();
+        if (entry.key == key) {
+            if (entry.depth >= remaining) {
+                ++stats.tableHits;
+                return entry.value;
+            }
+            first = static_cast<Direction>(entry.bestDir);
+        }
+
+        const Direction back = opposite(node.getSnake().getCurrentDirection());
+        float bestValue = DEATH_VALUE;
+        Direction bestDir = first;
+        bool found = false;
+        // Nước tốt nhất của lần tìm trước (hoặc đi thẳng) được thử trước
+        auto visit = [&](Direction dir) {
+            const float value = expand(level, dir, remaining);
+            if (!found || value > bestValue) {
+                bestValue = value;
+                bestDir = dir;
+                found = true;
+            }
+        };
+        if (first != back) visit(first);
+        for (Direction dir : DIRECTIONS) {
+            if (aborted) break;
+            if (dir == back || dir == first) continue;
+            visit(dir);
+        }
+
+        // Giá trị tìm dở (hết ngân sách) không được ghi vào bảng
+        if (!aborted && (entry.key == key || entry.generation != generation || entry.depth <= remaining)) {
+            entry.key = key;
+            entry.value = bestValue;
+            entry.depth = static_cast<std::uint8_t>(remaining);
+            entry.bestDir = static_cast<std::uint8_t>(bestDir);
+            entry.generation = generation;
+        }
+        return bestValue;
+    }
+
+    float LookaheadAgent::evaluate(const Simulation& sim) {
+        const int length = static_cast<int>(sim.getSnake().getBody().size());
+        const int limit = 2 * length + 8;
+        const int space = floodCount(sim, limit);
+        float value = static_cast<float>(space) * SPACE_WEIGHT;
+        if (space < length) value += TRAP_PENALTY * (1.0f - static_cast<float>(space) / static_cast<float>(length));
+
+        const Point head = sim.getSnake().getHeadPosition();
+        const Point food = sim.getFoodPosition();
+        if (food.x >= 0) {
+            int dx = std::abs(head.x - food.x);
+            int dy = std::abs(head.y - food.y);
+            if (sim.getMode() == GameMode::PortalWalls) {
+                dx = std::min(dx, sim.getBoardWidth() - dx);
+                dy = std::min(dy, sim.getBoardHeight() - dy);
+            }
+            value -= static_cast<float>(dx + dy) * DISTANCE_WEIGHT;
+        }
+        return value;
+    }
+
+    int LookaheadAgent::floodCount(const Simulation& sim, int limit) {
+        const OccupancyGrid& grid = sim.getGrid();
+        const int width = grid.getWidth();
+        const int height = grid.getHeight();
+        const bool wrap = sim.getMode() == GameMode::PortalWalls;
+        if (visitStamp.size() != static_cast<std::size_t>(grid.getCellCount())) {
+            visitStamp.assign(static_cast<std::size_t>(grid.getCellCount()), 0);
+            stamp = 0;
+        }
+        if (++stamp == 0) {
+            std::fill(visitStamp.begin(), visitStamp.end(), 0);
+            stamp = 1;
+        }
+
+        const Point head = sim.getSnake().getHeadPosition();
+        if (!grid.contains(head.x, head.y)) return 0;
+        frontier.clear();
+        frontier.push_back(grid.indexOf(head));
+        visitStamp[static_cast<std::size_t>(frontier.back())] = stamp;
+        int count = 0;
+        for (std::size_t i = 0; i < frontier.size() && count < limit; ++i) {
+            const int cell = frontier[i];
+            const int x = cell % width;
+            const int y = cell / width;
+            const int neighbours[4][2] = {{x, y - 1}, {x, y + 1}, {x - 1, y}, {x + 1, y}};
+            for (const auto& next : neighbours) {
+                int nx = next[0];
+                int ny = next[1];
+                if (wrap) {
+                    nx = (nx + width) % width;
+                    ny = (ny + height) % height;
+                } else if (!grid.contains(nx, ny)) {
+                    continue;
+                }
+                const int index = grid.indexOf(nx, ny);
+                if (visitStamp[static_cast<std::size_t>(index)] == stamp) continue;
+                visitStamp[static_cast<std::size_t>(index)] = stamp;
+                if (grid.test(index, CellTag::Snake) || grid.test(index, CellTag::Obstacle)) continue;
+                frontier.push_back(index);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    bool LookaheadAgent::outOfBudget() {
+        if (aborted) return true;
+        if (!budgetActive) return false;
+        if (nodeBudget > 0) {
+            aborted = stats.nodes >= nodeLimit;
+        } else if ((stats.nodes & 63) == 0) {
+            aborted = std::chrono::steady_clock::now() >= deadline;
+        }
+        return aborted;
+    }
+
+}
@@ -0,0 +1,92 @@
+#ifndef LOOKAHEAD_HPP
+#define LOOKAHEAD_HPP
+
+#include "Simulation.hpp"
+#include "CoreConfig.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    LookaheadStats
+     *    Bộ đếm cộng dồn của LookaheadAgent.
+     */
+    struct LookaheadStats {
+        std::uint64_t decisions = 0;
+        std::uint64_t nodes = 0;          // Số bản sao đã bước (mỗi nút một lần chép trạng thái + step())
+        std::uint64_t tableHits = 0;      // Số nút lấy giá trị từ bảng chuyển vị thay vì tìm tiếp
+        std::uint64_t depthSum = 0;       // Tổng độ sâu đã tìm xong của mọi nước
+    };
+
+    /**
+     *    LookaheadAgent
+     *    Bot tìm kiếm nhiều bước (expectimax lấy mẫu) cho độ khó cao: đào sâu dần tới LOOKAHEAD_MAX_DEPTH
+     *        cho tới khi hết ngân sách thời gian (tỷ lệ LOOKAHEAD_BUDGET_FRACTION của stepIntervalMs()) hoặc ngân sách nút.
+     *        Mỗi nút là một bản sao Simulation: mỗi tầng có sẵn một Simulation, chép từ tầng cha bằng
+     *        Simulation::copyStateFrom (chỉ memcpy, không cấp phát), rồi step() một nước.
+     *        Các khả năng ngẫu nhiên (vị trí mồi mới, vật cản) được lấy mẫu bằng LOOKAHEAD_SAMPLES lần gieo lại
+     *        bộ sinh số của bản sao gốc; giá trị một nước là trung bình của các mẫu.
+     *        Bảng chuyển vị khóa theo Simulation::stateHash() (Zobrist, cập nhật tăng dần) lưu giá trị và nước tốt nhất,
+     *        dùng lại giữa các lần đào sâu và giữa các nước liên tiếp.
+     */
+    class LookaheadAgent {
+    public:
+        LookaheadAgent();
+
+        /**
+         *    Chọn hướng cho bước tiếp theo của sim, tìm trong ngân sách hiện tại.
+         *        Nếu ngân sách hết giữa chừng, dùng kết quả của độ sâu đã tìm xong gần nhất.
+         */
+        [[nodiscard]] Direction chooseDirection(const Simulation& sim);
+
+        /**    > 0: giới hạn số nút mỗi nước thay cho thời gian (kết quả tất định, dùng cho soak test/giải đấu). */
+        void setNodeBudget(std::uint64_t nodes) { nodeBudget = nodes; }
+
+        [[nodiscard]] const LookaheadStats& getStats() const { return stats; }
+
+    private:
+        struct TableEntry {
+            std::uint64_t key = 0;
+            float value = 0.0f;
+            std::uint8_t depth = 0;       // Số nước còn lại khi giá trị được tính
+            std::uint8_t bestDir = 0;
+            std::uint16_t generation = 0; // Lượt chọn hướng đã ghi mục này (mục cũ được thay trước)
+        };
+
+        std::vector<Simulation> stack;    // stack[d]: trạng thái sau d nước tính từ gốc
+        std::vector<TableEntry> table;
+        std::uint16_t generation = 0;
+        std::uint64_t sampleKey = 0;      // Trộn vào khóa bảng để các mẫu ngẫu nhiên không dùng chung giá trị
+
+        // Ngân sách của lần chọn hướng hiện tại
+        std::uint64_t nodeBudget = 0;
+        std::uint64_t nodeLimit = 0;
+        std::chrono::steady_clock::time_point deadline;
+        bool budgetActive = false;        // Độ sâu 1 luôn được tìm xong, ngân sách chỉ áp dụng từ độ sâu 2
+        bool aborted = false;
+
+        // Bộ đệm cho đếm vùng trống khi đánh giá lá
+        std::vector<std::uint32_t> visitStamp;
+        std::uint32_t stamp = 0;
+        std::vector<int> frontier;
+
+        LookaheadStats stats;
+
+        /**    Giá trị của nút stack[level] khi còn remaining nước (lớn nhất trên các hướng đi được). */
+        float searchNode(int level, int remaining);
+        /**    Đi hướng dir từ stack[level] vào stack[level + 1] và trả về phần thưởng + giá trị phần còn lại. */
+        float expand(int level, Direction dir, int remaining);
+        /**    Đánh giá tĩnh của một trạng thái lá: vùng trống quanh đầu rắn và khoảng cách tới mồi. */
+        float evaluate(const Simulation& sim);
+        /**    Số ô trống tới được từ đầu rắn (coi thân rắn là cố định), dừng khi đạt limit. */
+        int floodCount(const Simulation& sim, int limit);
+        /**    true nếu đã hết ngân sách thời gian/nút (kiểm tra đồng hồ mỗi 64 nút). */
+        bool outOfBudget();
+    };
+
+}
+
+#endif
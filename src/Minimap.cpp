@@ -0,0 +1,93 @@
+#include "Minimap.hpp"
+#include "Config.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace SnakeGame {
+
+    namespace {
+        Uint32 packColor(SDL_Color color) {
+            return (static_cast<Uint32>(color.a) << 24) | (static_cast<Uint32>(color.r) << 16) |
+                   (static_cast<Uint32>(color.g) << 8) | static_cast<Uint32>(color.b);
+        }
+    }
+
+    void Minimap::configure(const Renderer& renderer, int width, int height) {
+        boardWidth = width;
+        boardHeight = height;
+        blockWidth = std::max(1, (width + Config::MINIMAP_MAX_TEXELS - 1) / Config::MINIMAP_MAX_TEXELS);
+        blockHeight = std::max(1, (height + Config::MINIMAP_MAX_TEXELS - 1) / Config::MINIMAP_MAX_TEXELS);
+        texelWidth = (width + blockWidth - 1) / blockWidth;
+        texelHeight = (height + blockHeight - 1) / blockHeight;
+
+        pixels.assign(static_cast<size_t>(texelWidth) * texelHeight, packColor(Config::MINIMAP_BACKGROUND_COLOR));
+        dirtyFlags.assign(pixels.size(), 0);
+        dirtyBlocks.clear();
+
+        texture.reset(SDL_CreateTexture(renderer.getSDLRenderer(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, texelWidth, texelHeight));
+        if (!texture) {
+            std::cerr << "Warning: Failed to create minimap texture! SDL_Error: " << SDL_GetError() << std::endl;
+            return;
+        }
+        SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_BLEND);
+    }
+
+    void Minimap::repaintBlock(const OccupancyGrid& grid, int texel) {
+        const int x0 = (texel % texelWidth) * blockWidth;
+        const int y0 = (texel / texelWidth) * blockHeight;
+        const int x1 = x0 + blockWidth;
+        const int y1 = y0 + blockHeight;
+        SDL_Color color = Config::MINIMAP_BACKGROUND_COLOR;
+        if (grid.anyInRect(CellTag::Snake, x0, y0, x1, y1)) color = Config::SNAKE_COLOR;
+        else if (grid.anyInRect(CellTag::Food, x0, y0, x1, y1)) color = Config::MINIMAP_FOOD_COLOR;
+        else if (grid.anyInRect(CellTag::Obstacle, x0, y0, x1, y1)) color = Config::OBSTACLE_COLOR;
+        pixels[texel] = packColor(color);
+    }
+
+    void Minimap::refresh(const Renderer& renderer, const OccupancyGrid& grid) {
+        if (!texture || boardWidth != grid.getWidth() || boardHeight != grid.getHeight()) {
+            configure(renderer, grid.getWidth(), grid.getHeight());
+            if (!texture) return;
+            for (int texel = 0; texel < static_cast<int>(pixels.size()); ++texel) repaintBlock(grid, texel);
+            SDL_UpdateTexture(texture.get(), nullptr, pixels.data(), texelWidth * static_cast<int>(sizeof(Uint32)));
+            return;
+        }
+
+        if (grid.needsFullRefresh()) {
+            for (int texel = 0; texel < static_cast<int>(pixels.size()); ++texel) repaintBlock(grid, texel);
+            SDL_UpdateTexture(texture.get(), nullptr, pixels.data(), texelWidth * static_cast<int>(sizeof(Uint32)));
+            return;
+        }
+
+        const auto& changed = grid.getChangedCells();
+        if (changed.empty()) return;
+        for (int cell : changed) {
+            const int texel = ((cell / boardWidth) / blockHeight) * texelWidth + (cell % boardWidth) / blockWidth;
+            if (!dirtyFlags[texel]) {
+                dirtyFlags[texel] = 1;
+                dirtyBlocks.push_back(texel);
+            }
+        }
+
+        // Tô lại các khối bị thay đổi và tải lên phần texture bao quanh chúng
+        int minX = texelWidth, minY = texelHeight, maxX = -1, maxY = -1;
+        for (int texel : dirtyBlocks) {
+            repaintBlock(grid, texel);
+            dirtyFlags[texel] = 0;
+            const int tx = texel % texelWidth;
+            const int ty = texel / texelWidth;
+            minX = std::min(minX, tx); maxX = std::max(maxX, tx);
+            minY = std::min(minY, ty); maxY = std::max(maxY, ty);
+        }
+        dirtyBlocks.clear();
+        SDL_Rect area = {minX, minY, maxX - minX + 1, maxY - minY + 1};
+        SDL_UpdateTexture(texture.get(), &area, pixels.data() + static_cast<size_t>(minY) * texelWidth + minX,
+                          texelWidth * static_cast<int>(sizeof(Uint32)));
+    }
+
+    void Minimap::draw(const Renderer& renderer, const SDL_Rect& dest) const {
+        if (!texture) return;
+        renderer.drawTexture(texture.get(), &dest);
+    }
+
+}
@@ -0,0 +1,62 @@
+#ifndef MINIMAP_HPP
+#define MINIMAP_HPP
+
+#include "Renderer.hpp"
+#include "OccupancyGrid.hpp"
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    Minimap
+     *    Bản đồ thu nhỏ của bàn chơi lớn, lưu trong một streaming texture.
+     *        Mỗi texel đại diện cho một khối ô; màu của khối theo ưu tiên rắn > mồi > vật cản > trống.
+     *        Chỉ các khối chứa ô đã thay đổi (theo nhật ký của OccupancyGrid) được tô lại và tải lên GPU,
+     *        nên chi phí mỗi khung hình tỉ lệ với số thay đổi chứ không phải kích thước bàn chơi.
+     */
+    class Minimap {
+    public:
+        Minimap() = default;
+
+        /**
+         *    Cập nhật minimap từ lưới: tạo lại texture nếu kích thước bàn chơi thay đổi,
+         *        vẽ lại toàn bộ nếu lưới yêu cầu (needsFullRefresh), ngược lại chỉ tô lại các khối bị thay đổi.
+         *        Caller xóa nhật ký thay đổi của lưới sau khi gọi hàm này.
+         *    renderer Renderer dùng để tạo texture.
+         *    grid Lưới chiếm chỗ của bàn chơi.
+         */
+        void refresh(const Renderer& renderer, const OccupancyGrid& grid);
+
+        /**
+         *    Vẽ minimap vào vùng dest trên màn hình.
+         */
+        void draw(const Renderer& renderer, const SDL_Rect& dest) const;
+
+        /**    Số texel theo chiều ngang / dọc của texture. */
+        [[nodiscard]] int getTexelWidth() const { return texelWidth; }
+        [[nodiscard]] int getTexelHeight() const { return texelHeight; }
+
+    private:
+        std::unique_ptr<SDL_Texture, SDLTextureDestroyer> texture;
+        std::vector<Uint32> pixels;              // Bản sao CPU của texture (ARGB8888)
+        std::vector<std::uint8_t> dirtyFlags;    // 1 nếu khối đã nằm trong dirtyBlocks
+        std::vector<int> dirtyBlocks;            // Các khối cần tô lại
+        int boardWidth = 0;
+        int boardHeight = 0;
+        int blockWidth = 1;                      // Số ô mỗi texel theo chiều ngang
+        int blockHeight = 1;                     // Số ô mỗi texel theo chiều dọc
+        int texelWidth = 0;
+        int texelHeight = 0;
+
+        /**    Chọn độ phân giải và tạo texture cho bàn chơi mới. */
+        void configure(const Renderer& renderer, int width, int height);
+        /**    Tính lại màu của một texel từ lưới. */
+        void repaintBlock(const OccupancyGrid& grid, int texel);
+    };
+
+}
+
+#endif
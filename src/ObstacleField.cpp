@@ -0,0 +1,140 @@
+#include "ObstacleField.hpp"
+#include <algorithm>
+
+namespace SnakeGame {
+
+    void ObstacleField::clear() {
+        for (auto* column : {&posX, &posY, &dirX, &dirY, &moveRange, &moveStep, &delay, &speed, &moving, &due, &targetX, &targetY}) {
+            column->clear();
+        }
+        movingIndices.clear();
+    }
+
+    void ObstacleField::reserve(std::size_t count) {
+        for (auto* column : {&posX, &posY, &dirX, &dirY, &moveRange, &moveStep, &delay, &speed, &moving, &due, &targetX, &targetY}) {
+            column->reserve(count);
+        }
+    }
+
+    void ObstacleField::push(const Obstacle& obs) {
+        const bool isMovingObstacle = obs.movementType != ObstacleMovement::Static;
+        int dx = 0;
+        int dy = 0;
+        if (isMovingObstacle) {
+            switch (obs.moveDirection) {
+                case Direction::UP:    dy = -1; break;
+                case Direction::DOWN:  dy = 1; break;
+                case Direction::LEFT:  dx = -1; break;
+                case Direction::RIGHT: dx = 1; break;
+            }
+        }
+        posX.push_back(obs.position.x);
+        posY.push_back(obs.position.y);
+        dirX.push_back(dx);
+        dirY.push_back(dy);
+        moveRange.push_back(obs.moveRange);
+        moveStep.push_back(obs.currentMoveStep);
+        delay.push_back(obs.moveDelayCounter);
+        speed.push_back(std::max(1, obs.moveSpeedFactor));
+        if (isMovingObstacle) movingIndices.push_back(static_cast<std::uint32_t>(posX.size() - 1));
+        moving.push_back(isMovingObstacle ? 1 : 0);
+        due.push_back(0);
+        targetX.push_back(obs.position.x);
+        targetY.push_back(obs.position.y);
+    }
+
+    void ObstacleField::advanceTimers(int boardWidth, int boardHeight) {
+        const std::size_t n = size();
+        const std::int32_t* px = posX.data();
+        const std::int32_t* py = posY.data();
+        const std::int32_t* dx = dirX.data();
+        const std::int32_t* dy = dirY.data();
+        const std::int32_t* sp = speed.data();
+        const std::int32_t* mv = moving.data();
+        std::int32_t* dl = delay.data();
+        std::int32_t* du = due.data();
+        std::int32_t* tx = targetX.data();
+        std::int32_t* ty = targetY.data();
+        const std::int32_t w = boardWidth;
+        const std::int32_t h = boardHeight;
+
+        // Vòng lặp thuần số học (so sánh -> mặt nạ 0/-1), không có nhánh phụ thuộc dữ liệu
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::int32_t counter = dl[i] + mv[i];
+            const std::int32_t isDue = mv[i] & static_cast<std::int32_t>(counter >= sp[i]);
+            dl[i] = counter & (isDue - 1);
+            du[i] = isDue;
+
+            std::int32_t nx = px[i] + dx[i];
+            std::int32_t ny = py[i] + dy[i];
+            nx += w & -static_cast<std::int32_t>(nx < 0);
+            nx -= w & -static_cast<std::int32_t>(nx >= w);
+            ny += h & -static_cast<std::int32_t>(ny < 0);
+            ny -= h & -static_cast<std::int32_t>(ny >= h);
+            tx[i] = nx;
+            ty[i] = ny;
+        }
+    }
+
+    void ObstacleField::bounce(std::size_t i) {
+        dirX[i] = -dirX[i];
+        dirY[i] = -dirY[i];
+        moveStep[i] = 0;
+    }
+
+    void ObstacleField::advance(std::size_t i) {
+        posX[i] = targetX[i];
+        posY[i] = targetY[i];
+        if (++moveStep[i] >= moveRange[i]) {
+            bounce(i);
+        }
+    }
+
+    void ObstacleField::saveState(ByteWriter& writer) const {
+        for (const auto* column : {&posX, &posY, &dirX, &dirY, &moveRange, &moveStep, &delay, &speed, &moving}) {
+            writer.array(*column);
+        }
+    }
+
+    bool ObstacleField::checkState(ByteReader& reader, int width, int height) {
+        const auto maxCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        const auto px = reader.arrayView<std::int32_t>(maxCount);
+        const auto py = reader.arrayView<std::int32_t>(maxCount);
+        const auto dx = reader.arrayView<std::int32_t>(maxCount);
+        const auto dy = reader.arrayView<std::int32_t>(maxCount);
+        const auto range = reader.arrayView<std::int32_t>(maxCount);
+        const auto step = reader.arrayView<std::int32_t>(maxCount);
+        const auto dl = reader.arrayView<std::int32_t>(maxCount);
+        const auto sp = reader.arrayView<std::int32_t>(maxCount);
+        const auto mv = reader.arrayView<std::int32_t>(maxCount);
+        const std::size_t count = px.size();
+        if (!reader.ok()) return false;
+        for (std::size_t size : {py.size(), dx.size(), dy.size(), range.size(), step.size(), dl.size(), sp.size(), mv.size()}) {
+            if (size != count) return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            if (px[i] < 0 || px[i] >= width || py[i] < 0 || py[i] >= height ||
+                dx[i] < -1 || dx[i] > 1 || dy[i] < -1 || dy[i] > 1 ||
+                (mv[i] != 0 && mv[i] != 1) || sp[i] < 1 || dl[i] < 0 || dl[i] >= sp[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ObstacleField::loadState(ByteReader& reader, std::size_t maxCount) {
+        for (auto* column : {&posX, &posY, &dirX, &dirY, &moveRange, &moveStep, &delay, &speed, &moving}) {
+            reader.array(*column, maxCount);
+        }
+        const std::size_t count = posX.size();
+        // Kết quả tạm được advanceTimers() ghi lại toàn bộ, chỉ cần đúng kích thước
+        due.resize(count);
+        targetX.resize(count);
+        targetY.resize(count);
+        movingIndices.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (moving[i] != 0) movingIndices.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+
+}
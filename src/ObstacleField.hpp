@@ -0,0 +1,132 @@
+#ifndef OBSTACLE_FIELD_HPP
+#define OBSTACLE_FIELD_HPP
+
+#include "CoreConfig.hpp"
+#include "ByteStream.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+
+    using Config::Direction;
+
+    /**
+     *    ObstacleMovement
+     *    Xác định kiểu di chuyển của chướng ngại vật.
+     */
+    enum class ObstacleMovement {
+        Static,     // Đứng yên
+        Horizontal, // Di chuyển ngang
+        Vertical    // Di chuyển dọc
+    };
+
+    /**
+     *    Obstacle
+     *    Mô tả một chướng ngại vật khi tạo mới (có thể tĩnh hoặc động).
+     *        Chỉ dùng để truyền vào ObstacleField::push; trạng thái thực được lưu dạng SoA trong ObstacleField.
+     */
+    struct Obstacle {
+        Point position;            // Vị trí ban đầu (tọa độ ô)
+        ObstacleMovement movementType = ObstacleMovement::Static; // Kiểu di chuyển
+        Direction moveDirection = Direction::RIGHT; // Hướng di chuyển ban đầu (cho động)
+        int moveRange = 0;         // Số ô di chuyển tối đa theo một hướng trước khi đổi chiều (cho động)
+        int currentMoveStep = 0; // Số bước đã di chuyển theo hướng hiện tại (cho động)
+        int moveDelayCounter = 0; // Bộ đếm để làm chậm tốc độ di chuyển so với rắn
+        int moveSpeedFactor = 3;  // Vật cản di chuyển sau mỗi X lượt rắn di chuyển (giá trị mặc định)
+    };
+
+    /**
+     *    ObstacleField
+     *    Toàn bộ vật cản của bàn chơi, lưu dạng structure-of-arrays: mỗi thuộc tính là một mảng int32 liền nhau.
+     *        Việc cập nhật chia làm hai pha:
+     *          1. advanceTimers(): kernel không rẽ nhánh trên các mảng (tăng bộ đếm trễ, xác định vật cản đến lượt,
+     *             tính ô đích đã wrap) - trình biên dịch vector hóa được vòng lặp này.
+     *          2. Caller (Simulation::updateObstacles) duyệt các vật cản đến lượt theo thứ tự chỉ số,
+     *             giải quyết xung đột bằng tra cứu OccupancyGrid rồi gọi bounce()/advance().
+     *        Hướng được lưu dưới dạng vector (dx, dy) nên đổi chiều chỉ là đổi dấu.
+     */
+    class ObstacleField {
+    public:
+        ObstacleField() = default;
+
+        /**    Xóa toàn bộ vật cản (giữ bộ nhớ đã cấp phát). */
+        void clear();
+
+        /**    Đặt trước dung lượng cho count vật cản. */
+        void reserve(std::size_t count);
+
+        /**    Thêm một vật cản mới (không tự đánh dấu lên lưới). */
+        void push(const Obstacle& obs);
+
+        [[nodiscard]] std::size_t size() const { return posX.size(); }
+        [[nodiscard]] bool empty() const { return posX.empty(); }
+
+        /**    Vị trí hiện tại (tọa độ ô) của vật cản thứ i. */
+        [[nodiscard]] Point positionAt(std::size_t i) const { return {posX[i], posY[i]}; }
+
+        /**    true nếu vật cản thứ i là vật cản động. */
+        [[nodiscard]] bool isMoving(std::size_t i) const { return moving[i] != 0; }
+
+        /**    Số vật cản động. */
+        [[nodiscard]] int countMoving() const { return static_cast<int>(movingIndices.size()); }
+
+        /**    Chỉ số của các vật cản động, tăng dần (để chỉ duyệt chúng thay vì toàn bộ vật cản). */
+        [[nodiscard]] const std::vector<std::uint32_t>& getMovingIndices() const { return movingIndices; }
+
+        /**
+         *    Pha 1 của cập nhật: tăng bộ đếm trễ của mọi vật cản động, đánh dấu vật cản đến lượt di chuyển
+         *        và tính ô đích (đã wrap theo kích thước bàn chơi). Không rẽ nhánh theo từng vật cản.
+         *    boardWidth Số ô theo chiều ngang.
+         *    boardHeight Số ô theo chiều dọc.
+         */
+        void advanceTimers(int boardWidth, int boardHeight);
+
+        /**    true nếu vật cản thứ i đến lượt di chuyển trong bước này (sau advanceTimers). */
+        [[nodiscard]] bool isDue(std::size_t i) const { return due[i] != 0; }
+
+        /**    Ô đích của vật cản thứ i (sau advanceTimers). */
+        [[nodiscard]] Point targetAt(std::size_t i) const { return {targetX[i], targetY[i]}; }
+
+        /**    Ô đích bị chặn: đổi chiều và đặt lại số bước. */
+        void bounce(std::size_t i);
+
+        /**    Di chuyển vật cản thứ i tới ô đích; đổi chiều khi đã đi hết moveRange. */
+        void advance(std::size_t i);
+
+        /**    Ghi mọi mảng trạng thái (không gồm kết quả tạm của advanceTimers) vào ảnh chụp, mỗi mảng một lần sao chép. */
+        void saveState(ByteWriter& writer) const;
+
+        /**
+         *    Kiểm tra dữ liệu do saveState ghi cho bàn chơi width x height mà không nạp: các cột cùng độ dài (tối đa số ô),
+         *        vị trí nằm trong bàn chơi, hướng trong {-1, 0, 1}, moving là 0/1 và 0 <= delay < speed.
+         */
+        static bool checkState(ByteReader& reader, int width, int height);
+
+        /**
+         *    Khôi phục trạng thái do saveState ghi (không tự đánh dấu lên lưới).
+         *        Dữ liệu phải đã qua checkState; maxCount là số ô của bàn chơi.
+         */
+        void loadState(ByteReader& reader, std::size_t maxCount);
+
+    private:
+        std::vector<std::int32_t> posX;      // Cột hiện tại
+        std::vector<std::int32_t> posY;      // Hàng hiện tại
+        std::vector<std::int32_t> dirX;      // Hướng di chuyển theo cột (-1, 0, 1)
+        std::vector<std::int32_t> dirY;      // Hướng di chuyển theo hàng (-1, 0, 1)
+        std::vector<std::int32_t> moveRange; // Số ô tối đa theo một hướng
+        std::vector<std::int32_t> moveStep;  // Số bước đã đi theo hướng hiện tại
+        std::vector<std::int32_t> delay;     // Bộ đếm trễ
+        std::vector<std::int32_t> speed;     // Di chuyển sau mỗi 'speed' lượt rắn
+        std::vector<std::int32_t> moving;    // 1 nếu là vật cản động, 0 nếu tĩnh
+        std::vector<std::uint32_t> movingIndices; // Chỉ số các phần tử có moving = 1 (suy ra, không nằm trong ảnh chụp)
+
+        // Kết quả của advanceTimers()
+        std::vector<std::int32_t> due;       // 1 nếu đến lượt di chuyển
+        std::vector<std::int32_t> targetX;   // Cột đích (đã wrap)
+        std::vector<std::int32_t> targetY;   // Hàng đích (đã wrap)
+    };
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include "OccupancyGrid.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace SnakeGame {
+
+    OccupancyGrid::OccupancyGrid(int w, int h) {
+        resize(w, h);
+    }
+
+    void OccupancyGrid::resize(int w, int h) {
+        width = std::max(0, w);
+        height = std::max(0, h);
+        const size_t wordCount = (static_cast<size_t>(width) * height + 63) / 64;
+        for (auto& plane : planes) {
+            plane.assign(wordCount, 0);
+        }
+        freeCells.fill(getCellCount());
+        hash = 0;
+        fullRefresh = true;
+        changedCells.clear();
+    }
+
+    void OccupancyGrid::clear() {
+        for (auto& plane : planes) {
+            std::fill(plane.begin(), plane.end(), 0);
+        }
+        freeCells.fill(getCellCount());
+        hash = 0;
+        fullRefresh = true;
+        changedCells.clear();
+    }
+
+    void OccupancyGrid::setChangeTracking(bool enabled) {
+        trackChanges = enabled;
+        fullRefresh = true;
+        changedCells.clear();
+    }
+
+    void OccupancyGrid::clearChanges() {
+        fullRefresh = false;
+        changedCells.clear();
+    }
+
+    void OccupancyGrid::saveState(ByteWriter& writer) const {
+        for (const auto& plane : planes) {
+            writer.array(plane);
+        }
+        writer.raw(hash);
+        freeCells.saveState(writer);
+    }
+
+    bool OccupancyGrid::checkState(ByteReader& reader, int width, int height) {
+        const int cellCount = width * height;
+        const std::size_t wordCount = (static_cast<std::size_t>(cellCount) + 63) / 64;
+        for (int tag = 0; tag < TAG_COUNT; ++tag) {
+            if (reader.arrayView<std::uint64_t>(wordCount).size() != wordCount) return false;
+        }
+        reader.raw<std::uint64_t>();
+        return reader.ok() && FreeCellSet::checkState(reader, cellCount);
+    }
+
+    void OccupancyGrid::loadState(ByteReader& reader) {
+        const std::size_t wordCount = planes[0].size();
+        for (auto& plane : planes) {
+            reader.array(plane, wordCount);
+        }
+        hash = reader.raw<std::uint64_t>();
+        freeCells.loadState(reader, getCellCount());
+        fullRefresh = true;
+        changedCells.clear();
+    }
+
+    void OccupancyGrid::copyStateFrom(const OccupancyGrid& other) {
+        width = other.width;
+        height = other.height;
+        planes = other.planes;
+        freeCells = other.freeCells;
+        hash = other.hash;
+        fullRefresh = true;
+        changedCells.clear();
+    }
+
+    int OccupancyGrid::count(CellTag tag) const {
+        int total = 0;
+        for (std::uint64_t word : planes[static_cast<int>(tag)]) {
+            total += std::popcount(word);
+        }
+        return total;
+    }
+
+}
@@ -0,0 +1,224 @@
+#ifndef OCCUPANCY_GRID_HPP
+#define OCCUPANCY_GRID_HPP
+
+#include "CoreConfig.hpp"
+#include "FreeCellSet.hpp"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    CellTag
+     *    Loại đối tượng chiếm một ô trên lưới. Mỗi loại có một mặt phẳng bit riêng.
+     */
+    enum class CellTag : std::uint8_t {
+        Snake = 0,
+        Obstacle = 1,
+        Food = 2
+    };
+
+    /**
+     *    OccupancyGrid
+     *    Lưới chiếm chỗ được duy trì tăng dần: mỗi loại CellTag là một mặt phẳng bit (1 bit/ô, gói trong uint64_t).
+     *        Thay cho các vòng quét tuyến tính qua thân rắn/vật cản: mọi truy vấn va chạm là O(1).
+     *        Đồng thời duy trì FreeCellSet các ô hoàn toàn trống để đặt mồi/vật cản bằng một lần rút ngẫu nhiên.
+     *        Tọa độ tính theo ô (cell), không phải pixel.
+     */
+    class OccupancyGrid {
+    public:
+        OccupancyGrid() = default;
+
+        /**
+         *    Khởi tạo lưới rỗng.
+         *    width Số ô theo chiều ngang.
+         *    height Số ô theo chiều dọc.
+         */
+        OccupancyGrid(int width, int height);
+
+        /**    Đổi kích thước lưới và xóa toàn bộ nội dung. */
+        void resize(int width, int height);
+
+        /**    Xóa mọi bit của mọi mặt phẳng (giữ kích thước). */
+        void clear();
+
+        [[nodiscard]] int getWidth() const { return width; }
+        [[nodiscard]] int getHeight() const { return height; }
+        [[nodiscard]] int getCellCount() const { return width * height; }
+
+        /**    true nếu ô (x, y) nằm trong lưới. */
+        [[nodiscard]] bool contains(int x, int y) const {
+            return x >= 0 && y >= 0 && x < width && y < height;
+        }
+
+        /**    Chỉ số tuyến tính của ô (x, y); caller phải đảm bảo contains(x, y). */
+        [[nodiscard]] int indexOf(int x, int y) const { return y * width + x; }
+        [[nodiscard]] int indexOf(Point cell) const { return indexOf(cell.x, cell.y); }
+
+        /**    Kiểm tra ô có mang tag cho trước không. */
+        [[nodiscard]] bool test(int index, CellTag tag) const {
+            return (planes[static_cast<int>(tag)][static_cast<unsigned>(index) >> 6] >> (index & 63)) & 1u;
+        }
+        [[nodiscard]] bool test(Point cell, CellTag tag) const { return test(indexOf(cell), tag); }
+
+        /**    Kiểm tra ô có bị chiếm bởi bất kỳ loại nào không. */
+        [[nodiscard]] bool isOccupied(int index) const {
+            const unsigned word = static_cast<unsigned>(index) >> 6;
+            const std::uint64_t bit = std::uint64_t{1} << (index & 63);
+            return ((planes[0][word] | planes[1][word] | planes[2][word]) & bit) != 0;
+        }
+        [[nodiscard]] bool isOccupied(Point cell) const { return isOccupied(indexOf(cell)); }
+
+        /**    Đặt tag cho ô (ô rời khỏi tập ô trống nếu trước đó chưa bị chiếm). */
+        void set(int index, CellTag tag) {
+            if (trackChanges) recordChange(index);
+            if (!isOccupied(index)) freeCells.erase(index);
+            std::uint64_t& word = planes[static_cast<int>(tag)][static_cast<unsigned>(index) >> 6];
+            const std::uint64_t bit = std::uint64_t{1} << (index & 63);
+            if ((word & bit) == 0) hash ^= zobristKey(index, tag);
+            word |= bit;
+        }
+        void set(Point cell, CellTag tag) { set(indexOf(cell), tag); }
+
+        /**    Bỏ tag khỏi ô (ô quay lại tập ô trống nếu không còn tag nào). */
+        void reset(int index, CellTag tag) {
+            if (trackChanges) recordChange(index);
+            std::uint64_t& word = planes[static_cast<int>(tag)][static_cast<unsigned>(index) >> 6];
+            const std::uint64_t bit = std::uint64_t{1} << (index & 63);
+            if ((word & bit) != 0) hash ^= zobristKey(index, tag);
+            word &= ~bit;
+            if (!isOccupied(index)) freeCells.insert(index);
+        }
+        void reset(Point cell, CellTag tag) { reset(indexOf(cell), tag); }
+
+        /**    Đếm số ô mang tag cho trước (dùng cho debug/kiểm tra đồng bộ). */
+        [[nodiscard]] int count(CellTag tag) const;
+
+        /**
+         *    Mã băm Zobrist của toàn bộ lưới: XOR khóa của mọi cặp (ô, tag) đang được đặt.
+         *        Được cập nhật trong set()/reset() (O(1) mỗi thay đổi) và được chép cùng lưới, nên bot tìm kiếm
+         *        dùng nó làm khóa bảng chuyển vị mà không phải quét lại bàn chơi.
+         */
+        [[nodiscard]] std::uint64_t getHash() const { return hash; }
+
+        /**    Khóa Zobrist của (ô, tag): băm splitmix64 của chỉ số thay cho bảng số ngẫu nhiên (bàn chơi lớn tới hàng triệu ô). */
+        [[nodiscard]] static std::uint64_t zobristKey(int index, CellTag tag) {
+            std::uint64_t key = (static_cast<std::uint64_t>(index) * TAG_COUNT + static_cast<std::uint64_t>(tag) + 1) * 0x9E3779B97F4A7C15ull;
+            key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+            key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+            return key ^ (key >> 31);
+        }
+
+        /**    Tập các ô hoàn toàn trống (không mang tag nào). */
+        [[nodiscard]] const FreeCellSet& getFreeCells() const { return freeCells; }
+
+        /**    Số ô hoàn toàn trống. */
+        [[nodiscard]] int getFreeCellCount() const { return freeCells.size(); }
+
+        /**
+         *    Gọi fn(x, y) cho mọi ô mang tag trong hình chữ nhật [x0, x1) x [y0, y1) (đã được cắt theo lưới).
+         *        Quét theo từng word 64 bit của mỗi hàng, nên chi phí tỉ lệ với diện tích hình chữ nhật / 64
+         *        cộng số ô được báo cáo - không phụ thuộc kích thước toàn bàn chơi.
+         */
+        template <typename Fn>
+        void forEachInRect(CellTag tag, int x0, int y0, int x1, int y1, Fn&& fn) const {
+            scanRect(tag, x0, y0, x1, y1, [&](int x, int y) { fn(x, y); return true; });
+        }
+
+        /**    true nếu có ít nhất một ô mang tag trong hình chữ nhật [x0, x1) x [y0, y1). */
+        [[nodiscard]] bool anyInRect(CellTag tag, int x0, int y0, int x1, int y1) const {
+            bool found = false;
+            scanRect(tag, x0, y0, x1, y1, [&](int, int) { found = true; return false; });
+            return found;
+        }
+
+        /**
+         *    Bật/tắt ghi nhật ký thay đổi: khi bật, mỗi set()/reset() ghi lại chỉ số ô bị thay đổi
+         *        để tầng hiển thị (minimap) cập nhật tăng dần. Mặc định tắt (driver headless không trả chi phí).
+         */
+        void setChangeTracking(bool enabled);
+
+        /**    Các ô đã thay đổi kể từ lần clearChanges() gần nhất (có thể lặp lại). */
+        [[nodiscard]] const std::vector<int>& getChangedCells() const { return changedCells; }
+
+        /**    true nếu nhật ký bị tràn hoặc lưới vừa được xóa/đổi kích thước: người dùng cần vẽ lại toàn bộ. */
+        [[nodiscard]] bool needsFullRefresh() const { return fullRefresh; }
+
+        /**    Xóa nhật ký thay đổi sau khi đã xử lý. */
+        void clearChanges();
+
+        /**    Ghi các mặt phẳng bit và tập ô trống vào ảnh chụp (nhật ký thay đổi không được ghi). */
+        void saveState(ByteWriter& writer) const;
+
+        /**    Kiểm tra dữ liệu do saveState ghi cho lưới width x height mà không nạp (xem FreeCellSet::checkState). */
+        static bool checkState(ByteReader& reader, int width, int height);
+
+        /**
+         *    Khôi phục trạng thái do saveState ghi vào lưới cùng kích thước (chép nguyên khối, không dựng lại).
+         *        Dữ liệu phải đã qua checkState. Đánh dấu fullRefresh để tầng hiển thị vẽ lại toàn bộ.
+         */
+        void loadState(ByteReader& reader);
+
+        /**
+         *    Chép mặt phẳng bit, tập ô trống và mã băm của other (cùng kích thước) mà không cấp phát lại.
+         *        Nhật ký thay đổi của lưới này được giữ chế độ cũ và đánh dấu fullRefresh.
+         */
+        void copyStateFrom(const OccupancyGrid& other);
+
+    private:
+        static constexpr int TAG_COUNT = 3;
+        static constexpr std::size_t MAX_CHANGE_LOG = 1 << 16; // Quá ngưỡng này thì chuyển sang vẽ lại toàn bộ
+
+        /**    Ghi một ô vào nhật ký thay đổi, chuyển sang fullRefresh nếu nhật ký quá dài. */
+        void recordChange(int index) {
+            if (fullRefresh) return;
+            if (changedCells.size() >= MAX_CHANGE_LOG) {
+                fullRefresh = true;
+                changedCells.clear();
+                return;
+            }
+            changedCells.push_back(index);
+        }
+
+        /**    Quét các ô mang tag trong hình chữ nhật; dừng sớm khi visit trả về false. */
+        template <typename Visit>
+        void scanRect(CellTag tag, int x0, int y0, int x1, int y1, Visit&& visit) const {
+            x0 = x0 < 0 ? 0 : x0;
+            y0 = y0 < 0 ? 0 : y0;
+            x1 = x1 > width ? width : x1;
+            y1 = y1 > height ? height : y1;
+            if (x0 >= x1 || y0 >= y1) return;
+            const std::vector<std::uint64_t>& plane = planes[static_cast<int>(tag)];
+            for (int y = y0; y < y1; ++y) {
+                const int rowStart = y * width;
+                const int first = rowStart + x0;
+                const int last = rowStart + x1; // không bao gồm
+                for (int wordIndex = first >> 6; wordIndex <= (last - 1) >> 6; ++wordIndex) {
+                    std::uint64_t word = plane[wordIndex];
+                    const int wordBase = wordIndex << 6;
+                    if (wordBase < first) word &= ~std::uint64_t{0} << (first - wordBase);
+                    if (wordBase + 64 > last) word &= ~std::uint64_t{0} >> (wordBase + 64 - last);
+                    while (word != 0) {
+                        const int index = wordBase + std::countr_zero(word);
+                        if (!visit(index - rowStart, y)) return;
+                        word &= word - 1;
+                    }
+                }
+            }
+        }
+
+        int width = 0;
+        int height = 0;
+        std::array<std::vector<std::uint64_t>, TAG_COUNT> planes; // Một mặt phẳng bit cho mỗi CellTag
+        FreeCellSet freeCells;                                    // Các ô không mang tag nào
+        std::uint64_t hash = 0;                                   // Mã băm Zobrist của các mặt phẳng bit
+        bool trackChanges = false;                                // Có ghi nhật ký thay đổi không
+        bool fullRefresh = true;                                  // Nhật ký tràn / lưới vừa được làm mới
+        std::vector<int> changedCells;                            // Nhật ký các ô đã thay đổi
+    };
+
+}
+
+#endif
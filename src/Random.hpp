@@ -0,0 +1,50 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <cstdint>
+#include <limits>
+
+namespace SnakeGame {
+
+    /**
+     *    Rng
+     *    Bộ sinh số ngẫu nhiên PCG32 (XSH-RR): trạng thái chỉ 16 byte, sao chép được bằng memcpy,
+     *        thay cho std::mt19937 (~5 KB) để ảnh chụp trạng thái mô phỏng nhỏ và khôi phục nhanh.
+     *        Thỏa UniformRandomBitGenerator nên dùng được với các distribution của <random>.
+     */
+    class Rng {
+    public:
+        using result_type = std::uint32_t;
+
+        explicit Rng(std::uint64_t seedValue = 0) { seed(seedValue); }
+
+        /**    Đặt lại trạng thái theo seed (cùng seed -> cùng chuỗi số). */
+        void seed(std::uint64_t seedValue) {
+            state = 0;
+            increment = (seedValue << 1) | 1u;
+            (*this)();
+            state += seedValue ^ 0x853C49E6748FEA9Bull;
+            (*this)();
+        }
+
+        result_type operator()() {
+            const std::uint64_t old = state;
+            state = old * 6364136223846793005ull + increment;
+            const auto xorShifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+            const auto rotation = static_cast<std::uint32_t>(old >> 59);
+            return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        bool operator==(const Rng& other) const = default;
+
+    private:
+        std::uint64_t state = 0;
+        std::uint64_t increment = 1; // Luôn lẻ
+    };
+
+}
+
+#endif
@@ -1,23 +1,41 @@
 #include "Renderer.hpp"
 #include "Config.hpp"
+#include "GlyphAtlas.hpp"
 #include <SDL_image.h>
 #include <iostream>
 #include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
 
 namespace SnakeGame {
 
     constexpr int FONT_RENDER_SCALE = 3;
 
+    namespace {
+        SDL_Color lerpColor(SDL_Color from, SDL_Color to, float t) {
+            auto mix = [t](Uint8 a, Uint8 b) { return static_cast<Uint8>(static_cast<float>(a) + (static_cast<float>(b) - static_cast<float>(a)) * t + 0.5f); };
+            return {mix(from.r, to.r), mix(from.g, to.g), mix(from.b, to.b), mix(from.a, to.a)};
+        }
+
+        SDL_Color shadeColor(SDL_Color color, float factor) {
+            return lerpColor({0, 0, 0, color.a}, color, factor);
+        }
+    }
+
     Renderer::Renderer(SDL_Window* window, const std::string& fontPath, int fontSize)
-            :   cachedScore(-1), cachedHighScore(-1),
-                scoreRect{0,0,0,0}, highScoreRect{0,0,0,0}, textRectCache{0,0,0,0},
-                scoreColor{0,0,0,0}, highScoreColor{0,0,0,0}
     {
         if (!window) {
             throw RendererError("Window pointer is null during Renderer creation.");
         }
 
-        sdlRenderer.reset(SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC));
+        const Uint32 flags = SDL_RENDERER_ACCELERATED | (Config::PRESENT_VSYNC ? static_cast<Uint32>(SDL_RENDERER_PRESENTVSYNC) : 0u);
+        sdlRenderer.reset(SDL_CreateRenderer(window, -1, flags));
+        if (!sdlRenderer) {
+            // Driver video offscreen/dummy (dựng video từ replay trên máy không có GPU) chỉ có renderer phần mềm
+            std::cerr << "Warning: Accelerated renderer unavailable (" << SDL_GetError() << "), falling back to the software renderer." << std::endl;
+            sdlRenderer.reset(SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE));
+        }
         if (!sdlRenderer) {
             throw RendererError("Failed to create SDL_Renderer: " + std::string(SDL_GetError()));
         }
@@ -30,13 +48,24 @@ namespace SnakeGame {
             std::cout << "Font '" << fontPath << "' loaded successfully at render size " << renderFontSize << " (target display size " << fontSize << ")" << std::endl;
         }
 
+        glyphAtlas = std::make_unique<GlyphAtlas>(sdlRenderer.get(), font.get(), FONT_RENDER_SCALE);
+
         SDL_SetRenderDrawColor(getSDLRenderer(), Config::BACKGROUND_COLOR.r, Config::BACKGROUND_COLOR.g, Config::BACKGROUND_COLOR.b, Config::BACKGROUND_COLOR.a);
     }
 
+    Renderer::~Renderer() = default;
+    Renderer::Renderer(Renderer&&) noexcept = default;
+    Renderer& Renderer::operator=(Renderer&&) noexcept = default;
+
     SDL_Renderer* Renderer::getSDLRenderer() const {
+        flushText();
         return sdlRenderer.get();
     }
 
+    void Renderer::flushText() const {
+        if (glyphAtlas && glyphAtlas->hasPending()) glyphAtlas->flush();
+    }
+
     SDL_Texture* Renderer::loadTexture(const std::string& path) const {
         if (!sdlRenderer) {
             std::cerr << "Error: Cannot load texture, SDL_Renderer is null." << std::endl;
@@ -60,18 +89,31 @@ namespace SnakeGame {
         SDL_RenderPresent(getSDLRenderer());
     }
 
+    bool Renderer::readPixels(std::uint32_t* pixels, int pitch) const {
+        if (!sdlRenderer || !pixels) return false;
+        flushText();
+        if (SDL_RenderReadPixels(sdlRenderer.get(), nullptr, SDL_PIXELFORMAT_ARGB8888, pixels, pitch) != 0) {
+            std::cerr << "Warning: SDL_RenderReadPixels failed: " << SDL_GetError() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
     void Renderer::drawTexture(SDL_Texture* texture, const SDL_Rect* destRect) const {
         if (!texture || !sdlRenderer || !destRect) return;
+        flushText();
         SDL_RenderCopy(sdlRenderer.get(), texture, nullptr, destRect);
     }
 
     void Renderer::drawTexturePortion(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* destRect) const {
         if (!texture || !sdlRenderer || !srcRect || !destRect) return;
+        flushText();
         SDL_RenderCopy(sdlRenderer.get(), texture, srcRect, destRect);
     }
 
     void Renderer::drawRect(const SDL_Rect* rect, SDL_Color color, bool filled) const {
         if (!rect || !sdlRenderer) return;
+        flushText();
         SDL_SetRenderDrawColor(sdlRenderer.get(), color.r, color.g, color.b, color.a);
         if (filled) {
             SDL_RenderFillRect(sdlRenderer.get(), rect);
@@ -82,6 +124,7 @@ namespace SnakeGame {
 
     void Renderer::drawRects(const std::vector<SDL_Rect>& rects, SDL_Color color, bool filled) const {
         if (rects.empty() || !sdlRenderer) return;
+        flushText();
         SDL_SetRenderDrawColor(sdlRenderer.get(), color.r, color.g, color.b, color.a);
         if (filled) {
             SDL_RenderFillRects(sdlRenderer.get(), rects.data(), static_cast<int>(rects.size()));
@@ -90,14 +133,112 @@ namespace SnakeGame {
         }
     }
 
+    void Renderer::drawSnake(const Snake& snake, int cellSize, const Camera& camera) const {
+        drawSnake(snake, cellSize, camera, Config::SNAKE_HEAD_COLOR, Config::SNAKE_COLOR);
+    }
+
+    void Renderer::drawSnake(const Snake& snake, int cellSize, const Camera& camera, SDL_Color headColor, SDL_Color bodyColor) const {
+        static const std::vector<Point> noPreviousBody;
+        drawSnake(snake, cellSize, camera, headColor, bodyColor, noPreviousBody, 1.0f);
+    }
+
+    void Renderer::drawSnake(const Snake& snake, int cellSize, const Camera& camera, SDL_Color headColor, SDL_Color bodyColor,
+                             const std::vector<Point>& previousBody, float alpha) const {
+        const auto& body = snake.getBody();
+        if (!sdlRenderer || body.empty()) return;
+        flushText();
+        snakeVertices.clear();
+        snakeIndices.clear();
+
+        const float cell = static_cast<float>(cellSize);
+        const float cut = cell * Config::SNAKE_CORNER_CUT;
+        const float blend = std::clamp(alpha, 0.0f, 1.0f);
+        const SDL_Color tailColor = shadeColor(bodyColor, Config::SNAKE_TAIL_SHADE);
+        const std::size_t count = body.size();
+        std::size_t index = 0;
+        Point previous = {-1, -1};
+        SDL_FPoint previousCorner = {0.0f, 0.0f};
+        SDL_Color previousColor = bodyColor;
+        bool previousVisible = false;
+        for (auto it = body.begin(); it != body.end(); ++it, ++index) {
+            const Point segmentPos = *it;
+            SDL_Color color = headColor;
+            if (index > 0) {
+                const float t = count > 2 ? static_cast<float>(index - 1) / static_cast<float>(count - 2) : 0.0f;
+                color = lerpColor(bodyColor, tailColor, t);
+            }
+            const bool visible = camera.contains(segmentPos);
+            if (visible) {
+                // Vị trí (theo ô, tương đối khung nhìn) nội suy từ vị trí của đốt này ở bước trước
+                float viewX = static_cast<float>(segmentPos.x - camera.originX);
+                float viewY = static_cast<float>(segmentPos.y - camera.originY);
+                if (blend < 1.0f && index < previousBody.size()) {
+                    const Point from = previousBody[index];
+                    if (std::abs(segmentPos.x - from.x) + std::abs(segmentPos.y - from.y) == 1) {
+                        viewX -= static_cast<float>(segmentPos.x - from.x) * (1.0f - blend);
+                        viewY -= static_cast<float>(segmentPos.y - from.y) * (1.0f - blend);
+                    }
+                }
+                const SDL_FPoint corner = {viewX * cell - static_cast<float>(camera.offsetX), viewY * cell - static_cast<float>(camera.offsetY)};
+                appendChamferedCell(corner, cell, cut, color);
+                // Nối với đốt trước nếu hai ô kề nhau trên bàn chơi (không nối qua cạnh wrap của PortalWalls)
+                if (previousVisible && std::abs(segmentPos.x - previous.x) + std::abs(segmentPos.y - previous.y) == 1) {
+                    appendBridge(previousCorner, previousColor, corner, color, cell);
+                }
+                previousCorner = corner;
+            }
+            previous = segmentPos;
+            previousColor = color;
+            previousVisible = visible;
+        }
+        if (snakeIndices.empty()) return;
+        SDL_RenderGeometry(sdlRenderer.get(), nullptr, snakeVertices.data(), static_cast<int>(snakeVertices.size()),
+                           snakeIndices.data(), static_cast<int>(snakeIndices.size()));
+    }
+
+    void Renderer::appendChamferedCell(SDL_FPoint corner, float cell, float cut, SDL_Color color) const {
+        const int base = static_cast<int>(snakeVertices.size());
+        const float x0 = corner.x, y0 = corner.y, x1 = corner.x + cell, y1 = corner.y + cell;
+        const SDL_FPoint points[9] = {
+            {x0 + cell * 0.5f, y0 + cell * 0.5f}, // Tâm (đỉnh chung của quạt tam giác)
+            {x0 + cut, y0}, {x1 - cut, y0}, {x1, y0 + cut}, {x1, y1 - cut},
+            {x1 - cut, y1}, {x0 + cut, y1}, {x0, y1 - cut}, {x0, y0 + cut}
+        };
+        for (const SDL_FPoint& point : points) snakeVertices.push_back({point, color, {0.0f, 0.0f}});
+        for (int i = 1; i <= 8; ++i) {
+            snakeIndices.push_back(base);
+            snakeIndices.push_back(base + i);
+            snakeIndices.push_back(base + (i % 8) + 1);
+        }
+    }
+
+    void Renderer::appendBridge(SDL_FPoint fromCorner, SDL_Color fromColor, SDL_FPoint toCorner, SDL_Color toColor, float cell) const {
+        // Dải rộng một ô nối tâm hai đốt: lấp phần vát ở hai cạnh tiếp giáp, màu chuyển đều từ đốt này sang đốt kia
+        const float half = cell * 0.5f;
+        const SDL_FPoint from = {fromCorner.x + half, fromCorner.y + half};
+        const SDL_FPoint to = {toCorner.x + half, toCorner.y + half};
+        // Khi nội suy, hai đốt ở chỗ rẽ lệch nhau theo cả hai trục: dải được xoay theo hướng nối (pháp tuyến chuẩn hóa)
+        const float dx = to.x - from.x;
+        const float dy = to.y - from.y;
+        const float length = std::sqrt(dx * dx + dy * dy);
+        if (length <= 0.0f) return;
+        const SDL_FPoint side = {-dy / length * half, dx / length * half};
+        const int base = static_cast<int>(snakeVertices.size());
+        snakeVertices.push_back({{from.x - side.x, from.y - side.y}, fromColor, {0.0f, 0.0f}});
+        snakeVertices.push_back({{from.x + side.x, from.y + side.y}, fromColor, {0.0f, 0.0f}});
+        snakeVertices.push_back({{to.x + side.x, to.y + side.y}, toColor, {0.0f, 0.0f}});
+        snakeVertices.push_back({{to.x - side.x, to.y - side.y}, toColor, {0.0f, 0.0f}});
+        for (int corner : {0, 1, 2, 0, 2, 3}) snakeIndices.push_back(base + corner);
+    }
+
     SDL_Texture* Renderer::createTextTexture(const std::string& text, SDL_Color color) const {
         if (!font || text.empty() || !sdlRenderer) {
             return nullptr;
         }
 
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font.get(), text.c_str(), color);
+        SDL_Surface* textSurface = TTF_RenderUTF8_Blended(font.get(), text.c_str(), color);
         if (!textSurface) {
-            std::cerr << "Warning: TTF_RenderText_Blended failed! Text: \"" << text << "\" TTF_Error: " << TTF_GetError() << std::endl;
+            std::cerr << "Warning: TTF_RenderUTF8_Blended failed! Text: \"" << text << "\" TTF_Error: " << TTF_GetError() << std::endl;
             return nullptr;
         }
 
@@ -115,93 +256,24 @@ namespace SnakeGame {
     }
 
     void Renderer::renderUI(int score, int highScore, int scoreX, int scoreY, int hsX, int hsY, SDL_Color textColor) {
-        if (!sdlRenderer) return;
-
-        if (score != cachedScore || memcmp(&textColor, &scoreColor, sizeof(SDL_Color)) != 0) {
-            cachedScore = score;
-            scoreColor = textColor;
-            std::string scoreText = "Score: " + std::to_string(score);
-            scoreTexture.reset(createTextTexture(scoreText, textColor));
-            if (scoreTexture) {
-                int texW, texH;
-                queryTexture(scoreTexture.get(), nullptr, nullptr, &texW, &texH);
-                scoreRect.w = texW / FONT_RENDER_SCALE;
-                scoreRect.h = texH / FONT_RENDER_SCALE;
-                scoreRect.x = scoreX;
-                scoreRect.y = scoreY;
-            } else {
-                scoreRect = {0,0,0,0};
-            }
-        }
-        if (scoreTexture) {
-            SDL_RenderCopy(getSDLRenderer(), scoreTexture.get(), nullptr, &scoreRect);
-        }
-
-        if (highScore != cachedHighScore || memcmp(&textColor, &highScoreColor, sizeof(SDL_Color)) != 0) {
-            cachedHighScore = highScore;
-            highScoreColor = textColor;
-            std::string hsText = "High Score: " + std::to_string(highScore);
-            highScoreTexture.reset(createTextTexture(hsText, textColor));
-            if (highScoreTexture) {
-                int texW, texH;
-                queryTexture(highScoreTexture.get(), nullptr, nullptr, &texW, &texH);
-                highScoreRect.w = texW / FONT_RENDER_SCALE;
-                highScoreRect.h = texH / FONT_RENDER_SCALE;
-                highScoreRect.x = hsX;
-                highScoreRect.y = hsY;
-            } else {
-                highScoreRect = {0,0,0,0};
-            }
-        }
-        if (highScoreTexture) {
-            SDL_RenderCopy(getSDLRenderer(), highScoreTexture.get(), nullptr, &highScoreRect);
-        }
+        renderText("Score: " + std::to_string(score), scoreX, scoreY, textColor);
+        renderText("High Score: " + std::to_string(highScore), hsX, hsY, textColor);
     }
 
     void Renderer::renderCenteredText(const std::string& text, int screenWidth, int yPos, SDL_Color color) {
-        if (text.empty() || !sdlRenderer || !font) return;
-
-        textTextureCache.reset(createTextTexture(text, color));
-        if (!textTextureCache) { return; }
-
-        int texW = 0, texH = 0;
-        if (queryTexture(textTextureCache.get(), nullptr, nullptr, &texW, &texH) == 0) {
-            int targetW = texW / FONT_RENDER_SCALE;
-            int targetH = texH / FONT_RENDER_SCALE;
-            SDL_Rect renderQuad = { (screenWidth - targetW) / 2, yPos, targetW, targetH };
-            SDL_RenderCopy(getSDLRenderer(), textTextureCache.get(), nullptr, &renderQuad);
-        } else {
-            std::cerr << "Warning: Could not query texture size for centered text! SDL_Error: " << SDL_GetError() << std::endl;
-        }
+        if (text.empty() || !sdlRenderer || !glyphAtlas) return;
+        const SDL_Point size = glyphAtlas->measure(text);
+        glyphAtlas->appendText(text, static_cast<float>((screenWidth - size.x) / 2), static_cast<float>(yPos), color);
     }
 
     void Renderer::renderText(const std::string& text, int x, int y, SDL_Color color) {
-        if (text.empty() || !sdlRenderer || !font) return;
-
-        textTextureCache.reset(createTextTexture(text, color));
-        if (!textTextureCache) return;
-
-        int texW = 0, texH = 0;
-        if (queryTexture(textTextureCache.get(), nullptr, nullptr, &texW, &texH) == 0) {
-            textRectCache.w = texW / FONT_RENDER_SCALE;
-            textRectCache.h = texH / FONT_RENDER_SCALE;
-            textRectCache.x = x;
-            textRectCache.y = y;
-            SDL_RenderCopy(getSDLRenderer(), textTextureCache.get(), nullptr, &textRectCache);
-        } else {
-            std::cerr << "Warning: Could not query texture size for simple text! SDL_Error: " << SDL_GetError() << std::endl;
-        }
+        if (text.empty() || !sdlRenderer || !glyphAtlas) return;
+        glyphAtlas->appendText(text, static_cast<float>(x), static_cast<float>(y), color);
     }
 
     SDL_Point Renderer::getTextSize(const std::string& text) const {
-        if (!font || text.empty()) { return {0, 0}; }
-        int width = 0;
-        int height = 0;
-        if (TTF_SizeText(font.get(), text.c_str(), &width, &height) != 0) {
-            std::cerr << "Warning: Unable to get scaled text size! Text: \"" << text << "\" TTF_Error: " << TTF_GetError() << std::endl;
-            return {0, 0};
-        }
-        return {width / FONT_RENDER_SCALE, height / FONT_RENDER_SCALE};
+        if (!glyphAtlas || text.empty()) { return {0, 0}; }
+        return glyphAtlas->measure(text);
     }
 
     int Renderer::queryTexture(SDL_Texture* texture, Uint32* format, int* access, int* w, int* h) const {
@@ -8,9 +8,14 @@
 #include <memory>
 #include <vector>
 #include <cstring>
+#include <cstdint>
+#include "Snake.hpp"
+#include "Camera.hpp"
 
 namespace SnakeGame {
 
+    class GlyphAtlas;
+
     /**    Functor để hủy SDL_Window, dùng với std::unique_ptr. */
     struct SDLWindowDestroyer { void operator()(SDL_Window* w) const { if(w) SDL_DestroyWindow(w); } };
     /**    Functor để hủy SDL_Renderer, dùng với std::unique_ptr. */
@@ -33,6 +38,8 @@ namespace SnakeGame {
      *    Renderer
      *    Đóng gói các hoạt động vẽ và quản lý tài nguyên đồ họa (textures, font) bằng SDL.
      *        Sử dụng kỹ thuật supersampling cho font để chữ mịn hơn.
+     *        Chữ được vẽ từ GlyphAtlas theo batch: các lệnh renderText/renderCenteredText/renderUI chỉ thêm quad,
+     *        batch được vẽ trước lệnh vẽ khác đầu tiên (hoặc present) để giữ đúng thứ tự chồng lớp.
      */
     class Renderer {
     public:
@@ -44,17 +51,18 @@ namespace SnakeGame {
          * @throws RendererError Nếu không thể tạo SDL_Renderer hoặc tải font.
          */
         explicit Renderer(SDL_Window* window, const std::string& fontPath, int fontSize);
-        /**    Destructor mặc định, unique_ptr sẽ tự giải phóng tài nguyên SDL. */
-        ~Renderer() = default;
+        /**    Destructor mặc định (định nghĩa trong Renderer.cpp, nơi GlyphAtlas đầy đủ), unique_ptr sẽ tự giải phóng tài nguyên SDL. */
+        ~Renderer();
 
         // Xóa các constructor/operator copy và move
         Renderer(const Renderer&) = delete;
         Renderer& operator=(const Renderer&) = delete;
-        Renderer(Renderer&&) noexcept = default;
-        Renderer& operator=(Renderer&&) noexcept = default;
+        Renderer(Renderer&&) noexcept;
+        Renderer& operator=(Renderer&&) noexcept;
 
         /**
          *    Lấy con trỏ tới đối tượng SDL_Renderer gốc.
+         *        Chữ đang chờ trong batch được vẽ trước, để các lệnh vẽ SDL trực tiếp của caller nằm đúng lớp.
          *    SDL_Renderer* Con trỏ tới SDL_Renderer, hoặc nullptr nếu chưa khởi tạo.
          */
         [[nodiscard]] SDL_Renderer* getSDLRenderer() const;
@@ -76,6 +84,13 @@ namespace SnakeGame {
          */
         void present() const;
 
+        /**
+         *    Đọc toàn bộ back buffer (trước present) vào pixels dạng ARGB8888 (dùng cho ghi hình).
+         *    pitch Số byte mỗi dòng của pixels.
+         *    false nếu SDL_RenderReadPixels thất bại.
+         */
+        bool readPixels(std::uint32_t* pixels, int pitch) const;
+
         /**
          *    Vẽ toàn bộ một texture lên một vị trí và kích thước xác định trên màn hình.
          *    texture Con trỏ tới SDL_Texture cần vẽ.
@@ -107,6 +122,32 @@ namespace SnakeGame {
          */
         void drawRects(const std::vector<SDL_Rect>& rects, SDL_Color color, bool filled = false) const;
 
+        /**
+         *    Vẽ con rắn bằng một lệnh SDL_RenderGeometry: mỗi đốt là một hình bát giác (ô vát góc), hai đốt liền kề
+         *        được nối bằng một dải nên thân liền mạch và chỉ góc ngoài của chỗ rẽ còn vát (trông tròn).
+         *        Màu nằm ở từng đỉnh: đầu dùng màu riêng, thân chuyển dần từ màu thân ở cổ tới SNAKE_TAIL_SHADE ở đuôi.
+         *        Chỉ các đốt nằm trong khung nhìn của camera được đưa vào batch; bộ đệm đỉnh được giữ lại giữa các frame
+         *        nên không cấp phát gì khi rắn không dài thêm.
+         *    snake Con rắn cần vẽ (tọa độ ô).
+         *    cellSize Kích thước một ô (pixel), dùng để đổi tọa độ ô sang pixel.
+         *    camera Khung nhìn hiện tại trên bàn chơi.
+         */
+        void drawSnake(const Snake& snake, int cellSize, const Camera& camera) const;
+
+        /**
+         *    Như drawSnake ở trên nhưng với màu đầu/thân tùy chọn (dùng cho rắn bot trong Arena).
+         */
+        void drawSnake(const Snake& snake, int cellSize, const Camera& camera, SDL_Color headColor, SDL_Color bodyColor) const;
+
+        /**
+         *    Như trên nhưng nội suy giữa tư thế của bước trước và bước hiện tại (vẽ mượt trên màn hình tần số cao).
+         *    previousBody Vị trí các đốt trước bước mô phỏng gần nhất (đầu trước); rỗng = không nội suy.
+         *    alpha Tỷ lệ thời gian đã trôi qua tới bước kế tiếp, trong [0, 1] (1 = đúng tư thế hiện tại).
+         *        Đốt không có vị trí trước, hoặc nhảy hơn một ô (wrap của PortalWalls), được vẽ ở vị trí hiện tại.
+         */
+        void drawSnake(const Snake& snake, int cellSize, const Camera& camera, SDL_Color headColor, SDL_Color bodyColor,
+                       const std::vector<Point>& previousBody, float alpha) const;
+
         /**
          *    Tạo một SDL_Texture từ text, sử dụng font đã scale và blending.
          *        Texture tạo ra sẽ có kích thước lớn hơn kích thước hiển thị mong muốn (do FONT_RENDER_SCALE).
@@ -117,8 +158,7 @@ namespace SnakeGame {
         [[nodiscard]] SDL_Texture* createTextTexture(const std::string& text, SDL_Color color) const;
 
         /**
-         *    Render các yếu tố UI cơ bản (điểm số, điểm cao) với cơ chế cache để tối ưu hiệu suất.
-         *        Hàm này không const vì nó cập nhật các thành viên cache (texture, rect, màu, giá trị).
+         *    Render các yếu tố UI cơ bản (điểm số, điểm cao) từ atlas glyph.
          *    score Điểm số hiện tại.
          *    highScore Điểm cao nhất hiện tại.
          *    scoreX Tọa độ X góc trên bên trái để vẽ Score.
@@ -130,9 +170,9 @@ namespace SnakeGame {
         void renderUI(int score, int highScore, int scoreX, int scoreY, int hsX, int hsY, SDL_Color textColor);
 
         /**
-         *    Render văn bản căn giữa theo chiều ngang tại một vị trí Y cụ thể, sử dụng supersampling.
-         *        Hàm này không const vì dùng cache texture tạm thời (textTextureCache).
-         *    text Chuỗi văn bản cần vẽ.
+         *    Render văn bản căn giữa theo chiều ngang tại một vị trí Y cụ thể, từ atlas glyph (supersampling).
+         *        Hàm này không const vì thêm quad vào batch chữ (và có thể thêm glyph mới vào atlas).
+         *    text Chuỗi văn bản UTF-8 cần vẽ.
          *    screenWidth Chiều rộng màn hình để căn giữa.
          *    yPos Tọa độ Y mong muốn (cho đỉnh của text).
          *    color Màu chữ.
@@ -140,9 +180,9 @@ namespace SnakeGame {
         void renderCenteredText(const std::string& text, int screenWidth, int yPos, SDL_Color color);
 
         /**
-        *    Render văn bản tại một vị trí X, Y cụ thể, sử dụng supersampling.
-        *        Hàm này không const vì dùng cache texture tạm thời (textTextureCache).
-        *    text Chuỗi văn bản cần render.
+        *    Render văn bản tại một vị trí X, Y cụ thể, từ atlas glyph (supersampling).
+        *        Hàm này không const vì thêm quad vào batch chữ (và có thể thêm glyph mới vào atlas).
+        *    text Chuỗi văn bản UTF-8 cần render.
         *    x Tọa độ X góc trên bên trái.
         *    y Tọa độ Y góc trên bên trái.
         *    color Màu chữ.
@@ -152,7 +192,7 @@ namespace SnakeGame {
         /**
          *    Lấy kích thước (rộng, cao) mà văn bản sẽ chiếm khi render với font hiện tại và áp dụng downscale.
          *        Quan trọng cho việc tính toán layout chính xác trên màn hình.
-         *    text Chuỗi văn bản cần đo.
+         *    text Chuỗi văn bản UTF-8 cần đo (dùng cùng metric với atlas nên khớp với chữ đã vẽ).
          *    SDL_Point Chứa width (x) và height (y) dự kiến trên màn hình. Trả về {0, 0} nếu lỗi.
          */
         [[nodiscard]] SDL_Point getTextSize(const std::string& text) const;
@@ -172,21 +212,18 @@ namespace SnakeGame {
     private:
         std::unique_ptr<SDL_Renderer, SDLRendererDestroyer> sdlRenderer; // Con trỏ tới SDL Renderer
         std::unique_ptr<TTF_Font, TTFFontDestroyer> font;                // Con trỏ tới font đã load (ở kích thước lớn)
-
-        // Cache cho UI động (Score, High Score) để tránh tạo texture mỗi frame
-        std::unique_ptr<SDL_Texture, SDLTextureDestroyer> scoreTexture;
-        SDL_Rect scoreRect = {0, 0, 0, 0};       // Rect đích để vẽ score
-        int cachedScore = -1;                    // Giá trị score đã cache
-        SDL_Color scoreColor = {0,0,0,0};        // Màu score đã cache
-
-        std::unique_ptr<SDL_Texture, SDLTextureDestroyer> highScoreTexture;
-        SDL_Rect highScoreRect = {0, 0, 0, 0};   // Rect đích để vẽ high score
-        int cachedHighScore = -1;                // Giá trị high score đã cache
-        SDL_Color highScoreColor = {0,0,0,0};    // Màu high score đã cache
-
-        // Cache cho renderText và renderCenteredText (dùng chung, sẽ bị ghi đè thường xuyên)
-        std::unique_ptr<SDL_Texture, SDLTextureDestroyer> textTextureCache;
-        SDL_Rect textRectCache = {0,0,0,0};      // Rect đích cho text thường
+        std::unique_ptr<GlyphAtlas> glyphAtlas;                          // Glyph của font, nướng một lần; giữ batch chữ của frame
+
+        // Bộ đệm hình học của drawSnake, dùng lại giữa các lần vẽ (mutable vì các hàm vẽ là const)
+        mutable std::vector<SDL_Vertex> snakeVertices;
+        mutable std::vector<int> snakeIndices;
+
+        /**    Vẽ batch chữ đang chờ (gọi trước mọi lệnh vẽ không phải chữ). */
+        void flushText() const;
+        /**    Thêm một ô vát góc (quạt 8 tam giác quanh tâm) một màu vào bộ đệm của drawSnake. */
+        void appendChamferedCell(SDL_FPoint corner, float cell, float cut, SDL_Color color) const;
+        /**    Thêm dải rộng một ô nối tâm hai đốt (góc trên trái fromCorner/toCorner), màu chuyển từ fromColor sang toColor. */
+        void appendBridge(SDL_FPoint fromCorner, SDL_Color fromColor, SDL_FPoint toCorner, SDL_Color toColor, float cell) const;
     };
 
 
@@ -0,0 +1,331 @@
+#include "Replay.hpp"
+#include "ByteStream.hpp"
+#include "CoreConfig.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace SnakeGame {
+
+    namespace {
+        constexpr std::uint8_t MAGIC[4] = {'V', 'X', 'R', 'P'};
+        constexpr std::uint8_t FORMAT_VERSION = 4;         // 4: keyframe được ghi vào file
+        constexpr std::uint8_t OLDEST_READABLE_VERSION = 3; // 3: bộ sinh số PCG32, chưa có keyframe (dựng lại khi mở)
+        constexpr int INPUT_BITS = 3;  // Số bit thấp của mỗi varint dành cho mã input
+
+        void applyInput(Simulation& sim, ReplayInput input, bool& boostHeld) {
+            switch (input) {
+                case ReplayInput::Up:       sim.queueDirection(Direction::UP); break;
+                case ReplayInput::Down:     sim.queueDirection(Direction::DOWN); break;
+                case ReplayInput::Left:     sim.queueDirection(Direction::LEFT); break;
+                case ReplayInput::Right:    sim.queueDirection(Direction::RIGHT); break;
+                case ReplayInput::BoostOn:  boostHeld = true; sim.setBoostRequested(true); break;
+                case ReplayInput::BoostOff: boostHeld = false; sim.setBoostRequested(false); break;
+            }
+        }
+    }
+
+    void Replay::begin(const ReplayHeader& newHeader) {
+        header = newHeader;
+        header.finalTick = 0;
+        header.finalScore = 0;
+        header.gameOver = false;
+        stream.clear();
+        eventCount = 0;
+        lastTick = 0;
+        keyframes.clear();
+        keyframeBytes = 0;
+        lastKeyframeTick = 0;
+    }
+
+    void Replay::record(std::uint64_t tick, ReplayInput input) {
+        const std::uint64_t delta = tick >= lastTick ? tick - lastTick : 0;
+        ByteWriter(stream).varint((delta << INPUT_BITS) | static_cast<std::uint64_t>(input));
+        lastTick = std::max(lastTick, tick);
+        ++eventCount;
+    }
+
+    void Replay::captureKeyframe(const Simulation& sim, bool boostHeld) {
+        ReplayKeyframe keyframe;
+        keyframe.tick = sim.getTick();
+        keyframe.eventIndex = eventCount;
+        keyframe.boostHeld = boostHeld;
+        sim.saveState(keyframe.state);
+        keyframeBytes += keyframe.state.size();
+        keyframes.push_back(std::move(keyframe));
+        lastKeyframeTick = sim.getTick();
+
+        // Vượt ngân sách bộ nhớ (bàn chơi lớn, ván dài): bỏ một nửa số keyframe và giãn khoảng cách gấp đôi
+        if (keyframeBytes > static_cast<std::uint64_t>(Config::REPLAY_KEYFRAME_BUDGET_BYTES) && keyframes.size() > 1) {
+            std::vector<ReplayKeyframe> kept;
+            keyframeBytes = 0;
+            for (std::size_t i = 1; i < keyframes.size(); i += 2) {
+                keyframeBytes += keyframes[i].state.size();
+                kept.push_back(std::move(keyframes[i]));
+            }
+            keyframes = std::move(kept);
+            keyframeInterval *= 2;
+        }
+    }
+
+    void Replay::finish(std::uint64_t tick, int score, bool gameOver) {
+        header.finalTick = tick;
+        header.finalScore = std::max(0, score);
+        header.gameOver = gameOver;
+    }
+
+    std::vector<ReplayEvent> Replay::decodeEvents() const {
+        std::vector<ReplayEvent> events;
+        events.reserve(std::min<std::size_t>(eventCount, stream.size())); // Mỗi sự kiện tốn ít nhất 1 byte
+        ByteReader reader(stream.data(), stream.size());
+        std::uint64_t tick = 0;
+        while (reader.remaining() > 0) {
+            const std::uint64_t value = reader.varint();
+            if (!reader.ok()) break;
+            tick += value >> INPUT_BITS;
+            events.push_back({tick, static_cast<ReplayInput>(value & ((1u << INPUT_BITS) - 1))});
+        }
+        return events;
+    }
+
+    std::vector<std::uint8_t> Replay::serialize() const {
+        std::vector<std::uint8_t> out;
+        ByteWriter writer(out);
+        writer.bytes(MAGIC, sizeof(MAGIC));
+        writer.raw(FORMAT_VERSION);
+        writer.varint(header.seed);
+        writer.varint(static_cast<std::uint64_t>(header.mode));
+        writer.varint(static_cast<std::uint64_t>(header.boardWidth));
+        writer.varint(static_cast<std::uint64_t>(header.boardHeight));
+        writer.varint(static_cast<std::uint64_t>(header.obstacleCount));
+        writer.varint(header.finalTick);
+        writer.varint(static_cast<std::uint64_t>(header.finalScore));
+        writer.raw<std::uint8_t>(header.gameOver ? 1 : 0);
+        writer.varint(eventCount);
+        writer.varint(stream.size());
+        writer.bytes(stream.data(), stream.size());
+        writer.varint(keyframes.size());
+        for (const ReplayKeyframe& keyframe : keyframes) {
+            writer.varint(keyframe.tick);
+            writer.varint(keyframe.eventIndex);
+            writer.raw<std::uint8_t>(keyframe.boostHeld ? 1 : 0);
+            writer.varint(keyframe.state.size());
+            writer.bytes(keyframe.state.data(), keyframe.state.size());
+        }
+        return out;
+    }
+
+    bool Replay::deserialize(const std::uint8_t* data, std::size_t size) {
+        ByteReader reader(data, size);
+        std::uint8_t magic[sizeof(MAGIC)] = {};
+        if (!reader.bytes(magic, sizeof(magic)) || !std::equal(std::begin(MAGIC), std::end(MAGIC), magic)) {
+            std::cerr << "Warning: Not a replay file (bad magic)." << std::endl;
+            return false;
+        }
+        const auto version = reader.raw<std::uint8_t>();
+        if (version < OLDEST_READABLE_VERSION || version > FORMAT_VERSION) {
+            std::cerr << "Warning: Unsupported replay format version " << static_cast<int>(version)
+                      << (version < OLDEST_READABLE_VERSION ? " (recorded with an older random generator, cannot be reproduced)." : ".") << std::endl;
+            return false;
+        }
+
+        ReplayHeader loaded;
+        loaded.seed = static_cast<std::uint32_t>(reader.varint());
+        const std::uint64_t mode = reader.varint();
+        const std::uint64_t boardWidth = reader.varint();
+        const std::uint64_t boardHeight = reader.varint();
+        const std::uint64_t obstacleCount = reader.varint();
+        // Kiểm tra trước khi dựng Simulation: bàn chơi 0x0 hay quá lớn làm ReplayPlayer/buildKeyframes sập
+        if (boardWidth < 2 || boardWidth > static_cast<std::uint64_t>(Config::HUGE_BOARD_WIDTH) ||
+            boardHeight < 2 || boardHeight > static_cast<std::uint64_t>(Config::HUGE_BOARD_HEIGHT) ||
+            obstacleCount > boardWidth * boardHeight) {
+            std::cerr << "Warning: Corrupt replay data." << std::endl;
+            return false;
+        }
+        loaded.boardWidth = static_cast<int>(boardWidth);
+        loaded.boardHeight = static_cast<int>(boardHeight);
+        loaded.obstacleCount = static_cast<int>(obstacleCount);
+        loaded.finalTick = reader.varint();
+        loaded.finalScore = static_cast<int>(reader.varint());
+        loaded.gameOver = reader.raw<std::uint8_t>() != 0;
+        const std::uint64_t count = reader.varint();
+        const std::uint64_t streamSize = reader.varint();
+        // Mỗi sự kiện tốn ít nhất 1 byte: số sự kiện lớn hơn dòng byte là dữ liệu hỏng (không được dùng để cấp phát)
+        if (!reader.ok() || mode > static_cast<std::uint64_t>(GameMode::PortalWalls) || streamSize > reader.remaining() ||
+            count > streamSize) {
+            std::cerr << "Warning: Corrupt replay data." << std::endl;
+            return false;
+        }
+        loaded.mode = static_cast<GameMode>(mode);
+        std::vector<std::uint8_t> loadedStream(reader.position(), reader.position() + streamSize);
+        reader.skip(static_cast<std::size_t>(streamSize));
+
+        std::vector<ReplayKeyframe> loadedKeyframes;
+        if (version >= 4) {
+            const std::uint64_t keyframeCount = reader.varint();
+            // Mỗi keyframe tốn ít nhất 4 byte: không cấp phát theo số lượng chưa kiểm tra
+            if (!reader.ok() || keyframeCount > reader.remaining() / 4) {
+                std::cerr << "Warning: Corrupt replay keyframe." << std::endl;
+                return false;
+            }
+            loadedKeyframes.reserve(static_cast<std::size_t>(keyframeCount));
+            for (std::uint64_t i = 0; i < keyframeCount; ++i) {
+                ReplayKeyframe keyframe;
+                keyframe.tick = reader.varint();
+                const std::uint64_t eventIndex = reader.varint();
+                const auto boostHeld = reader.raw<std::uint8_t>();
+                const std::uint64_t stateSize = reader.varint();
+                if (!reader.ok() || stateSize > reader.remaining()) {
+                    std::cerr << "Warning: Corrupt replay keyframe." << std::endl;
+                    return false;
+                }
+                keyframe.eventIndex = static_cast<std::uint32_t>(std::min<std::uint64_t>(eventIndex, count + 1));
+                keyframe.boostHeld = boostHeld != 0;
+                keyframe.state.assign(reader.position(), reader.position() + stateSize);
+                reader.skip(static_cast<std::size_t>(stateSize));
+                loadedKeyframes.push_back(std::move(keyframe));
+            }
+        }
+
+        header = loaded;
+        eventCount = static_cast<std::uint32_t>(count);
+        stream = std::move(loadedStream);
+        const auto events = decodeEvents();
+        lastTick = events.empty() ? 0 : events.back().tick;
+        keyframes.clear();
+        keyframeBytes = 0;
+        for (ReplayKeyframe& keyframe : loadedKeyframes) {
+            if (!validKeyframe(keyframe, events)) {
+                // Dòng sự kiện vẫn dùng được: bỏ mọi keyframe, trình xem dựng lại chúng bằng một lần phát
+                std::cerr << "Warning: Replay keyframe at tick " << keyframe.tick << " is unusable, keyframes will be rebuilt." << std::endl;
+                keyframes.clear();
+                keyframeBytes = 0;
+                break;
+            }
+            keyframeBytes += keyframe.state.size();
+            keyframes.push_back(std::move(keyframe));
+        }
+        lastKeyframeTick = keyframes.empty() ? 0 : keyframes.back().tick;
+        return true;
+    }
+
+    bool Replay::validKeyframe(const ReplayKeyframe& keyframe, const std::vector<ReplayEvent>& events) const {
+        // Tăng dần, nằm trong ván, và eventIndex trỏ đúng vào sự kiện đầu tiên chưa được áp dụng tại tick của nó
+        const std::size_t eventIndex = keyframe.eventIndex;
+        return (keyframes.empty() || keyframe.tick > keyframes.back().tick) && keyframe.tick <= header.finalTick &&
+               eventIndex <= events.size() &&
+               (eventIndex == 0 || events[eventIndex - 1].tick < keyframe.tick) &&
+               (eventIndex == events.size() || events[eventIndex].tick >= keyframe.tick) &&
+               Simulation::checkState(keyframe.state.data(), keyframe.state.size(), header.boardWidth, header.boardHeight);
+    }
+
+    bool Replay::saveToFile(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Warning: Unable to open replay file for writing: " << path << std::endl;
+            return false;
+        }
+        const auto bytes = serialize();
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool Replay::loadFromFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Warning: Unable to open replay file: " << path << std::endl;
+            return false;
+        }
+        const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return deserialize(bytes.data(), bytes.size());
+    }
+
+    ReplayPlayer::ReplayPlayer(const Replay& replay)
+            : header(replay.getHeader()),
+              events(replay.decodeEvents()),
+              keyframes(replay.getKeyframes()),
+              sim(header.boardWidth, header.boardHeight, header.seed, header.mode, header.obstacleCount)
+    {
+        // Constructor của Simulation đã bắt đầu ván với đúng số vật cản: không cần restart() (sinh vật cản lần nữa)
+    }
+
+    void ReplayPlayer::restart() {
+        sim.setInitialObstacleCount(header.obstacleCount);
+        sim.reset(header.seed, header.mode);
+        nextEvent = 0;
+        boostHeld = false;
+    }
+
+    bool ReplayPlayer::atEnd() const {
+        return sim.isGameOver() || sim.getTick() >= header.finalTick;
+    }
+
+    bool ReplayPlayer::step() {
+        if (atEnd()) return false;
+        while (nextEvent < events.size() && events[nextEvent].tick <= sim.getTick()) {
+            applyInput(sim, events[nextEvent].input, boostHeld);
+            ++nextEvent;
+        }
+        sim.step({std::nullopt, boostHeld});
+        return true;
+    }
+
+    void ReplayPlayer::runToEnd() {
+        while (step()) {}
+    }
+
+    bool ReplayPlayer::restoreKeyframe(const ReplayKeyframe& keyframe) {
+        if (keyframe.eventIndex > events.size() || !sim.loadState(keyframe.state.data(), keyframe.state.size())) {
+            std::cerr << "Warning: Replay keyframe at tick " << keyframe.tick << " is unusable, replaying from the start." << std::endl;
+            restart();
+            return false;
+        }
+        nextEvent = keyframe.eventIndex;
+        boostHeld = keyframe.boostHeld;
+        return true;
+    }
+
+    void ReplayPlayer::seek(std::uint64_t tick) {
+        tick = std::min(tick, header.finalTick);
+        // Keyframe cuối cùng có tick <= đích
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), tick,
+                                   [](std::uint64_t value, const ReplayKeyframe& keyframe) { return value < keyframe.tick; });
+        const ReplayKeyframe* keyframe = it == keyframes.begin() ? nullptr : &*(it - 1);
+        const std::uint64_t keyframeTick = keyframe ? keyframe->tick : 0;
+
+        // Nếu vị trí hiện tại nằm giữa keyframe và đích thì chỉ cần chạy tiếp
+        const std::uint64_t current = sim.getTick();
+        if (current > tick || current < keyframeTick) {
+            if (!keyframe || !restoreKeyframe(*keyframe)) restart();
+        }
+        while (sim.getTick() < tick && step()) {}
+    }
+
+    void ReplayPlayer::buildKeyframes(std::uint64_t interval) {
+        if (!keyframes.empty() || interval == 0) return;
+        restart();
+        // Giãn khoảng cách để tổng kích thước keyframe nằm trong ngân sách bộ nhớ (ảnh chụp bàn chơi lớn tới vài chục MB)
+        std::vector<std::uint8_t> probe;
+        sim.saveState(probe);
+        const std::uint64_t budgetCount = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(Config::REPLAY_KEYFRAME_BUDGET_BYTES) / std::max<std::size_t>(1, probe.size()));
+        while (header.finalTick / interval > budgetCount) interval *= 2;
+        while (step()) {
+            if (sim.getTick() % interval == 0 && !atEnd()) {
+                ReplayKeyframe keyframe;
+                keyframe.tick = sim.getTick();
+                // Sự kiện của tick này chưa được áp dụng (step() áp dụng chúng ở lần gọi sau)
+                keyframe.eventIndex = static_cast<std::uint32_t>(nextEvent);
+                keyframe.boostHeld = boostHeld;
+                sim.saveState(keyframe.state);
+                keyframes.push_back(std::move(keyframe));
+            }
+        }
+        restart();
+    }
+
+    bool ReplayPlayer::matchesRecording() const {
+        return sim.getTick() == header.finalTick && sim.getScore() == header.finalScore && sim.isGameOver() == header.gameOver;
+    }
+
+}
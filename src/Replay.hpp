@@ -0,0 +1,202 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "Simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    ReplayInput
+     *    Một thay đổi input được ghi lại: lệnh đổi hướng hoặc nhấn/nhả phím boost.
+     */
+    enum class ReplayInput : std::uint8_t { Up, Down, Left, Right, BoostOn, BoostOff };
+
+    /**    Mã input tương ứng với một lệnh đổi hướng. */
+    [[nodiscard]] inline ReplayInput replayInputFor(Direction dir) {
+        switch (dir) {
+            case Direction::UP:    return ReplayInput::Up;
+            case Direction::DOWN:  return ReplayInput::Down;
+            case Direction::LEFT:  return ReplayInput::Left;
+            case Direction::RIGHT: return ReplayInput::Right;
+        }
+        return ReplayInput::Up;
+    }
+
+    /**
+     *    ReplayEvent
+     *    Một sự kiện input đã giải mã: xảy ra khi mô phỏng đã chạy xong tick bước (trước bước tick + 1).
+     */
+    struct ReplayEvent {
+        std::uint64_t tick = 0;
+        ReplayInput input = ReplayInput::Up;
+    };
+
+    /**
+     *    ReplayHeader
+     *    Thông tin để dựng lại ván chơi và kết quả cuối để kiểm tra khi phát lại.
+     */
+    struct ReplayHeader {
+        std::uint32_t seed = 0;
+        GameMode mode = GameMode::Classic;
+        int boardWidth = Config::BOARD_WIDTH;
+        int boardHeight = Config::BOARD_HEIGHT;
+        int obstacleCount = Config::OBSTACLE_COUNT;
+        std::uint64_t finalTick = 0;  // Số bước đã chạy khi kết thúc ghi
+        int finalScore = 0;
+        bool gameOver = false;        // true nếu ván kết thúc do va chạm (false: bị bỏ dở)
+    };
+
+    /**
+     *    ReplayKeyframe
+     *    Ảnh chụp trạng thái mô phỏng sau bước tick, cùng vị trí trong dòng sự kiện và trạng thái giữ boost tại đó.
+     */
+    struct ReplayKeyframe {
+        std::uint64_t tick = 0;
+        std::uint32_t eventIndex = 0;     // Chỉ số sự kiện đầu tiên chưa được áp dụng (tick của nó >= tick)
+        bool boostHeld = false;
+        std::vector<std::uint8_t> state;  // Simulation::saveState
+    };
+
+    /**
+     *    Replay
+     *    Bản ghi nhị phân gọn của một ván chơi có seed: header + dòng sự kiện input + keyframe.
+     *        Mỗi sự kiện là một varint (LEB128) của (số tick kể từ sự kiện trước << 3) | mã input,
+     *        nên thường chỉ tốn 1-2 byte; cả ván thường chỉ vài trăm byte.
+     *        Vì lõi mô phỏng tất định theo seed, header + sự kiện là đủ để tái tạo chính xác ván chơi.
+     *        Keyframe (mỗi keyframeInterval bước) chỉ để tua nhanh tới một tick bất kỳ. Chúng được ghi vào file
+     *        và được kiểm tra khi đọc (Simulation::checkState); keyframe không dùng được thì bị bỏ và dựng lại khi mở.
+     */
+    class Replay {
+    public:
+        /**    Bắt đầu bản ghi mới (xóa sự kiện cũ). */
+        void begin(const ReplayHeader& header);
+
+        /**
+         *    Ghi một sự kiện input.
+         *    tick Số bước mô phỏng đã chạy tại thời điểm input (Simulation::getTick()); không được giảm.
+         *    input Loại input.
+         */
+        void record(std::uint64_t tick, ReplayInput input);
+
+        /**    true nếu đã tới lúc chụp keyframe mới (tick cách keyframe trước ít nhất keyframeInterval). */
+        [[nodiscard]] bool wantsKeyframe(std::uint64_t tick) const {
+            return keyframeInterval > 0 && tick >= lastKeyframeTick + keyframeInterval;
+        }
+
+        /**    Chụp keyframe từ trạng thái hiện tại của mô phỏng (gọi ngay sau step(), trước khi ghi input của tick mới). */
+        void captureKeyframe(const Simulation& sim, bool boostHeld);
+
+        /**
+         *    Đổi khoảng cách giữa các keyframe (0 = không chụp).
+         *        Khoảng cách tự nhân đôi (bỏ một nửa keyframe đã có) khi tổng kích thước vượt REPLAY_KEYFRAME_BUDGET_BYTES.
+         */
+        void setKeyframeInterval(std::uint64_t interval) { keyframeInterval = interval; }
+
+        /**    Kết thúc bản ghi với kết quả cuối của ván. */
+        void finish(std::uint64_t tick, int score, bool gameOver);
+
+        /**    Giải mã toàn bộ dòng sự kiện. */
+        [[nodiscard]] std::vector<ReplayEvent> decodeEvents() const;
+
+        /**    Mã hóa bản ghi thành mảng byte (định dạng file). */
+        [[nodiscard]] std::vector<std::uint8_t> serialize() const;
+
+        /**
+         *    Đọc bản ghi từ mảng byte; false (kèm cảnh báo) nếu dữ liệu hỏng.
+         *        File bản 3 (chưa có keyframe) vẫn đọc được; keyframe sai thứ tự, sai vị trí sự kiện hoặc có ảnh chụp
+         *        không qua Simulation::checkState thì mọi keyframe bị bỏ (kèm cảnh báo) nhưng bản ghi vẫn dùng được.
+         */
+        bool deserialize(const std::uint8_t* data, std::size_t size);
+
+        /**    Ghi bản ghi ra file; false nếu không ghi được. */
+        bool saveToFile(const std::string& path) const;
+
+        /**    Đọc bản ghi từ file; false nếu không đọc được hoặc sai định dạng. */
+        bool loadFromFile(const std::string& path);
+
+        [[nodiscard]] const ReplayHeader& getHeader() const { return header; }
+        [[nodiscard]] std::uint32_t getEventCount() const { return eventCount; }
+        [[nodiscard]] std::size_t getStreamSize() const { return stream.size(); }
+        [[nodiscard]] const std::vector<ReplayKeyframe>& getKeyframes() const { return keyframes; }
+
+    private:
+        ReplayHeader header;
+        std::vector<std::uint8_t> stream;   // Các sự kiện đã mã hóa varint-delta
+        std::uint32_t eventCount = 0;
+        std::uint64_t lastTick = 0;         // Tick của sự kiện gần nhất (để mã hóa delta)
+        std::vector<ReplayKeyframe> keyframes;
+        std::uint64_t keyframeBytes = 0;    // Tổng kích thước ảnh chụp của các keyframe
+        std::uint64_t keyframeInterval = Config::REPLAY_KEYFRAME_INTERVAL;
+        std::uint64_t lastKeyframeTick = 0;
+
+        /**    true nếu keyframe đọc từ file dùng được sau các keyframe đã nhận (events: dòng sự kiện đã giải mã). */
+        [[nodiscard]] bool validKeyframe(const ReplayKeyframe& keyframe, const std::vector<ReplayEvent>& events) const;
+    };
+
+    /**
+     *    ReplayPlayer
+     *    Phát lại một Replay trên Simulation headless với tốc độ tối đa của CPU:
+     *        trước mỗi bước, áp dụng các sự kiện của tick đó đúng như Game đã làm (queueDirection / setBoostRequested),
+     *        rồi gọi step() với trạng thái giữ boost hiện tại.
+     *        seek() khôi phục keyframe gần nhất trước tick đích rồi chỉ mô phỏng tiếp phần còn lại
+     *        (tối đa keyframeInterval bước), nên tua tới/lui trong ván dài hàng giờ vẫn tức thời.
+     */
+    class ReplayPlayer {
+    public:
+        explicit ReplayPlayer(const Replay& replay);
+
+        /**    Quay về đầu ván. */
+        void restart();
+
+        /**    Chạy một bước; false nếu đã tới cuối bản ghi. */
+        bool step();
+
+        /**    Chạy tới cuối bản ghi. */
+        void runToEnd();
+
+        /**    Tua tới tick cho trước (bị chặn trong [0, finalTick]), tiến hoặc lùi. */
+        void seek(std::uint64_t tick);
+
+        /**
+         *    Tự dựng keyframe bằng một lần chạy hết bản ghi (cho replay không chứa keyframe: file bản 3
+         *        hoặc có keyframe bị bỏ khi đọc).
+         *        Khoảng cách được giãn nếu cần để tổng kích thước nằm trong REPLAY_KEYFRAME_BUDGET_BYTES.
+         *        Không làm gì nếu bản ghi đã có keyframe. Vị trí phát được đưa về đầu ván.
+         */
+        void buildKeyframes(std::uint64_t interval = Config::REPLAY_KEYFRAME_INTERVAL);
+
+        /**    Bật/tắt nhật ký thay đổi lưới của mô phỏng đang phát (minimap). */
+        void setGridChangeTracking(bool enabled) { sim.setGridChangeTracking(enabled); }
+        /**    Xóa nhật ký thay đổi lưới sau khi tầng hiển thị đã xử lý. */
+        void clearGridChanges() { sim.clearGridChanges(); }
+
+        /**    true nếu đã chạy hết finalTick bước hoặc ván đã kết thúc. */
+        [[nodiscard]] bool atEnd() const;
+
+        /**    true nếu kết quả phát lại (tick, điểm, trạng thái kết thúc) khớp với kết quả đã ghi. */
+        [[nodiscard]] bool matchesRecording() const;
+
+        [[nodiscard]] const Simulation& getSimulation() const { return sim; }
+        [[nodiscard]] const ReplayHeader& getHeader() const { return header; }
+        [[nodiscard]] std::uint64_t getTick() const { return sim.getTick(); }
+        [[nodiscard]] std::size_t getKeyframeCount() const { return keyframes.size(); }
+
+    private:
+        ReplayHeader header;
+        std::vector<ReplayEvent> events;
+        std::vector<ReplayKeyframe> keyframes;  // Theo thứ tự tick tăng dần
+        Simulation sim;
+        std::size_t nextEvent = 0;
+        bool boostHeld = false;
+
+        /**    Đưa mô phỏng về trạng thái của keyframe; false nếu ảnh chụp hỏng (khi đó phát lại từ đầu). */
+        bool restoreKeyframe(const ReplayKeyframe& keyframe);
+    };
+
+}
+
+#endif
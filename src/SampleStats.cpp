@@ -0,0 +1,40 @@
+#include "SampleStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace SnakeGame {
+
+    namespace {
+        /**    Phân vị theo hạng gần nhất của một mảng đã sắp xếp. */
+        double percentile(const std::vector<double>& sorted, double fraction) {
+            const auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+            return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+        }
+    }
+
+    SampleStats SampleStats::of(std::vector<double>& values) {
+        SampleStats stats;
+        stats.count = values.size();
+        if (values.empty()) return stats;
+        std::sort(values.begin(), values.end());
+
+        double sum = 0.0;
+        for (double value : values) sum += value;
+        stats.mean = sum / static_cast<double>(values.size());
+        if (values.size() > 1) {
+            double squares = 0.0;
+            for (double value : values) squares += (value - stats.mean) * (value - stats.mean);
+            stats.stddev = std::sqrt(squares / static_cast<double>(values.size() - 1));
+            stats.ci95 = 1.96 * stats.stddev / std::sqrt(static_cast<double>(values.size()));
+        }
+        stats.min = values.front();
+        stats.p10 = percentile(values, 0.10);
+        stats.p50 = percentile(values, 0.50);
+        stats.p90 = percentile(values, 0.90);
+        stats.p95 = percentile(values, 0.95);
+        stats.p99 = percentile(values, 0.99);
+        stats.max = values.back();
+        return stats;
+    }
+
+}
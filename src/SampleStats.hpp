@@ -0,0 +1,34 @@
+#ifndef SAMPLE_STATS_HPP
+#define SAMPLE_STATS_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    SampleStats
+     *    Thống kê mô tả của một mẫu: trung bình, độ lệch chuẩn, nửa độ rộng khoảng tin cậy 95% của trung bình
+     *        (xấp xỉ chuẩn, 1.96 * s / sqrt(n)) và các phân vị theo hạng gần nhất.
+     *        Dùng chung cho kết quả giải đấu bot (Tournament) và độ trễ input của game (InputLatencyMonitor).
+     */
+    struct SampleStats {
+        std::size_t count = 0;
+        double mean = 0.0;
+        double stddev = 0.0;
+        double ci95 = 0.0;
+        double min = 0.0;
+        double p10 = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+
+        /**    Tính thống kê của values (mảng được sắp xếp tại chỗ). */
+        static SampleStats of(std::vector<double>& values);
+    };
+
+}
+
+#endif
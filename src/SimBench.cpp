@@ -0,0 +1,602 @@
+// vorax_sim: chạy lõi mô phỏng headless cho nhiều seed liên tiếp và báo cáo ticks/giây.
+// Dùng cho cân bằng luật chơi, kiểm tra hồi quy và đo hiệu năng của vorax_core.
+
+#include "Simulation.hpp"
+#include "Arena.hpp"
+#include "BatchEnv.hpp"
+#include "Replay.hpp"
+#include "Autopilot.hpp"
+#include "Tournament.hpp"
+#include "Lookahead.hpp"
+#include "JobSystem.hpp"
+#include "CoreConfig.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace SnakeGame;
+
+namespace {
+
+    constexpr std::size_t GAMES_PER_JOB = 8; // Số ván liên tiếp mỗi công việc trong chế độ quét seed
+
+    enum class BotKind { Greedy, AStar };
+
+    struct BenchOptions {
+        int games = 1000;
+        std::uint32_t firstSeed = 1;
+        GameMode mode = GameMode::Classic;
+        bool modeSpecified = false;
+        std::uint64_t maxTicks = 100000; // Giới hạn số bước mỗi ván để bot không chạy vô tận
+        int boardWidth = Config::BOARD_WIDTH;
+        int boardHeight = Config::BOARD_HEIGHT;
+        int obstacles = Config::OBSTACLE_COUNT;
+        bool boardSpecified = false;
+        bool maxTicksSpecified = false;
+        int arenaSnakes = 0;            // > 0: chạy chế độ Arena với số rắn này thay vì các ván đơn
+        unsigned threads = 0;           // Số luồng cho Arena/BatchEnv (0 = số nhân CPU)
+        int batchSize = 0;              // > 0: chạy --games ván qua BatchEnv với số môi trường này
+        std::string replayPath;         // Phát lại file replay này (headless) và kiểm tra kết quả
+        std::string recordPath;         // Ghi replay của ván bot với seed --seed vào file này
+        bool snapshot = false;          // Đo thời gian chụp/khôi phục trạng thái trong một ván bot
+        BotKind bot = BotKind::Greedy;  // Bot cho quét seed và --record
+        bool tournament = false;        // Cho mọi bot (hoặc --agents) chơi --games seed trên cả hai chế độ (hoặc --mode)
+        std::string agents;             // Danh sách bot của giải, cách nhau bằng dấu phẩy (rỗng = tất cả)
+        std::string csvPath;            // Ghi bảng kết quả của giải ra file CSV này
+    };
+
+    void printUsage(const char* exe) {
+        std::cout << "Usage: " << exe << " [--games N] [--seed S] [--mode classic|portal] [--max-ticks T] [--board WxH] [--obstacles N] [--arena SNAKES] [--batch N] [--threads T] [--replay FILE] [--record FILE] [--snapshot] [--bot greedy|astar] [--tournament [--agents A,B] [--csv FILE]]" << std::endl;
+    }
+
+    bool parseArgs(int argc, char* argv[], BenchOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--games" && hasValue) {
+                options.games = std::atoi(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.firstSeed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--mode" && hasValue) {
+                std::string mode = argv[++i];
+                if (mode == "classic") options.mode = GameMode::Classic;
+                else if (mode == "portal") options.mode = GameMode::PortalWalls;
+                else return false;
+                options.modeSpecified = true;
+            } else if (arg == "--max-ticks" && hasValue) {
+                options.maxTicks = std::strtoull(argv[++i], nullptr, 10);
+                options.maxTicksSpecified = true;
+            } else if (arg == "--board" && hasValue) {
+                options.boardSpecified = true;
+                if (std::sscanf(argv[++i], "%dx%d", &options.boardWidth, &options.boardHeight) != 2) return false;
+                if (options.boardWidth < 2 || options.boardHeight < 2) return false;
+            } else if (arg == "--obstacles" && hasValue) {
+                options.obstacles = std::atoi(argv[++i]);
+            } else if (arg == "--arena" && hasValue) {
+                options.arenaSnakes = std::atoi(argv[++i]);
+                if (options.arenaSnakes <= 0) return false;
+            } else if (arg == "--batch" && hasValue) {
+                options.batchSize = std::atoi(argv[++i]);
+                if (options.batchSize <= 0) return false;
+            } else if (arg == "--replay" && hasValue) {
+                options.replayPath = argv[++i];
+            } else if (arg == "--record" && hasValue) {
+                options.recordPath = argv[++i];
+            } else if (arg == "--bot" && hasValue) {
+                std::string bot = argv[++i];
+                if (bot == "greedy") options.bot = BotKind::Greedy;
+                else if (bot == "astar") options.bot = BotKind::AStar;
+                else return false;
+            } else if (arg == "--tournament") {
+                options.tournament = true;
+            } else if (arg == "--agents" && hasValue) {
+                options.agents = argv[++i];
+            } else if (arg == "--csv" && hasValue) {
+                options.csvPath = argv[++i];
+            } else if (arg == "--snapshot") {
+                options.snapshot = true;
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            } else {
+                return false;
+            }
+        }
+        return options.games > 0;
+    }
+
+    Point offsetFor(Direction dir) {
+        switch (dir) {
+            case Direction::UP:    return {0, -1};
+            case Direction::DOWN:  return {0, 1};
+            case Direction::LEFT:  return {-1, 0};
+            case Direction::RIGHT: return {1, 0};
+        }
+        return {0, 0};
+    }
+
+    /**
+     *    Bot tham lam đơn giản: trong các hướng không gây chết ngay, chọn hướng làm giảm
+     *        khoảng cách Manhattan tới mồi. Đủ để ván chơi kéo dài và chạm tới mọi nhánh luật.
+     */
+    Direction chooseGreedyDirection(const Simulation& sim) {
+        const Snake& snake = sim.getSnake();
+        const Point head = snake.getHeadPosition();
+        const Point food = sim.getFoodPosition();
+        const Direction current = snake.getCurrentDirection();
+
+        Direction best = current;
+        int bestDistance = -1;
+        for (Direction dir : {Direction::UP, Direction::DOWN, Direction::LEFT, Direction::RIGHT}) {
+            Point delta = offsetFor(dir);
+            Point currentDelta = offsetFor(current);
+            if (delta.x == -currentDelta.x && delta.y == -currentDelta.y) continue; // Không quay đầu
+
+            Point next = {head.x + delta.x, head.y + delta.y};
+            if (sim.checkMove(next) != CollisionCause::None) continue;
+
+            next = sim.wrapPosition(next);
+            int distance = std::abs(next.x - food.x) + std::abs(next.y - food.y);
+            if (bestDistance < 0 || distance < bestDistance) {
+                bestDistance = distance;
+                best = dir;
+            }
+        }
+        return best;
+    }
+
+    /**
+     *    Bot được chọn bằng --bot: tham lam (không trạng thái) hoặc Autopilot A* (giữ đường đi giữa các bước,
+     *        nên mỗi luồng/ván dùng một đối tượng riêng).
+     */
+    struct BenchBot {
+        BotKind kind;
+        Autopilot autopilot;
+
+        explicit BenchBot(BotKind kind) : kind(kind) {}
+
+        Direction choose(const Simulation& sim) {
+            return kind == BotKind::AStar ? autopilot.chooseDirection(sim) : chooseGreedyDirection(sim);
+        }
+    };
+
+    ActionTurn toTurn(Direction dir) {
+        switch (dir) {
+            case Direction::UP:    return ActionTurn::Up;
+            case Direction::DOWN:  return ActionTurn::Down;
+            case Direction::LEFT:  return ActionTurn::Left;
+            case Direction::RIGHT: return ActionTurn::Right;
+        }
+        return ActionTurn::Keep;
+    }
+
+    /**
+     *    Chạy --games ván bằng bot tham lam qua BatchEnv (batchSize môi trường bước cùng lúc, auto-reset)
+     *        và in thông lượng. Ván chỉ được tính khi kết thúc; các ván còn dở lúc dừng bị bỏ qua.
+     */
+    int runBatch(const BenchOptions& options) {
+        BatchEnvConfig config;
+        config.boardWidth = options.boardWidth;
+        config.boardHeight = options.boardHeight;
+        config.obstacleCount = options.obstacles;
+        config.mode = options.mode;
+        config.maxEpisodeTicks = options.maxTicks;
+
+        JobSystem jobs(options.threads);
+        BatchEnv env(options.batchSize, config, options.firstSeed, &jobs);
+        std::vector<Action> actions(static_cast<size_t>(env.getCount()));
+
+        int finished = 0;
+        std::uint64_t totalTicks = 0;
+        std::uint64_t episodeTicks = 0;
+        std::int64_t totalScore = 0;
+        int bestScore = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (finished < options.games) {
+            jobs.parallelFor(actions.size(), [&](size_t i) {
+                actions[i].turn = toTurn(chooseGreedyDirection(env.getSimulation(static_cast<int>(i))));
+            }, 16);
+            const BatchStepResult& result = env.step(actions.data());
+            totalTicks += actions.size();
+            for (int i = 0; i < env.getCount() && finished < options.games; ++i) {
+                if (!result.done[i]) continue;
+                ++finished;
+                episodeTicks += result.episodeTicks[i];
+                totalScore += result.episodeScores[i];
+                bestScore = std::max(bestScore, result.episodeScores[i]);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << "Batch: " << env.getCount() << " envs"
+                  << " | Mode: " << (options.mode == GameMode::Classic ? "Classic" : "Portal")
+                  << " | Board: " << options.boardWidth << "x" << options.boardHeight
+                  << " | Obstacles: " << options.obstacles
+                  << " | Threads: " << jobs.getThreadCount()
+                  << " | Seed: " << options.firstSeed << std::endl;
+        std::cout << "Steps: " << totalTicks << " in " << seconds << " s"
+                  << " | Steps/sec: " << (seconds > 0.0 ? static_cast<double>(totalTicks) / seconds : 0.0)
+                  << " | Games/sec: " << (seconds > 0.0 ? finished / seconds : 0.0) << std::endl;
+        std::cout << "Games: " << finished << " | Mean ticks: " << static_cast<double>(episodeTicks) / finished
+                  << " | Mean score: " << static_cast<double>(totalScore) / finished
+                  << " | Best score: " << bestScore << std::endl;
+        return 0;
+    }
+
+    /**
+     *    Chơi một ván bằng bot --bot với seed --seed và lưu replay (chỉ ghi khi hướng thay đổi, như người chơi thật).
+     */
+    int runRecord(const BenchOptions& options) {
+        Simulation sim(options.boardWidth, options.boardHeight, options.firstSeed, options.mode, options.obstacles);
+
+        Replay replay;
+        ReplayHeader header;
+        header.seed = options.firstSeed;
+        header.mode = options.mode;
+        header.boardWidth = options.boardWidth;
+        header.boardHeight = options.boardHeight;
+        header.obstacleCount = options.obstacles;
+        replay.begin(header);
+        BenchBot bot(options.bot);
+        while (!sim.isGameOver() && sim.getTick() < options.maxTicks) {
+            const Direction dir = bot.choose(sim);
+            if (dir != sim.getSnake().getCurrentDirection()) {
+                replay.record(sim.getTick(), replayInputFor(dir));
+                sim.queueDirection(dir);
+            }
+            sim.step({});
+            if (!sim.isGameOver() && replay.wantsKeyframe(sim.getTick())) {
+                replay.captureKeyframe(sim, false);
+            }
+        }
+        replay.finish(sim.getTick(), sim.getScore(), sim.isGameOver());
+        if (!replay.saveToFile(options.recordPath)) return 1;
+        std::cout << "Recorded seed " << options.firstSeed << ": " << sim.getTick() << " ticks, score " << sim.getScore()
+                  << ", " << replay.getEventCount() << " events, " << replay.getKeyframes().size() << " keyframes, "
+                  << replay.serialize().size() << " bytes -> " << options.recordPath << std::endl;
+        return 0;
+    }
+
+    /**
+     *    Chơi một ván bot tham lam với seed --seed; sau mỗi bước chụp trạng thái vào một bộ đệm dùng lại
+     *        và khôi phục vào một Simulation thứ hai, rồi kiểm tra hai bản sao giống hệt nhau khi tiếp tục chạy.
+     */
+    int runSnapshot(const BenchOptions& options) {
+        Simulation sim(options.boardWidth, options.boardHeight, options.firstSeed, options.mode, options.obstacles);
+        Simulation mirror(options.boardWidth, options.boardHeight, options.firstSeed, options.mode, options.obstacles);
+        const std::uint64_t ticks = options.maxTicksSpecified ? options.maxTicks : 2000;
+
+        std::vector<std::uint8_t> buffer;
+        double saveSeconds = 0.0;
+        double restoreSeconds = 0.0;
+        std::uint64_t count = 0;
+        bool restored = true;
+        while (!sim.isGameOver() && sim.getTick() < ticks) {
+            sim.step({chooseGreedyDirection(sim), false});
+            auto start = std::chrono::steady_clock::now();
+            sim.saveState(buffer);
+            auto saved = std::chrono::steady_clock::now();
+            restored = mirror.loadState(buffer.data(), buffer.size()) && restored;
+            auto end = std::chrono::steady_clock::now();
+            saveSeconds += std::chrono::duration<double>(saved - start).count();
+            restoreSeconds += std::chrono::duration<double>(end - saved).count();
+            ++count;
+        }
+
+        // Bản khôi phục phải tiếp tục giống hệt bản gốc (kể cả vị trí mồi mới, phụ thuộc thứ tự tập ô trống)
+        std::vector<std::uint8_t> original;
+        std::vector<std::uint8_t> copy;
+        bool match = restored;
+        for (int i = 0; i < 500 && match && !sim.isGameOver(); ++i) {
+            const auto direction = chooseGreedyDirection(sim);
+            sim.step({direction, false});
+            mirror.step({direction, false});
+            sim.saveState(original);
+            mirror.saveState(copy);
+            match = original == copy;
+        }
+
+        const double perSave = count > 0 ? saveSeconds / static_cast<double>(count) * 1e9 : 0.0;
+        const double perRestore = count > 0 ? restoreSeconds / static_cast<double>(count) * 1e9 : 0.0;
+        std::cout << "Snapshot: " << buffer.size() << " bytes | Board: " << options.boardWidth << "x" << options.boardHeight
+                  << " | Obstacles: " << sim.getObstacles().size() << " | Snake length: " << sim.getSnake().getBody().size() << std::endl;
+        std::cout << "Snapshots: " << count << " | Save: " << perSave << " ns | Restore: " << perRestore << " ns" << std::endl;
+        std::cout << (match ? "Snapshot verified." : "Snapshot MISMATCH.") << std::endl;
+        return match ? 0 : 1;
+    }
+
+    /**
+     *    Phát lại một file replay headless với tốc độ tối đa và so sánh với kết quả đã ghi,
+     *        kể cả từng keyframe trong file với trạng thái phát lại tại cùng tick.
+     *        Trả về 1 nếu không đọc được file hoặc kết quả lệch (mô phỏng không còn tất định với bản ghi).
+     */
+    int runReplay(const BenchOptions& options) {
+        Replay replay;
+        if (!replay.loadFromFile(options.replayPath)) return 1;
+        const ReplayHeader& header = replay.getHeader();
+
+        auto start = std::chrono::steady_clock::now();
+        ReplayPlayer player(replay);
+        const std::vector<ReplayKeyframe>& keyframes = replay.getKeyframes();
+        std::size_t nextKeyframe = 0;
+        std::size_t keyframeMismatches = 0;
+        std::vector<std::uint8_t> state;
+        while (player.step()) {
+            if (nextKeyframe < keyframes.size() && player.getTick() == keyframes[nextKeyframe].tick) {
+                player.getSimulation().saveState(state);
+                if (state != keyframes[nextKeyframe].state) ++keyframeMismatches;
+                ++nextKeyframe;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        const Simulation& sim = player.getSimulation();
+        std::cout << "Replay: " << options.replayPath << " | Seed: " << header.seed
+                  << " | Mode: " << (header.mode == GameMode::Classic ? "Classic" : "Portal")
+                  << " | Board: " << header.boardWidth << "x" << header.boardHeight
+                  << " | Events: " << replay.getEventCount() << " (" << replay.getStreamSize() << " bytes)"
+                  << " | Keyframes: " << keyframes.size() << std::endl;
+        std::cout << "Recorded: " << header.finalTick << " ticks, score " << header.finalScore << (header.gameOver ? ", game over" : ", unfinished")
+                  << " | Replayed: " << sim.getTick() << " ticks, score " << sim.getScore() << (sim.isGameOver() ? ", game over" : ", unfinished")
+                  << " in " << seconds << " s" << std::endl;
+        if (keyframeMismatches > 0) std::cout << "Keyframes differing from playback: " << keyframeMismatches << std::endl;
+        const bool match = player.matchesRecording() && keyframeMismatches == 0;
+        std::cout << (match ? "Replay verified." : "Replay MISMATCH.") << std::endl;
+        return match ? 0 : 1;
+    }
+
+    /**
+     *    Chạy một ván Arena toàn bot trong maxTicks bước (mặc định 2000) và in thông lượng cùng mã băm trạng thái.
+     *        Mã băm phải giống nhau với mọi giá trị --threads.
+     */
+    int runArena(const BenchOptions& options) {
+        ArenaConfig config;
+        if (options.boardSpecified) {
+            config.boardWidth = options.boardWidth;
+            config.boardHeight = options.boardHeight;
+        }
+        config.snakeCount = options.arenaSnakes;
+        config.foodCount = options.arenaSnakes;
+        config.mode = options.mode;
+        const std::uint64_t ticks = options.maxTicksSpecified ? options.maxTicks : 2000;
+
+        JobSystem jobs(options.threads);
+        Arena arena(config, options.firstSeed, &jobs);
+
+        std::uint64_t snakeTicks = 0;
+        std::uint64_t foodEaten = 0;
+        std::uint64_t deaths = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::uint64_t t = 0; t < ticks; ++t) {
+            snakeTicks += static_cast<std::uint64_t>(arena.getAliveCount());
+            arena.step();
+            for (int i = 0; i < arena.getSnakeCount(); ++i) {
+                foodEaten += arena.getEvent(i).ateFood ? 1 : 0;
+                deaths += arena.getEvent(i).died ? 1 : 0;
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        std::cout << "Arena: " << config.snakeCount << " snakes"
+                  << " | Mode: " << (options.mode == GameMode::Classic ? "Classic" : "Portal")
+                  << " | Board: " << config.boardWidth << "x" << config.boardHeight
+                  << " | Threads: " << jobs.getThreadCount()
+                  << " | Seed: " << options.firstSeed << std::endl;
+        std::cout << "Ticks: " << ticks << " in " << seconds << " s"
+                  << " | Ticks/sec: " << (seconds > 0.0 ? static_cast<double>(ticks) / seconds : 0.0)
+                  << " | Snake-ticks/sec: " << (seconds > 0.0 ? static_cast<double>(snakeTicks) / seconds : 0.0) << std::endl;
+        std::cout << "Alive at end: " << arena.getAliveCount() << " | Food eaten: " << foodEaten << " | Deaths: " << deaths
+                  << " | State hash: " << std::hex << std::setw(16) << std::setfill('0') << arena.stateHash() << std::dec << std::endl;
+        return 0;
+    }
+
+    /**
+     *    Các bot có thể tham gia giải (--agents chọn theo tên). Mỗi ván nhận một bot mới từ create().
+     */
+    std::vector<TournamentAgent> availableAgents() {
+        return {
+            {"greedy", [] { return AgentPolicy(chooseGreedyDirection); }},
+            {"astar", [] {
+                auto autopilot = std::make_shared<Autopilot>();
+                return AgentPolicy([autopilot](const Simulation& sim) { return autopilot->chooseDirection(sim); });
+            }},
+            {"lookahead", [] {
+                auto agent = std::make_shared<LookaheadAgent>();
+                agent->setNodeBudget(Config::LOOKAHEAD_BENCH_NODE_BUDGET);
+                return AgentPolicy([agent](const Simulation& sim) { return agent->chooseDirection(sim); });
+            }},
+        };
+    }
+
+    /**
+     *    Cho các bot đã chọn chơi --games seed trên mỗi chế độ và in điểm, số bước sống sót, nguyên nhân chết
+     *        và thông lượng (kèm khoảng tin cậy 95%). Với --csv, ghi thêm một dòng cho mỗi (bot, chế độ)
+     *        để so sánh hai bản build khi đổi hằng số luật chơi.
+     */
+    int runTournament(const BenchOptions& options) {
+        TournamentConfig config;
+        config.boardWidth = options.boardWidth;
+        config.boardHeight = options.boardHeight;
+        config.obstacleCount = options.obstacles;
+        if (options.modeSpecified) config.modes = {options.mode};
+        config.firstSeed = options.firstSeed;
+        config.seedCount = options.games;
+        config.maxTicks = options.maxTicks;
+
+        Tournament tournament(config);
+        const std::vector<TournamentAgent> registry = availableAgents();
+        if (options.agents.empty()) {
+            for (const TournamentAgent& agent : registry) tournament.addAgent(agent);
+        } else {
+            std::stringstream names(options.agents);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                auto it = std::find_if(registry.begin(), registry.end(), [&](const TournamentAgent& agent) { return agent.name == name; });
+                if (it == registry.end()) {
+                    std::cerr << "Unknown agent: " << name << " (available:";
+                    for (const TournamentAgent& agent : registry) std::cerr << " " << agent.name;
+                    std::cerr << ")" << std::endl;
+                    return 1;
+                }
+                tournament.addAgent(*it);
+            }
+        }
+
+        JobSystem jobs(options.threads);
+        const TournamentReport report = tournament.run(jobs);
+
+        static const char* const CAUSE_NAMES[] = {"None", "Wall", "Obstacle", "Self", "ObstacleIntoHead", "ObstacleIntoBody", "OtherSnake", "HeadOn"};
+        std::cout << "Tournament: " << tournament.getAgents().size() << " agents x " << config.modes.size() << " modes x " << config.seedCount << " seeds"
+                  << " | Board: " << config.boardWidth << "x" << config.boardHeight
+                  << " | Obstacles: " << config.obstacleCount
+                  << " | Threads: " << report.threads
+                  << " | Seeds: " << config.firstSeed << ".." << (config.firstSeed + config.seedCount - 1) << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (const TournamentResult& result : report.results) {
+            std::cout << "[" << result.agent << " / " << (result.mode == GameMode::Classic ? "Classic" : "Portal") << "]" << std::endl;
+            std::cout << "  Score: " << result.score.mean << " +/- " << result.score.ci95
+                      << " | p10 " << result.score.p10 << " | p50 " << result.score.p50 << " | p90 " << result.score.p90
+                      << " | p99 " << result.score.p99 << " | max " << result.score.max << std::endl;
+            std::cout << "  Survival ticks: " << result.survivalTicks.mean << " +/- " << result.survivalTicks.ci95
+                      << " | p10 " << result.survivalTicks.p10 << " | p50 " << result.survivalTicks.p50
+                      << " | p90 " << result.survivalTicks.p90 << " | p99 " << result.survivalTicks.p99 << std::endl;
+            std::cout << "  Ends: " << result.timeouts << " timeouts";
+            for (std::size_t cause = 1; cause < result.deaths.size(); ++cause) {
+                if (result.deaths[cause] > 0) std::cout << " | " << CAUSE_NAMES[cause] << " " << result.deaths[cause];
+            }
+            std::cout << std::endl;
+            std::cout << "  Games/sec per thread: " << result.gamesPerSecond.mean << " +/- " << result.gamesPerSecond.ci95
+                      << " | Ticks/sec per thread: " << (result.cpuSeconds > 0.0 ? static_cast<double>(result.totalTicks) / result.cpuSeconds : 0.0) << std::endl;
+        }
+        std::cout << "Total: " << report.totalGames << " games in " << report.wallSeconds << " s"
+                  << " | Games/sec: " << (report.wallSeconds > 0.0 ? report.totalGames / report.wallSeconds : 0.0)
+                  << " | Ticks/sec: " << (report.wallSeconds > 0.0 ? static_cast<double>(report.totalTicks) / report.wallSeconds : 0.0) << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+
+        if (!options.csvPath.empty()) {
+            std::ofstream csv(options.csvPath, std::ios::trunc);
+            if (!csv.is_open()) {
+                std::cerr << "Warning: Unable to open CSV file for writing: " << options.csvPath << std::endl;
+                return 1;
+            }
+            csv << "agent,mode,games,score_mean,score_ci95,score_p10,score_p50,score_p90,score_p99,score_max,"
+                   "ticks_mean,ticks_ci95,ticks_p50,ticks_p99,timeouts,games_per_sec,games_per_sec_ci95\n";
+            for (const TournamentResult& result : report.results) {
+                csv << result.agent << "," << (result.mode == GameMode::Classic ? "classic" : "portal") << "," << result.games << ","
+                    << result.score.mean << "," << result.score.ci95 << "," << result.score.p10 << "," << result.score.p50 << ","
+                    << result.score.p90 << "," << result.score.p99 << "," << result.score.max << ","
+                    << result.survivalTicks.mean << "," << result.survivalTicks.ci95 << "," << result.survivalTicks.p50 << ","
+                    << result.survivalTicks.p99 << "," << result.timeouts << ","
+                    << result.gamesPerSecond.mean << "," << result.gamesPerSecond.ci95 << "\n";
+            }
+            std::cout << "Results written to " << options.csvPath << std::endl;
+        }
+        return 0;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (options.arenaSnakes > 0) {
+        return runArena(options);
+    }
+    if (options.tournament) {
+        return runTournament(options);
+    }
+    if (!options.replayPath.empty()) {
+        return runReplay(options);
+    }
+    if (!options.recordPath.empty()) {
+        return runRecord(options);
+    }
+    if (options.snapshot) {
+        return runSnapshot(options);
+    }
+    if (options.batchSize > 0) {
+        return runBatch(options);
+    }
+
+    // Quét seed song song: mỗi khối ván dùng một Simulation riêng, kết quả ghi theo chỉ số ván rồi cộng dồn theo thứ tự
+    JobSystem jobs(options.threads);
+    const std::size_t gameCount = static_cast<std::size_t>(options.games);
+    const std::size_t chunkCount = (gameCount + GAMES_PER_JOB - 1) / GAMES_PER_JOB;
+    std::vector<std::uint64_t> ticks(gameCount, 0);
+    std::vector<int> scores(gameCount, 0);
+    std::vector<AutopilotStats> botStats(chunkCount);
+
+    auto start = std::chrono::steady_clock::now();
+    jobs.parallelFor(chunkCount, [&](std::size_t chunk) {
+        const std::size_t first = chunk * GAMES_PER_JOB;
+        const std::size_t last = std::min(gameCount, (chunk + 1) * GAMES_PER_JOB);
+        Simulation sim(options.boardWidth, options.boardHeight, options.firstSeed + static_cast<std::uint32_t>(first), options.mode, options.obstacles);
+        BenchBot bot(options.bot);
+        for (std::size_t game = first; game < last; ++game) {
+            if (game > first) sim.reset(options.firstSeed + static_cast<std::uint32_t>(game), options.mode); // Ván đầu đã được constructor bắt đầu
+            while (!sim.isGameOver() && sim.getTick() < options.maxTicks) {
+                StepInput input;
+                input.direction = bot.choose(sim);
+                sim.step(input);
+            }
+            ticks[game] = sim.getTick();
+            scores[game] = sim.getScore();
+        }
+        botStats[chunk] = bot.autopilot.getStats();
+    });
+
+    std::uint64_t totalTicks = 0;
+    std::int64_t totalScore = 0;
+    int bestScore = 0;
+    for (std::size_t game = 0; game < gameCount; ++game) {
+        totalTicks += ticks[game];
+        totalScore += scores[game];
+        bestScore = std::max(bestScore, scores[game]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "Games: " << options.games
+              << " | Mode: " << (options.mode == GameMode::Classic ? "Classic" : "Portal")
+              << " | Board: " << options.boardWidth << "x" << options.boardHeight
+              << " | Obstacles: " << options.obstacles
+              << " | Threads: " << jobs.getThreadCount()
+              << " | Seeds: " << options.firstSeed << ".." << (options.firstSeed + options.games - 1) << std::endl;
+    std::cout << "Ticks: " << totalTicks << " in " << seconds << " s"
+              << " | Ticks/sec: " << (seconds > 0.0 ? static_cast<double>(totalTicks) / seconds : 0.0)
+              << " | Games/sec: " << (seconds > 0.0 ? options.games / seconds : 0.0) << std::endl;
+    std::cout << "Mean score: " << static_cast<double>(totalScore) / options.games
+              << " | Best score: " << bestScore << std::endl;
+    if (options.bot == BotKind::AStar) {
+        AutopilotStats total;
+        for (const AutopilotStats& stats : botStats) {
+            total.decisions += stats.decisions;
+            total.fullSearches += stats.fullSearches;
+            total.repairs += stats.repairs;
+            total.reusedTicks += stats.reusedTicks;
+            total.fallbacks += stats.fallbacks;
+            total.nodesExpanded += stats.nodesExpanded;
+        }
+        std::cout << "Autopilot: " << total.decisions << " decisions | Full searches: " << total.fullSearches
+                  << " | Repairs: " << total.repairs << " | Reused: " << total.reusedTicks
+                  << " | Fallbacks: " << total.fallbacks
+                  << " | Nodes/decision: " << (total.decisions > 0 ? static_cast<double>(total.nodesExpanded) / total.decisions : 0.0) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,443 @@
+#include "Simulation.hpp"
+#include "CoreConfig.hpp"
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+namespace SnakeGame {
+
+    namespace {
+        std::atomic<std::uint64_t> nextObstacleLayoutRevision{1};
+    }
+
+    Simulation::Simulation(int w, int h, std::uint32_t initialSeed, GameMode initialMode, int obstacleCount)
+            : boardWidth(std::max(0, w)),
+              boardHeight(std::max(0, h)),
+              grid(boardWidth, boardHeight),
+              snake(calculateStartPosition().x, calculateStartPosition().y, Config::DEFAULT_SNAKE_LENGTH, grid.getWidth(), grid.getHeight()),
+              food(initialSeed),
+              mode(initialMode),
+              seed(initialSeed),
+              moveInterval(Config::INITIAL_SNAKE_SPEED_DELAY_MS),
+              nextObstacleScoreThreshold(Config::OBSTACLE_ADD_SCORE_INTERVAL),
+              initialObstacleCount(std::max(0, obstacleCount)),
+              rng(initialSeed)
+    {
+        reset(initialSeed, initialMode);
+    }
+
+    void Simulation::reset(std::uint32_t newSeed, GameMode newMode) {
+        seed = newSeed;
+        mode = newMode;
+        rng.seed(seed);
+        food.reseed(static_cast<std::uint32_t>(rng()));
+
+        grid.clear();
+        Point startPos = calculateStartPosition();
+        snake.reset(startPos.x, startPos.y, Config::DEFAULT_SNAKE_LENGTH);
+        snake.occupy(grid);
+        tick = 0;
+        score = 0;
+        moveInterval = Config::INITIAL_SNAKE_SPEED_DELAY_MS;
+        gameOver = false;
+        nextObstacleScoreThreshold = Config::OBSTACLE_ADD_SCORE_INTERVAL;
+        boosting = false;
+        boostCostTimerMs = 0;
+        boostCostCycles = 0;
+
+        generateObstacles();
+        placeFood();
+    }
+
+    Point Simulation::calculateStartPosition() const {
+        return {boardWidth / 2, boardHeight / 2};
+    }
+
+    void Simulation::queueDirection(Direction direction, std::uint64_t inputStamp) {
+        if (gameOver) return;
+        snake.queueDirectionChange(direction, inputStamp);
+    }
+
+    void Simulation::setBoostRequested(bool held) {
+        bool canBoost = held && !gameOver && score > 0 && snake.getBody().size() > Config::MIN_BOOST_LENGTH;
+        if (canBoost) {
+            if (!boosting) {
+                boosting = true;
+                boostCostTimerMs = 0;
+                boostCostCycles = 0;
+            }
+        } else if (boosting) {
+            stopBoost();
+        }
+    }
+
+    int Simulation::stepIntervalMs() const {
+        return boosting ? Config::BOOST_MOVE_INTERVAL_MS : moveInterval;
+    }
+
+    void Simulation::stopBoost() {
+        boosting = false;
+        boostCostTimerMs = 0;
+        boostCostCycles = 0;
+    }
+
+    void Simulation::endGame(StepResult& result, CollisionCause cause) {
+        gameOver = true;
+        result.gameOver = true;
+        result.cause = cause;
+        stopBoost();
+    }
+
+    StepResult Simulation::step(const StepInput& input) {
+        StepResult result;
+        if (gameOver) {
+            result.gameOver = true;
+            return result;
+        }
+
+        if (input.direction) {
+            snake.queueDirectionChange(*input.direction);
+        }
+        setBoostRequested(input.boost);
+        const int elapsedMs = stepIntervalMs();
+
+        ++tick;
+        advanceSnake(result);
+        if (gameOver) return result;
+
+        updateObstacles();
+
+        if (boosting) {
+            applyBoostCost(elapsedMs, result);
+        }
+        return result;
+    }
+
+    void Simulation::saveState(std::vector<std::uint8_t>& out) const {
+        out.clear(); // Giữ dung lượng: chụp lại vào cùng bộ đệm không cấp phát
+        ByteWriter writer(out);
+        writer.raw(boardWidth);
+        writer.raw(boardHeight);
+        writer.raw(mode);
+        writer.raw(seed);
+        writer.raw(tick);
+        writer.raw(score);
+        writer.raw(moveInterval);
+        writer.raw(gameOver);
+        writer.raw(nextObstacleScoreThreshold);
+        writer.raw(initialObstacleCount);
+        writer.raw(boosting);
+        writer.raw(boostCostTimerMs);
+        writer.raw(boostCostCycles);
+        writer.raw(rng);
+        grid.saveState(writer);
+        snake.saveState(writer);
+        food.saveState(writer);
+        obstacles.saveState(writer);
+    }
+
+    bool Simulation::checkState(const std::uint8_t* data, std::size_t size, int width, int height) {
+        static_assert(sizeof(bool) == 1); // Cờ bool được ghi thô một byte và kiểm tra như uint8_t
+        ByteReader reader(data, size);
+        const auto savedWidth = reader.raw<int>();
+        const auto savedHeight = reader.raw<int>();
+        const auto savedMode = reader.raw<std::underlying_type_t<GameMode>>();
+        reader.raw<std::uint32_t>(); // seed
+        reader.raw<std::uint64_t>(); // tick
+        const auto savedScore = reader.raw<int>();
+        const auto savedMoveInterval = reader.raw<int>();
+        const auto savedGameOver = reader.raw<std::uint8_t>();
+        reader.raw<int>(); // nextObstacleScoreThreshold
+        const auto savedObstacleCount = reader.raw<int>();
+        const auto savedBoosting = reader.raw<std::uint8_t>();
+        reader.raw<int>(); // boostCostTimerMs
+        reader.raw<int>(); // boostCostCycles
+        reader.raw<Rng>();
+        const int cellCount = width * height;
+        if (!reader.ok() || savedWidth != width || savedHeight != height ||
+            savedMode < 0 || savedMode > static_cast<std::underlying_type_t<GameMode>>(GameMode::PortalWalls) ||
+            savedScore < 0 || savedMoveInterval <= 0 || savedGameOver > 1 || savedBoosting > 1 ||
+            savedObstacleCount < 0 || savedObstacleCount > cellCount) {
+            return false;
+        }
+        return OccupancyGrid::checkState(reader, width, height) && Snake::checkState(reader, cellCount) &&
+               Food::checkState(reader, width, height) && ObstacleField::checkState(reader, width, height);
+    }
+
+    bool Simulation::loadState(const std::uint8_t* data, std::size_t size) {
+        ByteReader reader(data, size);
+        const auto width = reader.raw<int>();
+        const auto height = reader.raw<int>();
+        if (!reader.ok() || width != boardWidth || height != boardHeight) {
+            std::cerr << "Warning: Snapshot board size " << width << "x" << height << " does not match " << boardWidth << "x" << boardHeight << "." << std::endl;
+            return false;
+        }
+        // Kiểm tra toàn bộ ảnh chụp trước khi ghi bất cứ thứ gì: khi trả về false, mô phỏng giữ nguyên trạng thái cũ
+        if (!checkState(data, size, boardWidth, boardHeight)) {
+            std::cerr << "Warning: Corrupt simulation snapshot." << std::endl;
+            return false;
+        }
+        mode = reader.raw<GameMode>();
+        seed = reader.raw<std::uint32_t>();
+        tick = reader.raw<std::uint64_t>();
+        score = reader.raw<int>();
+        moveInterval = reader.raw<int>();
+        gameOver = reader.raw<std::uint8_t>() != 0;
+        nextObstacleScoreThreshold = reader.raw<int>();
+        initialObstacleCount = reader.raw<int>();
+        boosting = reader.raw<std::uint8_t>() != 0;
+        boostCostTimerMs = reader.raw<int>();
+        boostCostCycles = reader.raw<int>();
+        rng = reader.raw<Rng>();
+        const int cellCount = grid.getCellCount();
+        grid.loadState(reader);
+        snake.loadState(reader, cellCount);
+        food.loadState(reader);
+        obstacles.loadState(reader, static_cast<std::size_t>(cellCount));
+        touchObstacleLayout(); // Vật cản được thay toàn bộ
+        return true;
+    }
+
+    void Simulation::copyStateFrom(const Simulation& other) {
+        boardWidth = other.boardWidth;
+        boardHeight = other.boardHeight;
+        grid.copyStateFrom(other.grid);
+        snake.copyStateFrom(other.snake);
+        food = other.food;
+        obstacles = other.obstacles;
+        mode = other.mode;
+        seed = other.seed;
+        tick = other.tick;
+        score = other.score;
+        moveInterval = other.moveInterval;
+        gameOver = other.gameOver;
+        nextObstacleScoreThreshold = other.nextObstacleScoreThreshold;
+        initialObstacleCount = other.initialObstacleCount;
+        obstacleLayoutRevision = other.obstacleLayoutRevision;
+        boosting = other.boosting;
+        boostCostTimerMs = other.boostCostTimerMs;
+        boostCostCycles = other.boostCostCycles;
+        rng = other.rng;
+    }
+
+    std::uint64_t Simulation::stateHash() const {
+        const Point head = snake.getHeadPosition();
+        std::uint64_t hash = grid.getHash();
+        if (grid.contains(head.x, head.y)) hash ^= OccupancyGrid::zobristKey(grid.indexOf(head), CellTag::Food) * 0xD6E8FEB86659FD93ull;
+        const std::uint64_t flags = static_cast<std::uint64_t>(snake.getCurrentDirection()) |
+                                    (snake.isGrowing() ? 4u : 0u) | (boosting ? 8u : 0u) | (gameOver ? 16u : 0u) |
+                                    (static_cast<std::uint64_t>(static_cast<std::uint32_t>(score)) << 5);
+        return hash ^ OccupancyGrid::zobristKey(static_cast<int>(flags & 0x7FFFFFFF), CellTag::Snake) * 0xA0761D6478BD642Full;
+    }
+
+    void Simulation::reseedChance(std::uint64_t chanceSeed) {
+        rng.seed(chanceSeed);
+        food.reseed(static_cast<std::uint32_t>(chanceSeed ^ (chanceSeed >> 32)));
+    }
+
+    Point Simulation::wrapPosition(Point pos) const {
+        if (mode != GameMode::PortalWalls) return pos;
+        if (pos.x < 0) pos.x = boardWidth - 1;
+        else if (pos.x >= boardWidth) pos.x = 0;
+        if (pos.y < 0) pos.y = boardHeight - 1;
+        else if (pos.y >= boardHeight) pos.y = 0;
+        return pos;
+    }
+
+    CollisionCause Simulation::checkMove(Point nextHead) const {
+        if (mode == GameMode::Classic) {
+            if (nextHead.x < 0 || nextHead.x >= boardWidth || nextHead.y < 0 || nextHead.y >= boardHeight) {
+                return CollisionCause::Wall;
+            }
+        } else {
+            nextHead = wrapPosition(nextHead);
+        }
+        if (!grid.contains(nextHead.x, nextHead.y)) return CollisionCause::Wall;
+        if (checkObstacleCollision(nextHead)) return CollisionCause::Obstacle;
+        if (snake.checkSelfCollisionWithNext(nextHead, grid)) return CollisionCause::Self;
+        return CollisionCause::None;
+    }
+
+    void Simulation::advanceSnake(StepResult& result) {
+        Point nextHeadPos = snake.calculateNextHeadPosition();
+
+        CollisionCause cause = checkMove(nextHeadPos);
+        if (cause != CollisionCause::None) {
+            endGame(result, cause);
+            return;
+        }
+
+        snake.move(wrapPosition(nextHeadPos), grid);
+
+        if (snake.checkFoodCollision(food.getPosition())) {
+            result.ateFood = true;
+            score++;
+            snake.grow();
+            placeFood();
+            increaseSpeed();
+
+            if (score >= nextObstacleScoreThreshold) {
+                result.obstacleAdded = addSingleObstacle();
+                nextObstacleScoreThreshold += Config::OBSTACLE_ADD_SCORE_INTERVAL;
+            }
+        }
+    }
+
+    void Simulation::applyBoostCost(int elapsedMs, StepResult& result) {
+        boostCostTimerMs += elapsedMs;
+
+        while (boosting && boostCostTimerMs >= Config::BOOST_COST_INTERVAL_MS) {
+            boostCostTimerMs -= Config::BOOST_COST_INTERVAL_MS;
+
+            if (score > 0 && snake.getBody().size() > Config::MIN_BOOST_LENGTH) {
+                score -= Config::BOOST_SCORE_COST;
+                if (score < 0) score = 0;
+
+                boostCostCycles++;
+                if (boostCostCycles >= Config::BOOST_LENGTH_COST_INTERVALS) {
+                    boostCostCycles = 0;
+                    snake.shrink(grid);
+                    result.shrunkByBoost = true;
+                }
+            }
+            if (score <= 0 || snake.getBody().size() <= Config::MIN_BOOST_LENGTH) {
+                stopBoost();
+            }
+        }
+    }
+
+    void Simulation::increaseSpeed() {
+        moveInterval = std::max(Config::MIN_MOVE_INTERVAL_MS, moveInterval - Config::SPEED_INCREMENT_MS);
+    }
+
+    void Simulation::randomizeObstacleMovement(Obstacle& obs, int rangeMax) {
+        float currentMovingRatio = std::min(Config::MAX_MOVING_OBSTACLE_RATIO,
+                                            Config::BASE_MOVING_OBSTACLE_RATIO + score * Config::MOVING_RATIO_SCORE_FACTOR);
+        int currentSpeedFactor = std::max(Config::MIN_OBSTACLE_SPEED_FACTOR,
+                                          Config::BASE_OBSTACLE_SPEED_FACTOR - score / Config::OBSTACLE_SPEED_SCORE_DIVISOR);
+
+        std::uniform_real_distribution<float> moveTypeDist(0.0f, 1.0f);
+        std::uniform_int_distribution<int> rangeDist(3, rangeMax);
+        std::uniform_int_distribution<int> dirDist(0, 1);
+
+        if (moveTypeDist(rng) < currentMovingRatio) {
+            obs.movementType = (dirDist(rng) == 0) ? ObstacleMovement::Horizontal : ObstacleMovement::Vertical;
+            obs.moveRange = rangeDist(rng);
+            obs.currentMoveStep = 0;
+            if (obs.movementType == ObstacleMovement::Horizontal) {
+                obs.moveDirection = (dirDist(rng) == 0) ? Direction::LEFT : Direction::RIGHT;
+            } else {
+                obs.moveDirection = (dirDist(rng) == 0) ? Direction::UP : Direction::DOWN;
+            }
+            obs.moveSpeedFactor = currentSpeedFactor;
+            obs.moveDelayCounter = static_cast<int>(rng() % obs.moveSpeedFactor);
+        } else {
+            obs.movementType = ObstacleMovement::Static;
+        }
+    }
+
+    void Simulation::generateObstacles() {
+        for (std::size_t i = 0; i < obstacles.size(); ++i) { grid.reset(obstacles.positionAt(i), CellTag::Obstacle); }
+        obstacles.clear();
+        touchObstacleLayout();
+        if (initialObstacleCount <= 0) return;
+        if (grid.getCellCount() <= 0) return;
+
+        // Ô hợp lệ: ô trống nằm ngoài vùng an toàn quanh đầu rắn.
+        // Rút trực tiếp từ tập ô trống (bỏ qua ô trong vùng an toàn) thay vì liệt kê + xáo trộn toàn bộ bàn chơi,
+        // nên chi phí không tăng theo diện tích trên bàn chơi lớn.
+        const Point startHead = snake.getHeadPosition();
+        auto inSafeZone = [&](int x, int y) {
+            return startHead.x != -1 &&
+                   std::abs(x - startHead.x) <= Config::OBSTACLE_SAFE_RADIUS &&
+                   std::abs(y - startHead.y) <= Config::OBSTACLE_SAFE_RADIUS;
+        };
+        int freeInSafeZone = 0;
+        for (int y = startHead.y - Config::OBSTACLE_SAFE_RADIUS; y <= startHead.y + Config::OBSTACLE_SAFE_RADIUS; ++y) {
+            for (int x = startHead.x - Config::OBSTACLE_SAFE_RADIUS; x <= startHead.x + Config::OBSTACLE_SAFE_RADIUS; ++x) {
+                if (startHead.x != -1 && grid.contains(x, y) && !grid.isOccupied(grid.indexOf(x, y))) ++freeInSafeZone;
+            }
+        }
+        int count = std::min(grid.getFreeCellCount() - freeInSafeZone, initialObstacleCount);
+        if (count < initialObstacleCount) {
+            std::cerr << "Warning: Could only place " << count << "/" << initialObstacleCount << " initial obstacles due to space constraints." << std::endl;
+        }
+
+        obstacles.reserve(count);
+        const int gridWidth = grid.getWidth();
+        while (static_cast<int>(obstacles.size()) < count) {
+            const int cell = grid.getFreeCells().sample(rng);
+            const Point pos = {cell % gridWidth, cell / gridWidth};
+            if (inSafeZone(pos.x, pos.y)) continue;
+            Obstacle obs;
+            obs.position = pos;
+            randomizeObstacleMovement(obs, 8);
+            pushObstacle(obs);
+        }
+    }
+
+    void Simulation::pushObstacle(const Obstacle& obs) {
+        obstacles.push(obs);
+        grid.set(obs.position, CellTag::Obstacle);
+    }
+
+    bool Simulation::addSingleObstacle() {
+        const int gridArea = grid.getCellCount();
+        const int occupiedSpots = gridArea - grid.getFreeCellCount();
+        if (occupiedSpots >= gridArea * 0.9) { return false; }
+
+        const int cell = grid.getFreeCells().sample(rng);
+        if (cell < 0) { return false; }
+        Point potentialPos = {cell % grid.getWidth(), cell / grid.getWidth()};
+
+        Obstacle newObs;
+        newObs.position = potentialPos;
+        randomizeObstacleMovement(newObs, 6);
+        pushObstacle(newObs);
+        touchObstacleLayout();
+        return true;
+    }
+
+    void Simulation::touchObstacleLayout() {
+        obstacleLayoutRevision = nextObstacleLayoutRevision.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool Simulation::checkObstacleCollision(const Point& pos) const {
+        return grid.test(pos, CellTag::Obstacle);
+    }
+
+    void Simulation::placeFood() {
+        Point oldPos = food.getPosition();
+        if (oldPos.x >= 0) grid.reset(oldPos, CellTag::Food);
+        food.generate(grid);
+        Point newPos = food.getPosition();
+        if (newPos.x >= 0) grid.set(newPos, CellTag::Food);
+        else { std::cerr << "Error: Failed to place food on the grid! The grid might be full." << std::endl; }
+    }
+
+    void Simulation::updateObstacles() {
+        if (mode != GameMode::PortalWalls) return;
+        obstacles.advanceTimers(boardWidth, boardHeight);
+
+        // Giải quyết theo thứ tự chỉ số: vật cản đi trước giải phóng/chiếm ô trước vật cản đi sau
+        for (std::size_t i = 0; i < obstacles.size(); ++i) {
+            if (!obstacles.isDue(i)) continue;
+
+            const Point target = obstacles.targetAt(i);
+            if (grid.test(target, CellTag::Obstacle) || grid.test(target, CellTag::Snake)) {
+                obstacles.bounce(i);
+                continue;
+            }
+            grid.reset(obstacles.positionAt(i), CellTag::Obstacle);
+            grid.set(target, CellTag::Obstacle);
+            obstacles.advance(i);
+            // Vật cản đè lên mồi: đặt lại mồi sau khi vật cản đã chiếm ô để mồi mới không rơi vào đúng ô này
+            if (grid.test(target, CellTag::Food)) {
+                placeFood();
+            }
+        }
+    }
+
+}
@@ -0,0 +1,261 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include "Snake.hpp"
+#include "Food.hpp"
+#include "OccupancyGrid.hpp"
+#include "ObstacleField.hpp"
+#include "CoreConfig.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <optional>
+#include <cstdint>
+
+namespace SnakeGame {
+
+    /**
+     *  GameMode
+     *    Xác định các chế độ chơi khác nhau (ảnh hưởng đến va chạm tường).
+     */
+    enum class GameMode { Classic, PortalWalls };
+
+    /**
+     *    CollisionCause
+     *    Nguyên nhân kết thúc ván chơi trong một bước mô phỏng.
+     */
+    enum class CollisionCause {
+        None,
+        Wall,             // Đâm tường (Classic)
+        Obstacle,         // Đầu rắn đâm vào vật cản
+        Self,             // Đầu rắn đâm vào thân
+        ObstacleIntoHead, // Vật cản di chuyển vào đầu rắn
+        ObstacleIntoBody, // Vật cản di chuyển vào thân rắn
+        OtherSnake,       // Đầu rắn đâm vào thân rắn khác (Arena)
+        HeadOn            // Hai đầu rắn cùng đi vào một ô (Arena)
+    };
+
+    /**
+     *    StepInput
+     *    Đầu vào cho một bước mô phỏng: lệnh đổi hướng (tùy chọn) và trạng thái giữ phím boost.
+     */
+    struct StepInput {
+        std::optional<Direction> direction; // Hướng mới được đưa vào bộ đệm input của rắn trước khi di chuyển
+        bool boost = false;                 // true nếu người chơi (hoặc bot) đang giữ boost
+    };
+
+    /**
+     *    StepResult
+     *    Các sự kiện xảy ra trong một bước mô phỏng, dùng để phát âm thanh / cập nhật UI ở tầng Game.
+     */
+    struct StepResult {
+        bool ateFood = false;        // Rắn đã ăn mồi trong bước này
+        bool obstacleAdded = false;  // Một vật cản mới được thêm do đạt ngưỡng điểm
+        bool shrunkByBoost = false;  // Rắn bị giảm chiều dài do chi phí boost
+        bool gameOver = false;       // Ván chơi kết thúc
+        CollisionCause cause = CollisionCause::None; // Nguyên nhân kết thúc (nếu gameOver)
+    };
+
+    /**
+     *    Simulation
+     *    Lõi luật chơi của Vorax Serpens: rắn, mồi, vật cản, điểm, tốc độ và boost.
+     *        Không phụ thuộc SDL/âm thanh/đồ họa. Mỗi lần gọi step() là một bước di chuyển của rắn,
+     *        nên có thể chạy với tốc độ tối đa của CPU (headless) hoặc được điều nhịp bởi Game::runFrame.
+     *        Mọi vị trí đều tính theo ô (cột, hàng); việc đổi sang pixel chỉ diễn ra ở tầng vẽ.
+     */
+    class Simulation {
+    public:
+        /**
+         *    Khởi tạo mô phỏng và bắt đầu một ván mới.
+         *    boardWidth Số ô theo chiều ngang của bàn chơi.
+         *    boardHeight Số ô theo chiều dọc của bàn chơi.
+         *    seed Hạt giống ngẫu nhiên cho ván chơi (vật cản và mồi).
+         *    mode Chế độ chơi.
+         *    obstacleCount Số vật cản ban đầu (như setInitialObstacleCount), để ván đầu tiên chỉ sinh vật cản một lần.
+         */
+        Simulation(int boardWidth, int boardHeight, std::uint32_t seed, GameMode mode = GameMode::Classic,
+                   int obstacleCount = Config::OBSTACLE_COUNT);
+
+        /**
+         *    Bắt đầu một ván mới với seed và chế độ chơi cho trước.
+         *        Reset rắn, điểm, tốc độ, vật cản, thức ăn, trạng thái boost.
+         */
+        void reset(std::uint32_t seed, GameMode mode);
+
+        /**
+         *    Thực hiện một bước mô phỏng: áp dụng input, di chuyển rắn, kiểm tra va chạm/ăn mồi,
+         *        cập nhật vật cản và áp dụng chi phí boost theo thời gian của bước.
+         *    input Đầu vào cho bước này.
+         *    StepResult Các sự kiện đã xảy ra. Không làm gì nếu ván đã kết thúc.
+         */
+        StepResult step(const StepInput& input);
+
+        /**
+         *    Đưa một lệnh đổi hướng vào bộ đệm input của rắn ngay lập tức (giữa hai bước).
+         *    inputStamp Nhãn thời gian của lần nhấn phím (0: không theo dõi), xem Snake::getAppliedInputStamp.
+         */
+        void queueDirection(Direction direction, std::uint64_t inputStamp = 0);
+
+        /**
+         *    Cập nhật trạng thái boost theo việc giữ phím: bắt đầu nếu đủ điều kiện, dừng nếu nhả hoặc không đủ điều kiện.
+         *        step() tự gọi hàm này với StepInput::boost; Game gọi thêm mỗi khung hình để stepIntervalMs() phản ánh đúng.
+         */
+        void setBoostRequested(bool held);
+
+        /**
+         *    Khoảng thời gian (ms) của bước tiếp theo: BOOST_MOVE_INTERVAL_MS khi đang boost, moveInterval nếu không.
+         */
+        [[nodiscard]] int stepIntervalMs() const;
+
+        /**
+         *    Kiểm tra xem đầu rắn di chuyển tới vị trí nextHead (chưa wrap) có gây kết thúc ván không.
+         *        Dùng chung cho luật di chuyển và cho bot/driver headless.
+         *    nextHead Ô tiềm năng (chưa áp dụng wrap PortalWalls).
+         *    CollisionCause::None nếu an toàn.
+         */
+        [[nodiscard]] CollisionCause checkMove(Point nextHead) const;
+
+        /**
+         *    Đặt số vật cản ban đầu cho các ván sau (mặc định Config::OBSTACLE_COUNT), áp dụng từ lần reset() tiếp theo.
+         *        Dùng cho driver headless để thử bàn chơi lớn với hàng nghìn vật cản.
+         */
+        void setInitialObstacleCount(int count) { initialObstacleCount = std::max(0, count); }
+        [[nodiscard]] int getInitialObstacleCount() const { return initialObstacleCount; }
+
+        /**    Bật/tắt nhật ký thay đổi của lưới chiếm chỗ (dùng cho minimap cập nhật tăng dần). */
+        void setGridChangeTracking(bool enabled) { grid.setChangeTracking(enabled); }
+
+        /**    Xóa nhật ký thay đổi của lưới sau khi tầng hiển thị đã xử lý. */
+        void clearGridChanges() { grid.clearChanges(); }
+
+        /**
+         *    Ghi toàn bộ trạng thái ván chơi (lưới, rắn, mồi, vật cản, điểm, tốc độ, boost, bộ sinh số ngẫu nhiên)
+         *        thành một khối byte phẳng, ghi đè out (giữ dung lượng của out để chụp lặp lại không cấp phát).
+         *        Mỗi thành phần là giá trị thô hoặc mảng được chép nguyên khối, nên chụp/khôi phục chỉ là vài lần memcpy.
+         *        Được nhúng vào file replay làm keyframe; ảnh chụp đọc từ file phải qua checkState trước khi dùng.
+         */
+        void saveState(std::vector<std::uint8_t>& out) const;
+
+        /**
+         *    Khôi phục trạng thái từ ảnh chụp do saveState ghi (cùng kích thước bàn chơi), không đi qua reset().
+         *        Sau khi khôi phục, step() cho kết quả giống hệt ván gốc. Chế độ nhật ký thay đổi lưới được giữ nguyên.
+         *        Ảnh chụp được kiểm tra toàn bộ bằng checkState trước khi ghi đè bất cứ trạng thái nào.
+         *    false (kèm cảnh báo) nếu dữ liệu hỏng hoặc khác kích thước bàn chơi; khi đó mô phỏng giữ nguyên trạng thái cũ.
+         */
+        bool loadState(const std::uint8_t* data, std::size_t size);
+
+        /**
+         *    Kiểm tra một ảnh chụp cho bàn chơi width x height mà không nạp: kích thước khớp, mọi enum và cờ nằm trong miền giá trị,
+         *        mọi chỉ số ô (tập ô trống, thân rắn, vật cản, mồi) nằm trong bàn chơi - để step() sau khi nạp không truy cập ngoài mảng.
+         *        Không kiểm tra tính nhất quán giữa các thành phần (ví dụ lưới khớp thân rắn).
+         */
+        [[nodiscard]] static bool checkState(const std::uint8_t* data, std::size_t size, int width, int height);
+
+        /**
+         *    Mã băm Zobrist của trạng thái: mã băm tăng dần của lưới (rắn, vật cản, mồi) trộn với ô đầu, hướng,
+         *        cờ lớn, điểm và boost của rắn (O(1), không quét bàn chơi). Bộ đệm input và bộ sinh số không được tính.
+         */
+        [[nodiscard]] std::uint64_t stateHash() const;
+
+        /**
+         *    Gieo lại bộ sinh số của mồi và vật cản. Dùng trên bản sao của bot tìm kiếm để lấy mẫu các khả năng
+         *        (vị trí mồi mới, hướng vật cản) thay vì đọc trước chuỗi số thật của ván.
+         */
+        void reseedChance(std::uint64_t chanceSeed);
+
+        /**
+         *    Chép toàn bộ trạng thái ván chơi của other vào mô phỏng này (như phép gán) nhưng không cấp phát lại:
+         *        chỉ chép phần thân rắn đang dùng, giữ chế độ nhật ký thay đổi lưới của mô phỏng này.
+         *        Đây là thao tác "clone" của bot tìm kiếm - với bàn chơi thường chỉ vài chục KB memcpy.
+         */
+        void copyStateFrom(const Simulation& other);
+
+        /**    Áp dụng wrap-around của chế độ PortalWalls lên một vị trí (không làm gì ở Classic). */
+        [[nodiscard]] Point wrapPosition(Point pos) const;
+
+        [[nodiscard]] const Snake& getSnake() const { return snake; }
+        [[nodiscard]] Point getFoodPosition() const { return food.getPosition(); }
+        [[nodiscard]] const ObstacleField& getObstacles() const { return obstacles; }
+        /**
+         *    Định danh (duy nhất trong tiến trình) của bố cục vật cản hiện tại: đổi khi vật cản được tạo lại (reset),
+         *        thêm bởi addSingleObstacle hoặc nạp từ ảnh chụp; bản sao giữ định danh của bản gốc.
+         *        Không thuộc trạng thái ván chơi (không vào ảnh chụp/stateHash); tầng vẽ dùng để biết khi nào nướng lại lớp tĩnh.
+         */
+        [[nodiscard]] std::uint64_t getObstacleLayoutRevision() const { return obstacleLayoutRevision; }
+        [[nodiscard]] const OccupancyGrid& getGrid() const { return grid; }
+        [[nodiscard]] int getScore() const { return score; }
+        [[nodiscard]] int getMoveInterval() const { return moveInterval; }
+        [[nodiscard]] bool isBoosting() const { return boosting; }
+        [[nodiscard]] bool isGameOver() const { return gameOver; }
+        [[nodiscard]] GameMode getMode() const { return mode; }
+        [[nodiscard]] std::uint64_t getTick() const { return tick; }
+        [[nodiscard]] std::uint32_t getSeed() const { return seed; }
+        [[nodiscard]] int getBoardWidth() const { return boardWidth; }
+        [[nodiscard]] int getBoardHeight() const { return boardHeight; }
+
+    private:
+        // Kích thước bàn chơi (số ô)
+        int boardWidth;
+        int boardHeight;
+
+        // Đối tượng game chính
+        OccupancyGrid grid;              // Lưới chiếm chỗ (rắn/vật cản/mồi), cập nhật tăng dần
+        Snake snake;
+        Food food;
+        ObstacleField obstacles;         // Các vật cản (SoA)
+
+        // Trạng thái ván chơi
+        GameMode mode;
+        std::uint32_t seed;
+        std::uint64_t tick = 0;         // Số bước đã mô phỏng trong ván hiện tại
+        int score = 0;
+        int moveInterval;               // Khoảng thời gian giữa các bước (ms) - tốc độ nền
+        bool gameOver = false;
+        int nextObstacleScoreThreshold; // Ngưỡng điểm để thêm vật cản mới
+        int initialObstacleCount = Config::OBSTACLE_COUNT; // Số vật cản tạo khi bắt đầu ván
+        std::uint64_t obstacleLayoutRevision = 0; // Xem getObstacleLayoutRevision()
+
+        // Trạng thái Boost
+        bool boosting = false;          // Cờ cho biết có đang boost không
+        int boostCostTimerMs = 0;       // Thời gian mô phỏng (ms) tích lũy để áp dụng chi phí boost
+        int boostCostCycles = 0;        // Đếm số lần trừ điểm để biết khi nào trừ chiều dài
+
+        Rng rng;                        // Bộ sinh số ngẫu nhiên cho vật cản (PCG32, 16 byte)
+
+        /**    Tính toán vị trí xuất phát ban đầu cho rắn (giữa bàn chơi). */
+        [[nodiscard]] Point calculateStartPosition() const;
+        /**    Tăng tốc độ di chuyển nền của rắn (giảm moveInterval) sau khi ăn mồi. */
+        void increaseSpeed();
+        /**    Đặt thức ăn vào một vị trí mới hợp lệ trên lưới, tránh rắn và vật cản. */
+        void placeFood();
+        /**    Tạo các chướng ngại vật ban đầu (tĩnh và động) khi bắt đầu ván. */
+        void generateObstacles();
+        /**    Cấp một định danh bố cục vật cản mới (bộ đếm nguyên tử dùng chung mọi Simulation). */
+        void touchObstacleLayout();
+        /**    Gán kiểu di chuyển ngẫu nhiên (theo độ khó hiện tại) cho một vật cản. rangeMax: số ô di chuyển tối đa. */
+        void randomizeObstacleMovement(Obstacle& obs, int rangeMax);
+        /**    Kiểm tra va chạm giữa một điểm và vị trí hiện tại của các chướng ngại vật (O(1) qua lưới). */
+        [[nodiscard]] bool checkObstacleCollision(const Point& pos) const;
+        /**    Thêm vật cản vào danh sách và đánh dấu lên lưới. */
+        void pushObstacle(const Obstacle& obs);
+        /**    Thêm một chướng ngại vật mới vào vị trí ngẫu nhiên hợp lệ khi đạt ngưỡng điểm. */
+        bool addSingleObstacle();
+        /**
+         *    Cập nhật vật cản động: kernel SoA tính lượt/ô đích, sau đó giải quyết xung đột theo thứ tự qua lưới.
+         *        Vật cản có ô đích là rắn thì dội lại, nên vật cản không bao giờ đè lên rắn (không cần quét lại sau bước).
+         */
+        void updateObstacles();
+        /**    Di chuyển rắn một bước, xử lý va chạm và ăn mồi (luật cũ của Game::update). */
+        void advanceSnake(StepResult& result);
+        /**    Trừ điểm/chiều dài theo thời gian boost của bước vừa chạy. */
+        void applyBoostCost(int elapsedMs, StepResult& result);
+        /**    Dừng boost và xóa bộ đếm chi phí. */
+        void stopBoost();
+        /**    Đánh dấu kết thúc ván với nguyên nhân cho trước. */
+        void endGame(StepResult& result, CollisionCause cause);
+    };
+
+}
+
+#endif
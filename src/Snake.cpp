@@ -1,20 +1,32 @@
 #include "Snake.hpp"
-#include "Config.hpp"
+#include "CoreConfig.hpp"
 #include <vector>
 #include <algorithm>
 
 namespace SnakeGame {
 
-    Snake::Snake(int startX, int startY, int size, int initialLength)
+    Snake::Snake(int startX, int startY, int initialLength, int width, int height)
             : currentDirection(Direction::RIGHT),
               growing(false),
-              cellSize(size)
+              gridWidth(width)
     {
+        body.init(width, height);
+        inputBuffer.reserve(Config::SNAKE_INPUT_BUFFER_SIZE);
+        inputStamps.reserve(Config::SNAKE_INPUT_BUFFER_SIZE);
+        reset(startX, startY, initialLength);
+    }
+
+    void Snake::reset(int startX, int startY, int initialLength) {
+        currentDirection = Direction::RIGHT;
+        growing = false;
+        inputBuffer.clear();
+        inputStamps.clear();
+        appliedInputStamp = 0;
+        body.clear();
         if (initialLength < 1) initialLength = 1;
-        for (int i = 0; i < initialLength; ++i) {
-            body.push_back({startX - i * cellSize, startY});
+        for (int i = 0; i < initialLength && startX - i >= 0; ++i) {
+            body.push_back(packCell({startX - i, startY}));
         }
-        inputBuffer.reserve(Config::SNAKE_INPUT_BUFFER_SIZE);
     }
 
     bool Snake::isOppositeDirection(Direction dir1, Direction dir2) const {
@@ -25,54 +37,115 @@ namespace SnakeGame {
     }
 
     void Snake::processAndApplyInputBuffer() {
+        appliedInputStamp = 0;
         if (!inputBuffer.empty()) {
             Direction nextDir = inputBuffer.front();
+            const std::uint64_t stamp = inputStamps.front();
             inputBuffer.erase(inputBuffer.begin());
+            inputStamps.erase(inputStamps.begin());
             if (!isOppositeDirection(currentDirection, nextDir)) {
                 currentDirection = nextDir;
+                appliedInputStamp = stamp;
             }
         }
     }
 
-    void Snake::move(const SDL_Point& nextHead) {
+    void Snake::move(const Point& nextHead, OccupancyGrid& grid) {
+        if (body.empty()) return;
+        retractTail(grid);
+        advanceHead(nextHead, grid);
+    }
+
+    void Snake::retractTail(OccupancyGrid& grid) {
         if (body.empty()) return;
-        body.push_front(nextHead);
         if (growing) {
             growing = false;
         } else {
-            if (!body.empty()) {
-                body.pop_back();
-            }
+            grid.reset(static_cast<int>(body.backCell()), CellTag::Snake);
+            body.pop_back();
         }
     }
 
-    void Snake::draw(SDL_Renderer* renderer) const {
-        if (!renderer || body.empty()) return;
-        const SDL_Point& headPos = body.front();
-        SDL_Rect headRect = { headPos.x, headPos.y, cellSize, cellSize }; // Tạo hình chữ nhật cho đầu
-        SDL_SetRenderDrawColor(renderer, Config::SNAKE_HEAD_COLOR.r, Config::SNAKE_HEAD_COLOR.g, Config::SNAKE_HEAD_COLOR.b, Config::SNAKE_HEAD_COLOR.a);
-        // Vẽ hình chữ nhật đặc cho đầu rắn
-        SDL_RenderFillRect(renderer, &headRect);
-        if (body.size() > 1) {
-            std::vector<SDL_Rect> bodyRects;
-            bodyRects.reserve(body.size() - 1);
-            for (size_t i = 1; i < body.size(); ++i) {
-                const SDL_Point& segmentPos = body[i];
-                bodyRects.push_back({ segmentPos.x, segmentPos.y, cellSize, cellSize });
-            }
+    void Snake::advanceHead(const Point& nextHead, OccupancyGrid& grid) {
+        const std::uint32_t headCell = packCell(nextHead);
+        body.push_front(headCell);
+        grid.set(static_cast<int>(headCell), CellTag::Snake);
+    }
+
+    void Snake::release(OccupancyGrid& grid) {
+        for (size_t i = 0; i < body.size(); ++i) {
+            grid.reset(static_cast<int>(body.cellAt(i)), CellTag::Snake);
+        }
+        body.clear();
+        inputBuffer.clear();
+        inputStamps.clear();
+        growing = false;
+    }
 
-            SDL_SetRenderDrawColor(renderer, Config::SNAKE_COLOR.r, Config::SNAKE_COLOR.g, Config::SNAKE_COLOR.b, Config::SNAKE_COLOR.a);
-            SDL_RenderFillRects(renderer, bodyRects.data(), static_cast<int>(bodyRects.size()));
+    void Snake::saveState(ByteWriter& writer) const {
+        writer.raw(currentDirection);
+        writer.raw(growing);
+        writer.array(inputBuffer);
+        writer.varint(body.size());
+        body.forEachSpan([&](const std::uint32_t* cells, std::size_t count) {
+            writer.bytes(cells, count * sizeof(std::uint32_t));
+        });
+    }
+
+    bool Snake::checkState(ByteReader& reader, int cellCount) {
+        const auto validDirection = [](Direction dir) {
+            return static_cast<int>(dir) >= static_cast<int>(Direction::UP) && static_cast<int>(dir) <= static_cast<int>(Direction::RIGHT);
+        };
+        const auto direction = reader.raw<Direction>();
+        const auto growing = reader.raw<std::uint8_t>();
+        const auto inputs = reader.arrayView<Direction>(Config::SNAKE_INPUT_BUFFER_SIZE);
+        const std::uint64_t length = reader.varint();
+        if (!reader.ok() || !validDirection(direction) || growing > 1 || length == 0 || length > static_cast<std::uint64_t>(cellCount)) return false;
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            if (!validDirection(inputs[i])) return false;
         }
+        const auto cells = reader.view<std::uint32_t>(static_cast<std::size_t>(length));
+        if (!reader.ok()) return false;
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            if (cells[i] >= static_cast<std::uint32_t>(cellCount)) return false;
+        }
+        return true;
+    }
+
+    void Snake::loadState(ByteReader& reader, int cellCount) {
+        currentDirection = reader.raw<Direction>();
+        growing = reader.raw<std::uint8_t>() != 0;
+        reader.array(inputBuffer, Config::SNAKE_INPUT_BUFFER_SIZE);
+        inputStamps.assign(inputBuffer.size(), 0); // Nhãn thời gian không được lưu: lệnh nạp lại không được đo
+        appliedInputStamp = 0;
+        const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(reader.varint(), static_cast<std::uint64_t>(cellCount)));
+        reader.bytes(body.overwrite(count), count * sizeof(std::uint32_t));
+    }
+
+    void Snake::copyStateFrom(const Snake& other) {
+        body.copyFrom(other.body);
+        currentDirection = other.currentDirection;
+        inputBuffer = other.inputBuffer;
+        inputStamps = other.inputStamps;
+        appliedInputStamp = other.appliedInputStamp;
+        growing = other.growing;
+        gridWidth = other.gridWidth;
     }
 
-    void Snake::queueDirectionChange(Direction newDirection) {
+    void Snake::occupy(OccupancyGrid& grid) const {
+        for (size_t i = 0; i < body.size(); ++i) {
+            grid.set(static_cast<int>(body.cellAt(i)), CellTag::Snake);
+        }
+    }
+
+    void Snake::queueDirectionChange(Direction newDirection, std::uint64_t inputStamp) {
         Direction lastEffectiveDirection = inputBuffer.empty() ? currentDirection : inputBuffer.back();
         if (inputBuffer.size() < Config::SNAKE_INPUT_BUFFER_SIZE &&
             !isOppositeDirection(lastEffectiveDirection, newDirection) &&
             newDirection != lastEffectiveDirection)
         {
             inputBuffer.push_back(newDirection);
+            inputStamps.push_back(inputStamp);
         }
     }
 
@@ -80,61 +153,56 @@ namespace SnakeGame {
         growing = true;
     }
 
-    void Snake::shrink() {
+    void Snake::shrink(OccupancyGrid& grid) {
         if (body.size() > 1) {
+            grid.reset(static_cast<int>(body.backCell()), CellTag::Snake);
             body.pop_back();
         }
     }
 
-    SDL_Point Snake::calculateNextHeadPosition() {
+    Point Snake::calculateNextHeadPosition() {
         if (body.empty()) return {-1, -1};
         processAndApplyInputBuffer();
-        SDL_Point nextHead = body.front();
+        Point nextHead = body.front();
         switch (currentDirection) {
-            case Direction::UP:    nextHead.y -= cellSize; break;
-            case Direction::DOWN:  nextHead.y += cellSize; break;
-            case Direction::LEFT:  nextHead.x -= cellSize; break;
-            case Direction::RIGHT: nextHead.x += cellSize; break;
+            case Direction::UP:    --nextHead.y; break;
+            case Direction::DOWN:  ++nextHead.y; break;
+            case Direction::LEFT:  --nextHead.x; break;
+            case Direction::RIGHT: ++nextHead.x; break;
         }
         return nextHead;
     }
 
-    bool Snake::checkFoodCollision(const SDL_Point& foodPos) const {
+    bool Snake::checkFoodCollision(const Point& foodPos) const {
         if (body.empty()) return false;
-        return body.front().x == foodPos.x && body.front().y == foodPos.y;
+        return foodPos.x >= 0 && body.frontCell() == packCell(foodPos);
     }
 
     bool Snake::checkSelfCollision() const {
         if (body.size() < 2) return false;
-        const SDL_Point& head = body.front();
+        const std::uint32_t head = body.frontCell();
         for (size_t i = 1; i < body.size(); ++i) {
-            if (head.x == body[i].x && head.y == body[i].y) {
+            if (head == body.cellAt(i)) {
                 return true;
             }
         }
         return false;
     }
 
-    bool Snake::checkSelfCollisionWithNext(const SDL_Point& nextHead) const {
+    bool Snake::checkSelfCollisionWithNext(const Point& nextHead, const OccupancyGrid& grid) const {
         if (body.empty()) return false;
-        size_t checkLimit = body.size();
-        if (!growing && body.size() > 1) {
-            checkLimit = body.size() - 1;
-        }
-        for (size_t i = 0; i < checkLimit; ++i) {
-            if (nextHead.x == body[i].x && nextHead.y == body[i].y) {
-                return true;
-            }
-        }
-        return false;
+        const std::uint32_t nextCell = packCell(nextHead);
+        if (!grid.test(static_cast<int>(nextCell), CellTag::Snake)) return false;
+        // Ô đuôi sẽ được giải phóng trong bước này nếu rắn không đang phát triển
+        return growing || body.size() == 1 || nextCell != body.backCell();
     }
 
-    const std::deque<SDL_Point>& Snake::getBody() const {
+    const SnakeBody& Snake::getBody() const {
         return body;
     }
 
-    SDL_Point Snake::getHeadPosition() const {
-        return body.empty() ? SDL_Point{-1, -1} : body.front();
+    Point Snake::getHeadPosition() const {
+        return body.empty() ? Point{-1, -1} : body.front();
     }
 
     Direction Snake::getCurrentDirection() const {
@@ -1,10 +1,12 @@
 #ifndef SNAKE_HPP
 #define SNAKE_HPP
 
-#include <deque>
+#include <cstdint>
 #include <vector>
-#include <SDL.h>
-#include "Config.hpp"
+#include "CoreConfig.hpp"
+#include "OccupancyGrid.hpp"
+#include "ByteStream.hpp"
+#include "SnakeBody.hpp"
 
 namespace SnakeGame {
 
@@ -16,38 +18,61 @@ namespace SnakeGame {
      *    Quản lý trạng thái và hành vi của con rắn trong trò chơi.
      *        Bao gồm vị trí các đốt, hướng di chuyển, trạng thái phát triển,
      *        bộ đệm input và các phương thức liên quan.
+     *        Thuộc lõi mô phỏng (không phụ thuộc SDL); việc vẽ do Renderer::drawSnake đảm nhiệm.
      */
     class Snake {
     public:
         /**
          *    Khởi tạo đối tượng Snake.
-         *    startX Tọa độ x ban đầu của đầu rắn (góc trên trái).
-         *    startY Tọa độ y ban đầu của đầu rắn (góc trên trái).
-         *    cellSize Kích thước của mỗi ô (đốt rắn).
+         *    startX Cột ban đầu của đầu rắn (tọa độ ô).
+         *    startY Hàng ban đầu của đầu rắn (tọa độ ô).
          *    initialLength Chiều dài ban đầu của rắn (số đốt).
+         *    gridWidth Số ô theo chiều ngang của bàn chơi.
+         *    gridHeight Số ô theo chiều dọc của bàn chơi (dung lượng thân = diện tích bàn chơi).
          */
-        Snake(int startX, int startY, int cellSize, int initialLength);
+        Snake(int startX, int startY, int initialLength, int gridWidth, int gridHeight);
+
+        /**
+         *    Đặt lại rắn về trạng thái ban đầu, tái sử dụng bộ đệm thân (không cấp phát lại).
+         */
+        void reset(int startX, int startY, int initialLength);
 
         /**
          *    Thực hiện di chuyển rắn một bước. Thêm đốt mới vào đầu và
          *        xóa đốt đuôi nếu rắn không đang trong trạng thái phát triển ('growing').
+         *        Cập nhật lưới chiếm chỗ: xóa bit ô đuôi trước rồi mới đặt bit ô đầu (đầu có thể đi vào ô đuôi vừa rời).
          *    nextHead Vị trí đầu rắn tiếp theo đã được tính toán (thường từ calculateNextHeadPosition).
+         *    grid Lưới chiếm chỗ của bàn chơi.
          */
-        void move(const SDL_Point& nextHead);
+        void move(const Point& nextHead, OccupancyGrid& grid);
+
+        /**
+         *    Nửa đầu của move(): bỏ đốt đuôi (và xóa bit của nó) nếu rắn không đang phát triển, ngược lại tắt cờ 'growing'.
+         *        Chế độ Arena gọi hàm này cho mọi rắn trước khi gọi advanceHead() cho bất kỳ rắn nào,
+         *        để một rắn có thể đi vào ô đuôi vừa được rắn khác giải phóng trong cùng bước.
+         */
+        void retractTail(OccupancyGrid& grid);
+
+        /**    Nửa sau của move(): thêm đầu mới và đặt bit của ô đó. */
+        void advanceHead(const Point& nextHead, OccupancyGrid& grid);
+
+        /**    Xóa toàn bộ thân khỏi lưới và làm rỗng thân (rắn bị loại khỏi Arena). */
+        void release(OccupancyGrid& grid);
 
         /**
-         *    Vẽ con rắn lên màn hình bằng cách vẽ các hình chữ nhật cho từng đốt.
-         *    renderer Con trỏ tới SDL_Renderer để vẽ.
+         *    Đánh dấu toàn bộ thân rắn hiện tại lên lưới chiếm chỗ (dùng sau khi tạo rắn mới).
          */
-        void draw(SDL_Renderer* renderer) const;
+        void occupy(OccupancyGrid& grid) const;
 
         /**
          *    Thêm một yêu cầu thay đổi hướng vào bộ đệm đầu vào.
          *        Bộ đệm giúp xử lý các lần nhấn phím nhanh, tránh bỏ lỡ input.
          *        Hướng mới chỉ được thêm nếu hợp lệ (không đầy buffer, không ngược hướng hiệu quả cuối cùng).
          *    newDirection Hướng mới yêu cầu.
+         *    inputStamp Nhãn thời gian không trong suốt của lần nhấn phím (0: không theo dõi), đi cùng lệnh tới bước áp dụng nó.
+         *        Không nằm trong ảnh chụp hay stateHash nên không ảnh hưởng tính tất định.
          */
-        void queueDirectionChange(Direction newDirection);
+        void queueDirectionChange(Direction newDirection, std::uint64_t inputStamp = 0);
 
         /**
          *    Đánh dấu rằng rắn sẽ phát triển thêm một đốt trong lần di chuyển ('move') tiếp theo.
@@ -59,23 +84,24 @@ namespace SnakeGame {
          *    Giảm chiều dài của rắn đi một đốt bằng cách xóa đốt cuối cùng (đuôi).
          *        Thường được gọi khi sử dụng tính năng boost và hết chu kỳ cost.
          *        Không làm gì nếu rắn chỉ còn 1 đốt.
+         *    grid Lưới chiếm chỗ, bit của ô đuôi bị xóa.
          */
-        void shrink();
+        void shrink(OccupancyGrid& grid);
 
         /**
          *    Tính toán vị trí tiềm năng tiếp theo của đầu rắn dựa trên hướng di chuyển hiệu quả hiện tại.
          *        Hàm này sẽ gọi processAndApplyInputBuffer() để cập nhật hướng trước khi tính toán.
-         *    SDL_Point Vị trí (góc trên trái) dự kiến của đầu rắn trong bước di chuyển tiếp theo.
+         *    Point Ô dự kiến của đầu rắn trong bước di chuyển tiếp theo (chưa wrap, có thể nằm ngoài bàn chơi).
          *         Trả về {-1, -1} nếu rắn không có thân (trường hợp lỗi).
          */
-        [[nodiscard]] SDL_Point calculateNextHeadPosition();
+        [[nodiscard]] Point calculateNextHeadPosition();
 
         /**
          *    Kiểm tra xem đầu rắn (vị trí hiện tại) có va chạm với vị trí thức ăn không.
          *    foodPos Vị trí của thức ăn cần kiểm tra.
          *    true nếu đầu rắn ở cùng vị trí với thức ăn, false nếu không.
          */
-        [[nodiscard]] bool checkFoodCollision(const SDL_Point& foodPos) const;
+        [[nodiscard]] bool checkFoodCollision(const Point& foodPos) const;
 
         /**
          *    Kiểm tra xem đầu rắn (vị trí hiện tại) có va chạm với bất kỳ phần nào của thân nó không.
@@ -88,29 +114,25 @@ namespace SnakeGame {
          *    Kiểm tra xem vị trí đầu rắn *tiềm năng* tiếp theo có va chạm với thân rắn hiện tại không.
          *        Đây là hàm kiểm tra va chạm bản thân chính được sử dụng trong logic game trước khi di chuyển.
          *        Sẽ bỏ qua kiểm tra với đốt đuôi nếu rắn không đang phát triển ('growing' = false).
-         *    nextHead Vị trí đầu rắn tiềm năng trong bước di chuyển tới.
+         *        Tra cứu O(1) trên lưới chiếm chỗ thay vì quét toàn bộ thân.
+         *    nextHead Vị trí đầu rắn tiềm năng trong bước di chuyển tới (đã wrap, nằm trong bàn chơi).
+         *    grid Lưới chiếm chỗ của bàn chơi.
          *    true nếu vị trí tiềm năng va chạm với thân (trừ đuôi nếu không growing), false nếu không.
          */
-        [[nodiscard]] bool checkSelfCollisionWithNext(const SDL_Point& nextHead) const;
+        [[nodiscard]] bool checkSelfCollisionWithNext(const Point& nextHead, const OccupancyGrid& grid) const;
 
         /**
-         *    Lấy tham chiếu không đổi tới deque chứa các đốt của thân rắn.
-         *        Hữu ích cho việc kiểm tra va chạm hoặc lấy thông tin chiều dài.
-         *    const std::deque<SDL_Point>& Tham chiếu không đổi tới deque thân rắn.
+         *    Lấy tham chiếu không đổi tới bộ đệm vòng chứa các đốt của thân rắn.
+         *        Duyệt bằng range-for (trả về Point) hoặc cellAt() (chỉ số ô đã gói).
+         *    const SnakeBody& Tham chiếu không đổi tới thân rắn.
          */
-        [[nodiscard]] const std::deque<SDL_Point>& getBody() const;
+        [[nodiscard]] const SnakeBody& getBody() const;
 
         /**
          *    Lấy vị trí hiện tại của đầu rắn (đốt đầu tiên).
-         *    SDL_Point Vị trí đầu rắn, hoặc {-1, -1} nếu rắn không có thân.
-         */
-        [[nodiscard]] SDL_Point getHeadPosition() const;
-
-        /**
-         *    Lấy kích thước của mỗi ô (đốt rắn).
-         *    int Kích thước ô (thường là Config::CELL_SIZE).
+         *    Point Vị trí đầu rắn, hoặc {-1, -1} nếu rắn không có thân.
          */
-        [[nodiscard]] int getCellSize() const { return cellSize; }
+        [[nodiscard]] Point getHeadPosition() const;
 
         /**
          *    Lấy hướng di chuyển hiện tại của rắn (hướng đã được xác nhận và sử dụng trong bước di chuyển trước).
@@ -118,19 +140,58 @@ namespace SnakeGame {
          */
         [[nodiscard]] Direction getCurrentDirection() const;
 
+        /**
+         *    Rắn có đang phát triển không (đốt đuôi sẽ được giữ lại ở lần move() tiếp theo).
+         */
+        [[nodiscard]] bool isGrowing() const { return growing; }
+
+        /**
+         *    Nhãn thời gian của lệnh đổi hướng đã được áp dụng ở lần processAndApplyInputBuffer() gần nhất,
+         *        0 nếu bước đó không đổi hướng hoặc lệnh không được theo dõi (bot, replay).
+         */
+        [[nodiscard]] std::uint64_t getAppliedInputStamp() const { return appliedInputStamp; }
+
         /**
         *    Xử lý một lệnh trong bộ đệm đầu vào (nếu có) và cập nhật hướng di chuyển hiện tại ('currentDirection').
         *        Được gọi bên trong calculateNextHeadPosition().
         */
         void processAndApplyInputBuffer();
 
+        /**
+         *    Ghi trạng thái (thân, hướng, bộ đệm input, cờ growing) vào ảnh chụp.
+         *        Thân được chép nguyên khối (tối đa hai lần memcpy từ bộ đệm vòng).
+         */
+        void saveState(ByteWriter& writer) const;
+
+        /**
+         *    Kiểm tra dữ liệu do saveState ghi mà không nạp: hướng hợp lệ, cờ là 0/1,
+         *        chiều dài thân trong [1, cellCount] và mọi chỉ số ô trong [0, cellCount).
+         */
+        static bool checkState(ByteReader& reader, int cellCount);
+
+        /**
+         *    Khôi phục trạng thái do saveState ghi (không tự đánh dấu lên lưới).
+         *        Dữ liệu phải đã qua checkState với cùng cellCount.
+         */
+        void loadState(ByteReader& reader, int cellCount);
+
+        /**    Chép trạng thái của other vào rắn này, giữ bộ đệm đã cấp phát (dùng cho bản sao của bot tìm kiếm). */
+        void copyStateFrom(const Snake& other);
+
 
     private:
-        std::deque<SDL_Point> body;          // Deque lưu trữ vị trí các đốt rắn (đầu ở front)
+        SnakeBody body;                      // Bộ đệm vòng các đốt rắn (chỉ số ô đã gói, đầu ở vị trí 0)
         Direction currentDirection;          // Hướng di chuyển hiện tại đã xác nhận
         std::vector<Direction> inputBuffer; // Hàng đợi các lệnh đổi hướng từ người chơi
+        std::vector<std::uint64_t> inputStamps; // Nhãn thời gian song song với inputBuffer (đo độ trễ input)
+        std::uint64_t appliedInputStamp = 0;    // Nhãn của lệnh được áp dụng ở bước gần nhất
         bool growing = false;                // Cờ cho biết rắn có đang lớn lên không
-        int cellSize;                        // Kích thước của một đốt rắn
+        int gridWidth;                       // Số ô theo chiều ngang của bàn chơi
+
+        /**    Gói tọa độ ô thành chỉ số ô (y * gridWidth + x). */
+        [[nodiscard]] std::uint32_t packCell(const Point& pos) const {
+            return static_cast<std::uint32_t>(pos.y * gridWidth + pos.x);
+        }
 
         /**
          *    Kiểm tra xem hai hướng có đối nghịch nhau không (ví dụ: UP và DOWN).
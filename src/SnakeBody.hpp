@@ -0,0 +1,168 @@
+#ifndef SNAKE_BODY_HPP
+#define SNAKE_BODY_HPP
+
+#include "CoreConfig.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**
+     *    SnakeBody
+     *    Bộ đệm vòng chứa các đốt rắn dưới dạng chỉ số ô đã gói (uint32_t, y * gridWidth + x).
+     *        Dung lượng là lũy thừa của 2: bằng diện tích bàn chơi với bàn nhỏ (push_front/pop_back không bao giờ cấp phát),
+     *        và bắt đầu từ INITIAL_CAPACITY rồi nhân đôi khi đầy với bàn chơi lớn (tránh cấp phát hàng chục MB
+     *        cho một con rắn thực tế chỉ dài vài trăm đốt). Đầu rắn ở vị trí 0.
+     *        Duyệt thân qua iterator trả về Point (tọa độ ô) để tầng vẽ/va chạm dùng trực tiếp.
+     */
+    class SnakeBody {
+    public:
+        /**
+         *    Iterator chỉ đọc, trả về vị trí Point của từng đốt từ đầu tới đuôi.
+         */
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Point;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Point;
+
+            const_iterator() = default;
+            const_iterator(const SnakeBody* owner, std::size_t index) : owner(owner), index(index) {}
+
+            Point operator*() const { return (*owner)[index]; }
+            const_iterator& operator++() { ++index; return *this; }
+            const_iterator operator++(int) { const_iterator tmp = *this; ++index; return tmp; }
+            bool operator==(const const_iterator& other) const { return index == other.index; }
+            bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+        private:
+            const SnakeBody* owner = nullptr;
+            std::size_t index = 0;
+        };
+
+        static constexpr std::size_t INITIAL_CAPACITY = 4096;
+
+        SnakeBody() = default;
+
+        /**
+         *    Cấp phát bộ đệm cho một bàn chơi (gọi một lần khi tạo rắn, không gọi trong lúc chơi).
+         *    gridWidth Số ô theo chiều ngang (để giải nén chỉ số ô).
+         *    gridHeight Số ô theo chiều dọc.
+         */
+        void init(int gridWidth, int gridHeight) {
+            std::size_t capacity = 1;
+            const std::size_t area = static_cast<std::size_t>(gridWidth > 0 ? gridWidth : 1) * static_cast<std::size_t>(gridHeight > 0 ? gridHeight : 1);
+            const std::size_t target = area < INITIAL_CAPACITY ? area : INITIAL_CAPACITY;
+            while (capacity < target) capacity <<= 1;
+            cells.assign(capacity, 0);
+            mask = capacity - 1;
+            headSlot = 0;
+            length = 0;
+            width = gridWidth;
+        }
+
+        /**    Xóa toàn bộ đốt, giữ nguyên bộ đệm. */
+        void clear() {
+            headSlot = 0;
+            length = 0;
+        }
+
+        /**    Thêm một đốt mới vào đầu. */
+        void push_front(std::uint32_t cell) {
+            if (length == cells.size()) grow();
+            headSlot = (headSlot - 1) & mask;
+            cells[headSlot] = cell;
+            ++length;
+        }
+
+        /**    Thêm một đốt vào cuối (dùng khi dựng rắn ban đầu). */
+        void push_back(std::uint32_t cell) {
+            if (length == cells.size()) grow();
+            cells[(headSlot + length) & mask] = cell;
+            ++length;
+        }
+
+        /**    Bỏ đốt đuôi. */
+        void pop_back() { --length; }
+
+        /**    Chỉ số ô đã gói của đốt thứ i (0 = đầu). */
+        [[nodiscard]] std::uint32_t cellAt(std::size_t i) const { return cells[(headSlot + i) & mask]; }
+        [[nodiscard]] std::uint32_t frontCell() const { return cellAt(0); }
+        [[nodiscard]] std::uint32_t backCell() const { return cellAt(length - 1); }
+
+        /**    Giải nén chỉ số ô thành vị trí Point (tọa độ ô). */
+        [[nodiscard]] Point toPoint(std::uint32_t cell) const {
+            return {static_cast<int>(cell % width), static_cast<int>(cell / width)};
+        }
+
+        /**    Vị trí của đốt thứ i (0 = đầu). */
+        [[nodiscard]] Point operator[](std::size_t i) const { return toPoint(cellAt(i)); }
+        [[nodiscard]] Point front() const { return toPoint(frontCell()); }
+        [[nodiscard]] Point back() const { return toPoint(backCell()); }
+
+        /**
+         *    Gọi fn(data, count) cho các đoạn liên tục của thân từ đầu tới đuôi (tối đa hai đoạn do bộ đệm vòng),
+         *        để sao chép cả thân bằng memcpy.
+         */
+        template <typename Fn>
+        void forEachSpan(Fn&& fn) const {
+            const std::size_t firstCount = length < cells.size() - headSlot ? length : cells.size() - headSlot;
+            if (firstCount > 0) fn(cells.data() + headSlot, firstCount);
+            if (length > firstCount) fn(cells.data(), length - firstCount);
+        }
+
+        /**
+         *    Chuẩn bị bộ đệm cho count đốt liên tục (đầu ở vị trí 0), nhân đôi dung lượng nếu cần,
+         *        và trả về con trỏ để caller chép các đốt vào (dùng khi khôi phục ảnh chụp).
+         */
+        std::uint32_t* overwrite(std::size_t count) {
+            std::size_t capacity = cells.empty() ? 1 : cells.size();
+            while (capacity < count) capacity <<= 1;
+            if (capacity != cells.size()) cells.resize(capacity);
+            mask = capacity - 1;
+            headSlot = 0;
+            length = count;
+            return cells.data();
+        }
+
+        /**    Chép các đốt của other (chỉ phần thân đang dùng, không chép cả bộ đệm vòng). */
+        void copyFrom(const SnakeBody& other) {
+            std::uint32_t* out = overwrite(other.length);
+            other.forEachSpan([&](const std::uint32_t* data, std::size_t count) {
+                std::copy(data, data + count, out);
+                out += count;
+            });
+            width = other.width;
+        }
+
+        [[nodiscard]] std::size_t size() const { return length; }
+        [[nodiscard]] bool empty() const { return length == 0; }
+
+        [[nodiscard]] const_iterator begin() const { return {this, 0}; }
+        [[nodiscard]] const_iterator end() const { return {this, length}; }
+
+    private:
+        /**    Nhân đôi dung lượng, sắp xếp lại các đốt để đầu rắn về vị trí 0 của bộ đệm mới. */
+        void grow() {
+            std::vector<std::uint32_t> larger(cells.size() * 2);
+            for (std::size_t i = 0; i < length; ++i) larger[i] = cellAt(i);
+            cells.swap(larger);
+            mask = cells.size() - 1;
+            headSlot = 0;
+        }
+
+        std::vector<std::uint32_t> cells; // Bộ đệm vòng, dung lượng lũy thừa của 2
+        std::size_t mask = 0;             // capacity - 1
+        std::size_t headSlot = 0;         // Vị trí của đầu rắn trong bộ đệm
+        std::size_t length = 0;           // Số đốt hiện tại
+        int width = 0;                    // Số ô theo chiều ngang của bàn chơi
+    };
+
+}
+
+#endif
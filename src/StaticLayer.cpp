@@ -0,0 +1,109 @@
+#include "StaticLayer.hpp"
+#include "Config.hpp"
+#include <iostream>
+#include <vector>
+
+namespace SnakeGame {
+
+    void StaticLayer::refresh(const Renderer& renderer, SDL_Texture* background, const Simulation* sim, const Camera& camera, int cellSize, int width, int height) {
+        if (unsupported) return;
+        SDL_Renderer* sdlRenderer = renderer.getSDLRenderer(); // Cũng vẽ batch chữ đang chờ trước khi đổi render target
+        if (!sdlRenderer) return;
+
+        // Vùng nướng (theo ô): đủ phủ màn hình ở mọi độ lệch pixel, cộng lề mỗi phía
+        const int margin = Config::STATIC_LAYER_MARGIN_CELLS;
+        const int spanColumns = (width + cellSize - 1) / cellSize + 1 + 2 * margin;
+        const int spanRows = (height + cellSize - 1) / cellSize + 1 + 2 * margin;
+        const int bakeWidth = spanColumns * cellSize;
+        const int bakeHeight = spanRows * cellSize;
+        if (!texture || textureWidth != bakeWidth || textureHeight != bakeHeight) {
+            valid = false;
+            if (!SDL_RenderTargetSupported(sdlRenderer)) {
+                std::cerr << "Warning: Render targets are not supported; the play field background is drawn every frame." << std::endl;
+                unsupported = true;
+                return;
+            }
+            texture.reset(SDL_CreateTexture(sdlRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, bakeWidth, bakeHeight));
+            if (!texture) {
+                std::cerr << "Warning: Failed to create static layer texture! SDL_Error: " << SDL_GetError() << std::endl;
+                unsupported = true;
+                return;
+            }
+            SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_NONE); // Lớp đục phủ toàn màn hình: chép thẳng, không pha trộn
+            textureWidth = bakeWidth;
+            textureHeight = bakeHeight;
+        }
+
+        Key key;
+        key.background = background;
+        key.layoutRevision = sim ? sim->getObstacleLayoutRevision() : 0;
+        key.mode = sim ? sim->getMode() : GameMode::Classic;
+        key.columns = camera.columns;
+        key.rows = camera.rows;
+        key.cellSize = cellSize;
+        key.width = width;
+        key.height = height;
+        // Khung nhìn (kể cả độ lệch pixel) còn nằm trọn trong vùng đã nướng thì chỉ cần dịch vùng chép
+        const bool covered = camera.originX >= bakedOriginX && camera.originY >= bakedOriginY
+                          && (camera.originX - bakedOriginX) * cellSize + camera.offsetX + width <= textureWidth
+                          && (camera.originY - bakedOriginY) * cellSize + camera.offsetY + height <= textureHeight;
+        if (valid && key == bakedKey && covered) return;
+
+        if (SDL_SetRenderTarget(sdlRenderer, texture.get()) != 0) {
+            std::cerr << "Warning: Could not bake the static layer! SDL_Error: " << SDL_GetError() << std::endl;
+            valid = false;
+            return;
+        }
+        bakedOriginX = camera.originX - margin;
+        bakedOriginY = camera.originY - margin;
+        renderer.clear();
+        drawBackground(renderer, background, bakedOriginX * cellSize, bakedOriginY * cellSize, width, height, textureWidth, textureHeight);
+        if (sim) {
+            // Quét vật cản trong vùng nướng từ lưới chiếm chỗ, bỏ qua các ô đang có vật cản động chưa nướng
+            const ObstacleField& obstacles = sim->getObstacles();
+            const auto spanIndex = [&](Point cell) {
+                return static_cast<std::size_t>(cell.y - bakedOriginY) * static_cast<std::size_t>(spanColumns) + static_cast<std::size_t>(cell.x - bakedOriginX);
+            };
+            std::vector<std::uint8_t> unbaked;
+            for (const std::uint32_t i : obstacles.getMovingIndices()) {
+                const Point pos = obstacles.positionAt(i);
+                if (isBaked(*sim, i) || pos.x < bakedOriginX || pos.y < bakedOriginY || pos.x >= bakedOriginX + spanColumns || pos.y >= bakedOriginY + spanRows) continue;
+                if (unbaked.empty()) unbaked.assign(static_cast<std::size_t>(spanColumns) * static_cast<std::size_t>(spanRows), 0);
+                unbaked[spanIndex(pos)] = 1;
+            }
+            std::vector<SDL_Rect> obsRects;
+            sim->getGrid().forEachInRect(CellTag::Obstacle, bakedOriginX, bakedOriginY, bakedOriginX + spanColumns, bakedOriginY + spanRows,
+                [&](int x, int y) {
+                    if (!unbaked.empty() && unbaked[spanIndex({x, y})]) return;
+                    obsRects.push_back({(x - bakedOriginX) * cellSize, (y - bakedOriginY) * cellSize, cellSize, cellSize});
+                });
+            if (!obsRects.empty()) renderer.drawRects(obsRects, Config::OBSTACLE_COLOR, true);
+        }
+        SDL_SetRenderTarget(sdlRenderer, nullptr);
+
+        bakedKey = key;
+        valid = true;
+        ++bakeCount;
+    }
+
+    void StaticLayer::draw(const Renderer& renderer, const Camera& camera) const {
+        if (!isReady()) return;
+        SDL_Rect srcRect = {(camera.originX - bakedOriginX) * bakedKey.cellSize + camera.offsetX,
+                            (camera.originY - bakedOriginY) * bakedKey.cellSize + camera.offsetY, bakedKey.width, bakedKey.height};
+        SDL_Rect destRect = {0, 0, bakedKey.width, bakedKey.height};
+        renderer.drawTexturePortion(texture.get(), &srcRect, &destRect);
+    }
+
+    void StaticLayer::drawBackground(const Renderer& renderer, SDL_Texture* background, int boardX, int boardY, int width, int height, int areaWidth, int areaHeight) {
+        if (!background || width <= 0 || height <= 0) return;
+        const int startX = -(((boardX % width) + width) % width);
+        const int startY = -(((boardY % height) + height) % height);
+        for (int y = startY; y < areaHeight; y += height) {
+            for (int x = startX; x < areaWidth; x += width) {
+                SDL_Rect destRect = {x, y, width, height};
+                renderer.drawTexture(background, &destRect);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,86 @@
+#ifndef STATIC_LAYER_HPP
+#define STATIC_LAYER_HPP
+
+#include "Renderer.hpp"
+#include "Simulation.hpp"
+#include "Camera.hpp"
+#include <SDL.h>
+#include <cstdint>
+#include <memory>
+
+namespace SnakeGame {
+
+    /**
+     *    StaticLayer
+     *    Lớp nền đã nướng sẵn của bàn chơi: ảnh nền (lát theo tọa độ bàn chơi) và mọi vật cản đứng yên quanh khung nhìn,
+     *        vẽ một lần vào một render-target texture. Mỗi frame chỉ cần chép phần ứng với khung nhìn rồi vẽ các thực thể động.
+     *        Lớp được nướng theo ô nguyên, rộng hơn khung nhìn Config::STATIC_LAYER_MARGIN_CELLS ô mỗi phía, nên camera
+     *        cuộn từng pixel chỉ dịch vùng chép; nướng lại khi khung nhìn ra khỏi vùng đã nướng (chỉ xảy ra trên bàn chơi lớn),
+     *        khi bố cục vật cản đổi (Simulation::getObstacleLayoutRevision: reset, addSingleObstacle, nạp ảnh chụp),
+     *        hoặc khi đổi chế độ/mô phỏng đang xem.
+     *        Vật cản "đứng yên" là vật cản tĩnh, cộng mọi vật cản ở chế độ Classic (Classic không cho vật cản di chuyển).
+     *        Nếu renderer không hỗ trợ render target, isReady() trả về false và caller vẽ trực tiếp như trước.
+     */
+    class StaticLayer {
+    public:
+        StaticLayer() = default;
+
+        /**
+         *    Nướng lại lớp nếu đầu vào đã đổi kể từ lần nướng trước.
+         *    background Ảnh nền (có thể nullptr: chỉ tô màu nền).
+         *    sim Mô phỏng có vật cản cần nướng, hoặc nullptr (Arena: chỉ có ảnh nền).
+         *    camera Khung nhìn hiện tại; cellSize Kích thước một ô (pixel); width/height Kích thước màn hình.
+         */
+        void refresh(const Renderer& renderer, SDL_Texture* background, const Simulation* sim, const Camera& camera, int cellSize, int width, int height);
+
+        /**    Vẽ phần lớp đã nướng ứng với khung nhìn (kể cả độ lệch pixel) phủ toàn màn hình. */
+        void draw(const Renderer& renderer, const Camera& camera) const;
+
+        /**
+         *    Lát ảnh nền (mỗi tấm width x height pixel) lên vùng areaWidth x areaHeight, với góc trên trái vùng ứng với
+         *        pixel (boardX, boardY) của bàn chơi: nền cuộn cùng bàn chơi. Dùng cả khi nướng lẫn khi vẽ trực tiếp.
+         */
+        static void drawBackground(const Renderer& renderer, SDL_Texture* background, int boardX, int boardY, int width, int height, int areaWidth, int areaHeight);
+
+        /**    Buộc lần refresh tiếp theo nướng lại (ví dụ nội dung render target bị mất khi thiết bị đồ họa reset). */
+        void invalidate() { valid = false; }
+
+        /**    true nếu lớp đã được nướng và có thể dùng thay cho vẽ trực tiếp. */
+        [[nodiscard]] bool isReady() const { return texture && valid; }
+
+        /**    true nếu vật cản thứ i của sim đã nằm trong lớp nướng (không cần vẽ lại mỗi frame). */
+        [[nodiscard]] static bool isBaked(const Simulation& sim, std::size_t i) {
+            return sim.getMode() != GameMode::PortalWalls || !sim.getObstacles().isMoving(i);
+        }
+
+        /**    Số lần đã nướng (để đo). */
+        [[nodiscard]] std::uint64_t getBakeCount() const { return bakeCount; }
+
+    private:
+        struct Key {
+            SDL_Texture* background = nullptr;
+            std::uint64_t layoutRevision = 0;  // 0: không có vật cản (Arena)
+            GameMode mode = GameMode::Classic;
+            int columns = 0;
+            int rows = 0;
+            int cellSize = 0;
+            int width = 0;
+            int height = 0;
+
+            bool operator==(const Key& other) const = default;
+        };
+
+        std::unique_ptr<SDL_Texture, SDLTextureDestroyer> texture;
+        int textureWidth = 0;
+        int textureHeight = 0;
+        Key bakedKey;
+        int bakedOriginX = 0;             // Ô (trên bàn chơi, có thể âm) ứng với góc trên trái texture
+        int bakedOriginY = 0;
+        bool valid = false;
+        bool unsupported = false;         // Renderer không hỗ trợ render target: không thử lại mỗi frame
+        std::uint64_t bakeCount = 0;
+    };
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "Tournament.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace SnakeGame {
+
+    namespace {
+        /**    Kết quả của một ván, ghi theo chỉ số (bot, chế độ, seed). */
+        struct GameRecord {
+            std::uint64_t ticks = 0;
+            int score = 0;
+            CollisionCause cause = CollisionCause::None;
+            bool timedOut = false;
+        };
+    }
+
+    TournamentReport Tournament::run(JobSystem& jobs) const {
+        TournamentReport report;
+        report.threads = jobs.getThreadCount();
+        const std::size_t seedCount = static_cast<std::size_t>(std::max(0, config.seedCount));
+        const std::size_t modeCount = config.modes.size();
+        const std::size_t cellCount = agents.size() * modeCount;
+        const std::size_t perJob = static_cast<std::size_t>(Config::TOURNAMENT_GAMES_PER_JOB);
+        const std::size_t chunksPerCell = (seedCount + perJob - 1) / perJob;
+        if (cellCount == 0 || seedCount == 0) return report;
+
+        std::vector<GameRecord> records(cellCount * seedCount);
+        std::vector<double> chunkSeconds(cellCount * chunksPerCell, 0.0);
+
+        auto start = std::chrono::steady_clock::now();
+        jobs.parallelFor(cellCount * chunksPerCell, [&](std::size_t job) {
+            const std::size_t cell = job / chunksPerCell;
+            const std::size_t chunk = job % chunksPerCell;
+            const TournamentAgent& agent = agents[cell / modeCount];
+            const GameMode mode = config.modes[cell % modeCount];
+
+            auto chunkStart = std::chrono::steady_clock::now();
+            const std::size_t first = chunk * perJob;
+            const std::size_t last = std::min(seedCount, (chunk + 1) * perJob);
+            Simulation sim(config.boardWidth, config.boardHeight, config.firstSeed + static_cast<std::uint32_t>(first), mode, config.obstacleCount);
+            for (std::size_t game = first; game < last; ++game) {
+                if (game > first) sim.reset(config.firstSeed + static_cast<std::uint32_t>(game), mode); // Ván đầu đã được constructor bắt đầu
+                AgentPolicy policy = agent.create();
+                StepResult result;
+                while (!sim.isGameOver() && sim.getTick() < config.maxTicks) {
+                    StepInput input;
+                    input.direction = policy(sim);
+                    result = sim.step(input);
+                }
+                GameRecord& record = records[cell * seedCount + game];
+                record.ticks = sim.getTick();
+                record.score = sim.getScore();
+                record.cause = result.cause;
+                record.timedOut = !sim.isGameOver();
+            }
+            chunkSeconds[job] = std::chrono::duration<double>(std::chrono::steady_clock::now() - chunkStart).count();
+        });
+        report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<double> scores;
+        std::vector<double> ticks;
+        std::vector<double> rates;
+        for (std::size_t cell = 0; cell < cellCount; ++cell) {
+            TournamentResult result;
+            result.agent = agents[cell / modeCount].name;
+            result.mode = config.modes[cell % modeCount];
+            result.games = static_cast<int>(seedCount);
+            scores.clear();
+            ticks.clear();
+            for (std::size_t game = 0; game < seedCount; ++game) {
+                const GameRecord& record = records[cell * seedCount + game];
+                scores.push_back(record.score);
+                ticks.push_back(static_cast<double>(record.ticks));
+                result.totalTicks += record.ticks;
+                if (record.timedOut) ++result.timeouts;
+                else ++result.deaths[static_cast<std::size_t>(record.cause)];
+            }
+            rates.clear();
+            for (std::size_t chunk = 0; chunk < chunksPerCell; ++chunk) {
+                const double seconds = chunkSeconds[cell * chunksPerCell + chunk];
+                const std::size_t games = std::min(seedCount, (chunk + 1) * perJob) - chunk * perJob;
+                result.cpuSeconds += seconds;
+                if (seconds > 0.0) rates.push_back(static_cast<double>(games) / seconds);
+            }
+            result.score = SampleStats::of(scores);
+            result.survivalTicks = SampleStats::of(ticks);
+            result.gamesPerSecond = SampleStats::of(rates);
+            report.totalGames += result.games;
+            report.totalTicks += result.totalTicks;
+            report.results.push_back(std::move(result));
+        }
+        return report;
+    }
+
+}
@@ -0,0 +1,102 @@
+#ifndef TOURNAMENT_HPP
+#define TOURNAMENT_HPP
+
+#include "Simulation.hpp"
+#include "JobSystem.hpp"
+#include "CoreConfig.hpp"
+#include "SampleStats.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SnakeGame {
+
+    /**    Chính sách của một bot: chọn hướng cho bước tiếp theo của sim (gọi một lần trước mỗi step()). */
+    using AgentPolicy = std::function<Direction(const Simulation&)>;
+
+    /**
+     *    TournamentAgent
+     *    Một bot được đăng ký vào Tournament. create() được gọi cho mỗi ván,
+     *        nên bot có trạng thái (đường đi, cây tìm kiếm) không cần tự reset và không bị chia sẻ giữa các luồng.
+     */
+    struct TournamentAgent {
+        std::string name;
+        std::function<AgentPolicy()> create;
+    };
+
+    /**
+     *    TournamentConfig
+     *    Bàn chơi, các chế độ và dải seed chung cho mọi bot. Mỗi cặp (bot, chế độ) chơi đúng cùng các seed
+     *        firstSeed .. firstSeed + seedCount - 1, nên chênh lệch giữa hai lần chạy chỉ đến từ bot hoặc luật chơi.
+     */
+    struct TournamentConfig {
+        int boardWidth = Config::BOARD_WIDTH;
+        int boardHeight = Config::BOARD_HEIGHT;
+        int obstacleCount = Config::OBSTACLE_COUNT;
+        std::vector<GameMode> modes = {GameMode::Classic, GameMode::PortalWalls};
+        std::uint32_t firstSeed = 1;
+        int seedCount = 1000;
+        std::uint64_t maxTicks = 100000;  // Cắt ván (tính là hết giờ) khi đạt số bước này
+    };
+
+    /**
+     *    TournamentResult
+     *    Kết quả của một bot trên một chế độ chơi.
+     */
+    struct TournamentResult {
+        std::string agent;
+        GameMode mode = GameMode::Classic;
+        int games = 0;
+        int timeouts = 0;                    // Số ván bị cắt ở maxTicks (rắn còn sống)
+        std::array<int, 8> deaths = {};      // Số ván kết thúc theo từng CollisionCause (chỉ số = giá trị enum)
+        SampleStats score;
+        SampleStats survivalTicks;           // Số bước của mỗi ván
+        SampleStats gamesPerSecond;          // Thông lượng trên một luồng, đo theo từng khối TOURNAMENT_GAMES_PER_JOB ván
+        double cpuSeconds = 0.0;             // Tổng thời gian luồng đã dùng cho các ván này
+        std::uint64_t totalTicks = 0;
+    };
+
+    /**
+     *    TournamentReport
+     *    Kết quả của cả giải, theo thứ tự (bot đăng ký, chế độ trong config), cùng thông lượng tổng.
+     */
+    struct TournamentReport {
+        std::vector<TournamentResult> results;
+        double wallSeconds = 0.0;
+        unsigned threads = 1;
+        int totalGames = 0;
+        std::uint64_t totalTicks = 0;
+    };
+
+    /**
+     *    Tournament
+     *    Cho mọi bot đã đăng ký chơi mọi seed trên mọi chế độ, song song trên JobSystem.
+     *        Các ván được chia thành khối TOURNAMENT_GAMES_PER_JOB seed liên tiếp; mọi khối của mọi (bot, chế độ)
+     *        nằm chung một parallelFor để các bot chậm (tìm kiếm) không làm các nhân khác ngồi chờ.
+     *        Kết quả mỗi ván được ghi theo chỉ số rồi mới gộp, nên thống kê điểm/số bước không phụ thuộc số luồng.
+     *        Dùng để so sánh bot với nhau, hoặc so sánh hai bản build khi đổi hằng số luật chơi trong CoreConfig.
+     */
+    class Tournament {
+    public:
+        explicit Tournament(const TournamentConfig& config) : config(config) {}
+
+        /**    Đăng ký một bot; thứ tự đăng ký là thứ tự trong báo cáo. */
+        void addAgent(TournamentAgent agent) { agents.push_back(std::move(agent)); }
+
+        /**    Chạy cả giải trên jobs và trả về báo cáo. */
+        [[nodiscard]] TournamentReport run(JobSystem& jobs) const;
+
+        [[nodiscard]] const TournamentConfig& getConfig() const { return config; }
+        [[nodiscard]] const std::vector<TournamentAgent>& getAgents() const { return agents; }
+
+    private:
+        TournamentConfig config;
+        std::vector<TournamentAgent> agents;
+    };
+
+}
+
+#endif
@@ -4,6 +4,9 @@
 #include <SDL_mixer.h>
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
 #include "Config.hpp"
 #include "Renderer.hpp"
 #include "Game.hpp"
@@ -40,26 +43,58 @@ int main(int argc, char* argv[]) {
 
     Renderer renderer(window, Config::FONT_PATH, Config::FONT_SIZE);
     Game game(Config::SCREEN_WIDTH, Config::SCREEN_HEIGHT, Config::CELL_SIZE, renderer);
+    // --seed N: cố định seed của phiên để tái tạo các ván (replay vẫn được lưu cho mọi ván)
+    // --replay FILE: mở thẳng trình xem replay
+    // --capture FILE: ghi hình ra FILE (.y4m) hoặc thư mục PNG; kèm --replay thì dựng video của replay rồi thoát
+    //     (chạy được không cần màn hình với SDL_VIDEODRIVER=dummy SDL_AUDIODRIVER=dummy)
+    std::string capturePath;
+    for (int i = 1; i + 1 < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seed") {
+            game.setSessionSeed(static_cast<std::uint32_t>(std::strtoul(argv[i + 1], nullptr, 10)));
+        } else if (arg == "--replay" && !game.openReplay(argv[i + 1])) {
+            std::cerr << "Warning: Could not open replay " << argv[i + 1] << ", starting normally." << std::endl;
+        } else if (arg == "--capture") {
+            capturePath = argv[i + 1];
+        }
+    }
+    const bool renderReplayToVideo = !capturePath.empty() && game.getCurrentState() == GameState::ReplayViewer;
+    if (!capturePath.empty() && !game.startCapture(capturePath, renderReplayToVideo)) {
+        std::cerr << "Warning: Could not start capture to " << capturePath << "." << std::endl;
+        if (renderReplayToVideo) return 1;
+    }
 
     bool running = true;
     SDL_Event event;
     Uint64 lastTick = SDL_GetPerformanceCounter();
 
     while (running) {
-        while (SDL_PollEvent(&event)) {
+        // Không mô phỏng (menu, tạm dừng, game over): ngủ trong SDL_WaitEventTimeout tới sự kiện hoặc hạn kế tiếp của game
+        const int waitMs = game.idleWaitMs();
+        bool hasEvent = waitMs > 0 ? SDL_WaitEventTimeout(&event, waitMs) != 0 : SDL_PollEvent(&event) != 0;
+        while (hasEvent) {
             if (event.type == SDL_QUIT) running = false;
-            game.handleInput(event);
+            // Nhãn thời gian lúc phím được lấy khỏi hàng đợi, đi cùng lệnh đổi hướng tới present đầu tiên hiển thị nó
+            game.handleInput(event, event.type == SDL_KEYDOWN ? SDL_GetPerformanceCounter() : 0);
             if (game.didQuit()) running = false;
+            hasEvent = SDL_PollEvent(&event) != 0;
         }
 
         Uint64 now = SDL_GetPerformanceCounter();
         float dt = (float)(now - lastTick) / SDL_GetPerformanceFrequency();
         lastTick = now;
+        if (renderReplayToVideo) dt = 1.0f / Config::CAPTURE_FPS; // Video đều nhịp, không phụ thuộc tốc độ máy
 
         game.runFrame(std::min(dt, 0.1f));
-        game.render(renderer);
+        if (!game.render(renderer) && waitMs == 0) {
+            // Frame không đổi nên không present (không còn VSync điều nhịp): ngủ thay vì quay vòng
+            SDL_Delay(Config::IDLE_FRAME_DELAY_MS);
+        }
+        if (renderReplayToVideo && game.isReplayAtEnd()) running = false;
     }
 
+    game.stopCapture(); // Ghi nốt các frame đang chờ trong khi SDL_image còn được khởi tạo
+
     // Cleanup
     SDL_DestroyWindow(window);
     Mix_CloseAudio();